@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+class Stopwatch {
+protected:
+
+    std::chrono::steady_clock::time_point start;
+
+public:
+
+    Stopwatch() :
+        start(std::chrono::steady_clock::now())
+    {}
+
+    void restart() {
+        start = std::chrono::steady_clock::now();
+    }
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+inline size_t readSizeArgument(int argc, char** argv, int index, size_t default_value) {
+    if (index < argc) {
+        return static_cast<size_t>(std::strtoull(argv[index], nullptr, 10));
+    }
+    return default_value;
+}
+
+inline std::vector<int> makeUniqueKeys(size_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 1 << 30);
+
+    std::vector<int> keys;
+    std::unordered_set<int> was;
+    keys.reserve(count);
+    was.reserve(count);
+
+    while (keys.size() < count) {
+        int key = dist(gen);
+        if (was.insert(key).second) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+inline void printThroughput(const char* name, size_t operations, double seconds, uint64_t checksum) {
+    std::printf("%-40s %10.2f Mops/s  (%.3f s, checksum %llu)\n",
+                name, operations / seconds / 1e6, seconds, static_cast<unsigned long long>(checksum));
+}
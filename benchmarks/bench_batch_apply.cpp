@@ -0,0 +1,85 @@
+// Sorted update batches: applyBatch against a loop of single insert/erase calls.
+//
+// Usage: bench_batch_apply [elements] [batch size] [batches]
+
+#include <algorithm>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using Operation = BatchOperation<int, int>;
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<std::vector<Operation>>& batches) {
+    size_t count_of_operations = batches.size() * batches.front().size();
+    {
+        TreeType tree;
+        for (int key : keys) {
+            tree.insert(key, key);
+        }
+        Stopwatch stopwatch;
+        for (const auto& batch : batches) {
+            for (const Operation& operation : batch) {
+                if (operation.type == Operation::Type::ERASE) {
+                    if (tree.isExist(operation.key)) {
+                        tree.erase(operation.key);
+                    }
+                }
+                else {
+                    auto it = tree.find(operation.key);
+                    if (it == tree.end()) {
+                        tree.insert(operation.key, operation.value);
+                    }
+                    else {
+                        (*it).second = operation.value;
+                    }
+                }
+            }
+        }
+        printThroughput((std::string(name) + " per-op loop").c_str(), count_of_operations, stopwatch.seconds(), tree.size());
+    }
+    {
+        TreeType tree;
+        for (int key : keys) {
+            tree.insert(key, key);
+        }
+        Stopwatch stopwatch;
+        for (const auto& batch : batches) {
+            tree.applyBatch(batch);
+        }
+        printThroughput((std::string(name) + " applyBatch").c_str(), count_of_operations, stopwatch.seconds(), tree.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t batch_size = std::max<size_t>(readSizeArgument(argc, argv, 2, 10'000), 1U);
+    size_t count_of_batches = std::max<size_t>(readSizeArgument(argc, argv, 3, 20), 1U);
+
+    std::vector<int> all_keys = makeUniqueKeys(elements * 2, 1);
+    std::vector<int> keys(all_keys.begin(), all_keys.begin() + elements);
+
+    // Half upserts and half erases over present and absent keys, so the size stays about the same.
+    std::mt19937 gen(2);
+    std::vector<std::vector<Operation>> batches(count_of_batches, std::vector<Operation>(batch_size));
+    for (auto& batch : batches) {
+        for (Operation& operation : batch) {
+            operation.type = gen() % 2 == 0 ? Operation::Type::ERASE : Operation::Type::UPSERT;
+            operation.key = all_keys[gen() % all_keys.size()];
+            operation.value = static_cast<int>(gen());
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const Operation& lhs, const Operation& rhs) {
+            return lhs.key < rhs.key;
+        });
+    }
+
+    std::printf("elements: %zu, batch size: %zu, batches: %zu\n", elements, batch_size, count_of_batches);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys, batches);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, batches);
+
+    return 0;
+}
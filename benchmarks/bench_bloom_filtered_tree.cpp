@@ -0,0 +1,52 @@
+// Miss-heavy lookups: most queried keys are absent from the tree.
+//
+// Usage: bench_bloom_filtered_tree [elements] [lookups] [miss percent]
+
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "BloomFilteredTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.isExist(key);
+    }
+    printThroughput((std::string(name) + " isExist").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 2'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+    size_t miss_percent = readSizeArgument(argc, argv, 3, 80);
+
+    // The first half of the keys is inserted, the second half is only ever queried.
+    std::vector<int> all_keys = makeUniqueKeys(elements * 2, 1);
+    std::vector<int> keys(all_keys.begin(), all_keys.begin() + elements);
+
+    std::mt19937 gen(2);
+    std::vector<int> queries(lookups);
+    for (int& key : queries) {
+        bool is_miss = gen() % 100 < miss_percent;
+        key = all_keys[gen() % elements + (is_miss ? elements : 0)];
+    }
+
+    std::printf("elements: %zu, lookups: %zu, misses: %zu%%\n", elements, lookups, miss_percent);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    runTree<BloomFilteredTree<int, int, AVLTree<int, int>>>("BloomFilteredTree<AVLTree>", keys, queries);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+    runTree<BloomFilteredTree<int, int>>("BloomFilteredTree<RedBlackTree>", keys, queries);
+
+    return 0;
+}
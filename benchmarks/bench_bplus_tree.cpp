@@ -0,0 +1,60 @@
+// BPlusTree against the binary trees: random inserts, random lookups and a full ordered scan.
+//
+// Usage: bench_bplus_tree [elements] [lookups]
+
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "BPlusTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+
+    Stopwatch stopwatch;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+    printThroughput((std::string(name) + " insert").c_str(), keys.size(), stopwatch.seconds(), tree.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.find(key)->second;
+    }
+    printThroughput((std::string(name) + " find").c_str(), queries.size(), stopwatch.seconds(), checksum);
+
+    stopwatch.restart();
+    checksum = 0;
+    for (auto [key, value] : tree) {
+        checksum += value;
+    }
+    printThroughput((std::string(name) + " scan").c_str(), tree.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 2'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 5'000'000);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<size_t> pick(0, elements - 1);
+    std::vector<int> queries(lookups);
+    for (int& key : queries) {
+        key = keys[pick(gen)];
+    }
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+    runTree<BPlusTree<int, int, 16>>("BPlusTree<16>", keys, queries);
+    runTree<BPlusTree<int, int, 32>>("BPlusTree<32>", keys, queries);
+    runTree<BPlusTree<int, int, 64>>("BPlusTree<64>", keys, queries);
+
+    return 0;
+}
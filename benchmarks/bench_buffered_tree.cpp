@@ -0,0 +1,47 @@
+// Random-insert bursts with and without the log-structured write buffer.
+//
+// Usage: bench_buffered_tree [elements]
+
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "BufferedTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, TreeType& tree, const std::vector<int>& keys) {
+    Stopwatch stopwatch;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+    double seconds = stopwatch.seconds();
+    printThroughput(name, keys.size(), seconds, tree.size());
+}
+
+template <typename TTree>
+void runAll(const char* name, const std::vector<int>& keys) {
+    {
+        TTree tree;
+        runTree((std::string(name) + " insert").c_str(), tree, keys);
+    }
+    for (size_t capacity : { 256, 1024, 4096, 16384 }) {
+        BufferedTree<int, int, TTree> tree(capacity);
+        std::string label = std::string(name) + " insert, buffer " + std::to_string(capacity);
+        runTree(label.c_str(), tree, keys);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 2'000'000);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu\n", elements);
+
+    runAll<AVLTree<int, int>>("AVLTree", keys);
+    runAll<RedBlackTree<int, int>>("RedBlackTree", keys);
+
+    return 0;
+}
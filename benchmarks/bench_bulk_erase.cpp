@@ -0,0 +1,71 @@
+// Purging a share of the elements by predicate: eraseIf against a loop of erase(Iterator).
+//
+// Usage: bench_bulk_erase [elements]
+
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+// Picks elements by their value, which is a random number below 100.
+struct ExpiryPredicate {
+    int percent;
+
+    bool operator()(const int&, const int& value) const {
+        return value < percent;
+    }
+};
+
+template <typename TreeType>
+void fill(TreeType& tree, const std::vector<int>& keys) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], static_cast<int>((keys[i] * 2654435761U) >> 7) % 100);
+    }
+}
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys) {
+    for (int percent : { 1, 5, 10, 20, 30, 50, 70, 90 }) {
+        ExpiryPredicate predicate{ percent };
+        double loop_seconds = 0.0;
+        double erase_if_seconds = 0.0;
+        size_t count = 0;
+        {
+            TreeType tree;
+            fill(tree, keys);
+            Stopwatch stopwatch;
+            for (auto it = tree.begin(); it != tree.end();) {
+                if (predicate((*it).first, (*it).second)) {
+                    it = tree.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+            loop_seconds = stopwatch.seconds();
+        }
+        {
+            TreeType tree;
+            fill(tree, keys);
+            Stopwatch stopwatch;
+            count = tree.eraseIf(predicate);
+            erase_if_seconds = stopwatch.seconds();
+        }
+        std::printf("%-14s %3d%% erased: erase loop %.3f s, eraseIf %.3f s  (%.2fx, %zu erased)\n",
+                    name, percent, loop_seconds, erase_if_seconds, loop_seconds / erase_if_seconds, count);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu\n", elements);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Read scaling under a steady writer: N reader threads look up random keys while one
+// writer keeps inserting and erasing. The lock-based baselines wrap RedBlackTree
+// in a std::mutex and in a std::shared_mutex.
+//
+// Usage: bench_concurrent_red_black_tree [elements] [max readers] [milliseconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+#include "RedBlackTree.hpp"
+#include "ConcurrentRedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+class MutexTree {
+protected:
+
+    RedBlackTree<int, int> tree;
+    mutable std::mutex mutex;
+
+public:
+
+    std::optional<int> find(int key) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tree.find(key);
+        if (it == tree.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void insert(int key, int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.insert(key, value);
+    }
+
+    void erase(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tree.isExist(key)) {
+            tree.erase(key);
+        }
+    }
+};
+
+class SharedMutexTree {
+protected:
+
+    RedBlackTree<int, int> tree;
+    mutable std::shared_mutex mutex;
+
+public:
+
+    std::optional<int> find(int key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = tree.find(key);
+        if (it == tree.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void insert(int key, int value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        tree.insert(key, value);
+    }
+
+    void erase(int key) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (tree.isExist(key)) {
+            tree.erase(key);
+        }
+    }
+};
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, size_t readers, size_t milliseconds) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    std::atomic<bool> is_done = false;
+    std::atomic<uint64_t> lookups = 0;
+    std::atomic<uint64_t> checksum = 0;
+
+    std::vector<std::thread> threads;
+    for (size_t reader = 0; reader < readers; ++reader) {
+        threads.emplace_back([&, reader]() {
+            std::mt19937 gen(static_cast<uint32_t>(reader + 1));
+            uint64_t local_lookups = 0;
+            uint64_t local_checksum = 0;
+            while (!is_done.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 64; ++i) {
+                    auto value = tree.find(keys[gen() % keys.size()]);
+                    local_checksum += value.has_value() ? static_cast<uint64_t>(*value) : 0U;
+                }
+                local_lookups += 64;
+            }
+            lookups += local_lookups;
+            checksum += local_checksum;
+        });
+    }
+
+    // The writer toggles a fresh key range so the tree size stays roughly constant.
+    threads.emplace_back([&]() {
+        int next_key = -1;
+        while (!is_done.load(std::memory_order_relaxed)) {
+            tree.insert(next_key, next_key);
+            tree.erase(next_key);
+            --next_key;
+        }
+    });
+
+    Stopwatch stopwatch;
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    is_done.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::string label = std::string(name) + " x" + std::to_string(readers);
+    printThroughput(label.c_str(), lookups.load(), stopwatch.seconds(), checksum.load());
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t max_readers = readSizeArgument(argc, argv, 2, std::max(1U, std::thread::hardware_concurrency() - 1U));
+    size_t milliseconds = readSizeArgument(argc, argv, 3, 1000);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu, readers: 1 .. %zu, one writer\n", elements, max_readers);
+
+    for (size_t readers = 1; readers <= max_readers; readers *= 2) {
+        runTree<MutexTree>("std::mutex", keys, readers, milliseconds);
+        runTree<SharedMutexTree>("std::shared_mutex", keys, readers, milliseconds);
+        runTree<ConcurrentRedBlackTree<int, int>>("ConcurrentRedBlackTree", keys, readers, milliseconds);
+    }
+
+    return 0;
+}
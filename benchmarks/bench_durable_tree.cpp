@@ -0,0 +1,71 @@
+// Cost of durability: random inserts into a plain tree versus DurableTree with
+// several group commit sizes, plus the time to recover the tree from its files.
+//
+// Usage: bench_durable_tree [elements] [path prefix]
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "DurableTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+void removeFiles(const std::string& path) {
+    std::filesystem::remove(path + ".wal");
+    std::filesystem::remove(path + ".checkpoint");
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    std::string path = argc > 2 ? argv[2] : (std::filesystem::temp_directory_path() / "bench_durable").string();
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu, files: %s.*\n", elements, path.c_str());
+
+    {
+        Stopwatch stopwatch;
+        AVLTree<int, int> tree;
+        for (int key : keys) {
+            tree.insert(key, key);
+        }
+        printThroughput("AVLTree insert (in memory)", elements, stopwatch.seconds(), tree.size());
+    }
+
+    for (size_t group_size : { 64, 1024, 16384 }) {
+        removeFiles(path);
+        DurableTree<int, int>::Options options;
+        options.group_size = group_size;
+
+        Stopwatch stopwatch;
+        {
+            DurableTree<int, int> tree(path, options);
+            for (int key : keys) {
+                tree.insert(key, key);
+            }
+            tree.sync();
+        }
+        std::string name = "DurableTree insert, fsync every " + std::to_string(group_size);
+        printThroughput(name.c_str(), elements, stopwatch.seconds(), 0);
+    }
+
+    Stopwatch stopwatch;
+    {
+        DurableTree<int, int> tree(path);
+        printThroughput("recovery from log", elements, stopwatch.seconds(), tree.size());
+
+        stopwatch.restart();
+        tree.checkpoint();
+        std::printf("%-40s %10.3f s\n", "checkpoint", stopwatch.seconds());
+    }
+    stopwatch.restart();
+    {
+        DurableTree<int, int> tree(path);
+        printThroughput("recovery from checkpoint", elements, stopwatch.seconds(), tree.size());
+    }
+
+    removeFiles(path);
+    return 0;
+}
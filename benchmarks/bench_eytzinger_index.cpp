@@ -0,0 +1,72 @@
+// Lookup throughput of RedBlackTree::find against the frozen tree and the Eytzinger index.
+//
+// Usage: bench_eytzinger_index [elements] [lookups]
+// Build with -mavx2 (/arch:AVX2) to enable the vectorized batch path.
+
+#include <iterator>
+
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 10'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<size_t> pick(0, elements - 1);
+    std::vector<int> queries(lookups);
+    for (int& key : queries) {
+        key = keys[pick(gen)];
+    }
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+
+    RedBlackTree<int, int> tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.find(key)->second;
+    }
+    double tree_seconds = stopwatch.seconds();
+    printThroughput("RedBlackTree find", lookups, tree_seconds, checksum);
+
+    auto frozen = tree.freeze();
+    stopwatch.restart();
+    checksum = 0;
+    for (int key : queries) {
+        checksum += frozen.find(key)->second;
+    }
+    printThroughput("FrozenTree find", lookups, stopwatch.seconds(), checksum);
+
+    auto index = tree.toEytzinger();
+    stopwatch.restart();
+    checksum = 0;
+    for (int key : queries) {
+        checksum += index.find(key)->second;
+    }
+    double index_seconds = stopwatch.seconds();
+    printThroughput("EytzingerIndex find", lookups, index_seconds, checksum);
+
+    std::vector<decltype(index.end())> result;
+    result.reserve(lookups);
+    stopwatch.restart();
+    index.lowerBound(queries.data(), queries.data() + queries.size(), std::back_inserter(result));
+    checksum = 0;
+    for (auto it : result) {
+        checksum += it->second;
+    }
+    double batch_seconds = stopwatch.seconds();
+    printThroughput("EytzingerIndex batch lowerBound", lookups, batch_seconds, checksum);
+
+    std::printf("speedup over RedBlackTree::find: %.2fx single, %.2fx batch\n",
+                tree_seconds / index_seconds, tree_seconds / batch_seconds);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+// File-backed node pool: builds a tree whose nodes live in a memory-mapped file and
+// measures inserts and random lookups, next to the same tree kept in RAM.
+//
+// To see paging, run it under a memory limit well below the pool size, e.g.
+//     systemd-run --user --scope -p MemoryMax=1G ./bench_file_backed_tree 50000000 10000000 /data/pool.bin 0 1000000
+// An AVLTree<int, int> node takes 40 bytes and there are two nodes (one fictitious)
+// per element, so 50M elements are a 4 GB pool: 4x the limit above. The pages changed
+// since the last flush stay in memory, so the inserts flush every `flush interval` elements.
+//
+// Usage: bench_file_backed_tree [elements] [lookups] [pool path] [run in-memory tree: 0/1] [flush interval]
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+#include "AVLTree.hpp"
+#include "MappedVector.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, TreeType& tree, const std::vector<int>& keys, const std::vector<int>& queries,
+             size_t flush_interval = 0) {
+    Stopwatch stopwatch;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], keys[i]);
+        if constexpr (std::is_same_v<TreeType, AVLTree<int, int, MappedVector>>) {
+            if (flush_interval != 0U && (i + 1U) % flush_interval == 0U) {
+                tree.flush();
+            }
+        }
+    }
+    printThroughput((std::string(name) + " insert").c_str(), keys.size(), stopwatch.seconds(), tree.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.find(key)->second;
+    }
+    printThroughput((std::string(name) + " find").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 5'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 5'000'000);
+    std::string path = argc > 3 ? argv[3] : (std::filesystem::temp_directory_path() / "bench_file_backed.bin").string();
+    bool run_in_memory = readSizeArgument(argc, argv, 4, 1) != 0U;
+    size_t flush_interval = readSizeArgument(argc, argv, 5, 0);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+    std::vector<int> queries(lookups);
+    std::mt19937 gen(2);
+    for (int& key : queries) {
+        key = keys[gen() % keys.size()];
+    }
+
+    std::printf("elements: %zu, lookups: %zu, pool file: %s\n", elements, lookups, path.c_str());
+
+    if (run_in_memory) {
+        AVLTree<int, int> tree;
+        runTree("AVLTree (RAM)", tree, keys, queries);
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".free");
+    std::filesystem::remove(path + ".journal");
+    {
+        AVLTree<int, int, MappedVector> tree(path);
+        runTree("AVLTree (file-backed)", tree, keys, queries, flush_interval);
+
+        Stopwatch stopwatch;
+        tree.flush();
+        std::printf("%-40s %10.3f s\n", "flush", stopwatch.seconds());
+    }
+
+    Stopwatch stopwatch;
+    AVLTree<int, int, MappedVector> reopened(path);
+    std::printf("%-40s %10.3f s (%zu elements)\n", "reopen", stopwatch.seconds(), reopened.size());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".free");
+    std::filesystem::remove(path + ".journal");
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Lookups of keys close to the previous one: finger search from the last result against
+// search from the root.
+//
+// Usage: bench_finger_search [elements] [lookups] [max step]
+
+#include <algorithm>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        auto it = tree.lowerBound(key);
+        checksum += it == tree.end() ? 0 : (*it).second;
+    }
+    printThroughput((std::string(name) + " lowerBound").c_str(), queries.size(), stopwatch.seconds(), checksum);
+
+    stopwatch.restart();
+    checksum = 0;
+    auto finger = tree.begin();
+    for (int key : queries) {
+        auto it = tree.lowerBound(finger, key);
+        if (it != tree.end()) {
+            checksum += (*it).second;
+            finger = it;
+        }
+    }
+    printThroughput((std::string(name) + " finger lowerBound").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 2'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+    size_t max_step = std::max<size_t>(readSizeArgument(argc, argv, 3, 16), 1U);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+    std::vector<int> sorted_keys = keys;
+    std::sort(sorted_keys.begin(), sorted_keys.end());
+
+    // A sorted stream that walks forward a few ranks at a time and wraps around.
+    std::mt19937 gen(2);
+    std::vector<int> queries(lookups);
+    size_t rank = 0;
+    for (int& key : queries) {
+        rank = (rank + gen() % max_step) % elements;
+        key = sorted_keys[rank];
+    }
+
+    std::printf("elements: %zu, lookups: %zu, max step: %zu\n", elements, lookups, max_step);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Heavy write contention: 1 .. N threads hammer one tree with inserts, erases and finds.
+// FlatCombiningTree is compared with a RedBlackTree behind a std::mutex.
+//
+// Usage: bench_flat_combining_tree [elements] [operations per thread] [max threads]
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "RedBlackTree.hpp"
+#include "FlatCombiningTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+class MutexTree {
+protected:
+
+    RedBlackTree<int, int> tree;
+    std::mutex mutex;
+
+public:
+
+    bool insert(int key, int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t size_before = tree.size();
+        tree.insert(key, value);
+        return tree.size() != size_before;
+    }
+
+    bool erase(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tree.find(key);
+        if (it == tree.end()) {
+            return false;
+        }
+        tree.erase(it);
+        return true;
+    }
+
+    std::optional<int> find(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tree.find(key);
+        if (it == tree.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+};
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, size_t operations, size_t threads) {
+    TreeType tree;
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        tree.insert(keys[i], keys[i]);
+    }
+
+    std::atomic<uint64_t> checksum = 0;
+
+    Stopwatch stopwatch;
+    std::vector<std::thread> workers;
+    for (size_t thread = 0; thread < threads; ++thread) {
+        workers.emplace_back([&, thread]() {
+            std::mt19937 gen(static_cast<uint32_t>(thread + 1));
+            uint64_t local_checksum = 0;
+            for (size_t i = 0; i < operations; ++i) {
+                int key = keys[gen() % keys.size()];
+                switch (i % 3) {
+                case 0:
+                    local_checksum += tree.insert(key, key);
+                    break;
+                case 1:
+                    local_checksum += tree.erase(key);
+                    break;
+                default:
+                    local_checksum += tree.find(key).has_value();
+                }
+            }
+            checksum += local_checksum;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::string label = std::string(name) + " x" + std::to_string(threads);
+    printThroughput(label.c_str(), operations * threads, stopwatch.seconds(), checksum.load());
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 100'000);
+    size_t operations = readSizeArgument(argc, argv, 2, 500'000);
+    size_t max_threads = readSizeArgument(argc, argv, 3, 32);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu, operations per thread: %zu, threads: 1 .. %zu\n", elements, operations, max_threads);
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        runTree<MutexTree>("std::mutex RedBlackTree", keys, operations, threads);
+        runTree<FlatCombiningTree<int, int>>("FlatCombiningTree", keys, operations, threads);
+    }
+
+    return 0;
+}
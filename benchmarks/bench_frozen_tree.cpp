@@ -0,0 +1,75 @@
+// Lookup throughput of AVLTree / RedBlackTree against their frozen van Emde Boas snapshots.
+//
+// Usage: bench_frozen_tree [elements] [lookups] [avl|rb|all]
+// Pick sizes whose footprint exceeds the last-level cache, and run a single structure under
+// `perf stat -e cache-references,cache-misses` to compare miss rates.
+
+#include <algorithm>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runLookups(const char* name, TreeType& tree, const std::vector<int>& queries) {
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.find(key)->second;
+    }
+    printThroughput((std::string(name) + " find").c_str(), queries.size(), stopwatch.seconds(), checksum);
+
+    stopwatch.restart();
+    checksum = 0;
+    for (int key : queries) {
+        auto it = tree.lowerBound(key - 1);
+        if (it != tree.end()) {
+            checksum += it->second;
+        }
+    }
+    printThroughput((std::string(name) + " lowerBound").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    runLookups(name, tree, queries);
+
+    Stopwatch stopwatch;
+    auto frozen = tree.freeze();
+    std::printf("%-40s %10.3f s\n", (std::string(name) + " freeze").c_str(), stopwatch.seconds());
+
+    runLookups((std::string(name) + " frozen").c_str(), frozen, queries);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 4'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+    std::string mode = argc > 3 ? argv[3] : "all";
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<size_t> pick(0, elements - 1);
+    std::vector<int> queries(lookups);
+    for (int& key : queries) {
+        key = keys[pick(gen)];
+    }
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+
+    if (mode == "avl" || mode == "all") {
+        runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    }
+    if (mode == "rb" || mode == "all") {
+        runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+    }
+
+    return 0;
+}
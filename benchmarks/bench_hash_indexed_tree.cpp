@@ -0,0 +1,68 @@
+// Point-lookup latency of a tree with a hash index, compared to the plain trees and std::unordered_map.
+//
+// Usage: bench_hash_indexed_tree [elements] [lookups]
+
+#include <string>
+#include <unordered_map>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "HashIndexedTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+void printLatency(const char* name, size_t operations, double seconds, uint64_t checksum) {
+    std::printf("%-40s %10.1f ns/op  (%.3f s, checksum %llu)\n",
+                name, seconds / operations * 1e9, seconds, static_cast<unsigned long long>(checksum));
+}
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += (*tree.find(key)).second;
+    }
+    printLatency((std::string(name) + " find").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+void runUnorderedMap(const std::vector<int>& keys, const std::vector<int>& queries) {
+    std::unordered_map<int, int> map;
+    for (int key : keys) {
+        map.insert({ key, key });
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += map.find(key)->second;
+    }
+    printLatency("std::unordered_map find", queries.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 2'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+    std::mt19937 gen(2);
+    std::vector<int> queries(lookups);
+    for (int& key : queries) {
+        key = keys[gen() % elements];
+    }
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+
+    runUnorderedMap(keys, queries);
+    runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    runTree<HashIndexedTree<int, int, AVLTree<int, int>>>("HashIndexedTree<AVLTree>", keys, queries);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+    runTree<HashIndexedTree<int, int>>("HashIndexedTree<RedBlackTree>", keys, queries);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Matching timestamps against validity intervals: IntervalTree against a linear scan.
+// Also shows what keeping the subtree maximum costs on insert and erase, against a plain
+// RedBlackTree with the same keys.
+//
+// Usage: bench_interval_tree [intervals] [queries]
+
+#include <random>
+
+#include "IntervalTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+int main(int argc, char** argv) {
+    size_t count = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t query_count = readSizeArgument(argc, argv, 2, 1'000'000);
+
+    // Timestamps up to 2^30; an interval lasts up to 2^12, so a point is covered by about 4 intervals.
+    std::mt19937 gen(48);
+    std::vector<Interval<int>> intervals(count);
+    for (auto& interval : intervals) {
+        interval.low = static_cast<int>(gen() % (1U << 30));
+        interval.high = interval.low + static_cast<int>(gen() % (1U << 12));
+    }
+    std::vector<int> queries(query_count);
+    for (int& query : queries) {
+        query = static_cast<int>(gen() % (1U << 30));
+    }
+
+    std::printf("intervals: %zu, queries: %zu\n", count, query_count);
+
+    {
+        RedBlackTree<Interval<int>, int> tree;
+        Stopwatch stopwatch;
+        for (size_t i = 0; i < intervals.size(); ++i) {
+            tree.insert(intervals[i], static_cast<int>(i));
+        }
+        printThroughput("RedBlackTree insert", intervals.size(), stopwatch.seconds(), tree.size());
+        stopwatch.restart();
+        for (size_t i = 0; i < intervals.size(); i += 2) {
+            tree.erase(intervals[i]);
+        }
+        printThroughput("RedBlackTree erase", (intervals.size() + 1) / 2, stopwatch.seconds(), tree.size());
+    }
+
+    IntervalTree<int, int> tree;
+    Stopwatch stopwatch;
+    for (size_t i = 0; i < intervals.size(); ++i) {
+        tree.insert(intervals[i], static_cast<int>(i));
+    }
+    printThroughput("IntervalTree insert", intervals.size(), stopwatch.seconds(), tree.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int query : queries) {
+        tree.forEachOverlapping(query, [&checksum](const Interval<int>&, const int& value) {
+            checksum += value;
+        });
+    }
+    printThroughput("IntervalTree forEachOverlapping", queries.size(), stopwatch.seconds(), checksum);
+
+    stopwatch.restart();
+    checksum = 0;
+    for (int query : queries) {
+        checksum += tree.overlapping(query).size();
+    }
+    printThroughput("IntervalTree overlapping", queries.size(), stopwatch.seconds(), checksum);
+
+    // A full scan per query; only a few queries so that it finishes.
+    size_t scan_count = std::min<size_t>(queries.size(), 200);
+    stopwatch.restart();
+    checksum = 0;
+    for (size_t q = 0; q < scan_count; ++q) {
+        for (size_t i = 0; i < intervals.size(); ++i) {
+            if (intervals[i].low <= queries[q] && queries[q] <= intervals[i].high) {
+                checksum += i;
+            }
+        }
+    }
+    printThroughput("linear scan", scan_count, stopwatch.seconds(), checksum);
+
+    stopwatch.restart();
+    for (size_t i = 0; i < intervals.size(); i += 2) {
+        tree.erase(intervals[i]);
+    }
+    printThroughput("IntervalTree erase", (intervals.size() + 1) / 2, stopwatch.seconds(), tree.size());
+
+    return 0;
+}
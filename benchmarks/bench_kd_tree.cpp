@@ -0,0 +1,136 @@
+// Spatial queries on 2D points: KdTree against the one-dimensional workaround, a RedBlackTree
+// ordered by x (then y) that walks the x range of a query and filters by y.
+//
+// Usage: bench_kd_tree [points] [queries]
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <random>
+
+#include "KdTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using Point = std::array<int, 2>;
+
+const int SIDE = 1 << 20;
+
+long long getSquaredDistance(const Point& lhs, const Point& rhs) {
+    long long dx = lhs[0] - rhs[0];
+    long long dy = lhs[1] - rhs[1];
+    return dx * dx + dy * dy;
+}
+
+template <typename TCallback>
+void forEachInRange(RedBlackTree<Point, int>& tree, const Point& low, const Point& high, TCallback callback) {
+    for (auto it = tree.lowerBound({ low[0], INT_MIN }); it != tree.end() && (*it).first[0] <= high[0]; ++it) {
+        int y = (*it).first[1];
+        if (low[1] <= y && y <= high[1]) {
+            callback((*it).first, (*it).second);
+        }
+    }
+}
+
+// Grows a square around the point until the k nearest points are certainly inside the circle it contains.
+std::vector<Point> findNearest(RedBlackTree<Point, int>& tree, const Point& center, size_t k) {
+    std::vector<std::pair<long long, Point>> found;
+    for (long long radius = 256;; radius *= 2) {
+        found.clear();
+        Point low{ static_cast<int>(center[0] - radius), static_cast<int>(center[1] - radius) };
+        Point high{ static_cast<int>(center[0] + radius), static_cast<int>(center[1] + radius) };
+        forEachInRange(tree, low, high, [&](const Point& point, int) {
+            found.emplace_back(getSquaredDistance(point, center), point);
+        });
+        std::sort(found.begin(), found.end());
+        if ((found.size() >= k && found[k - 1].first <= radius * radius) || radius > 2 * SIDE) {
+            break;
+        }
+    }
+    std::vector<Point> result;
+    for (size_t i = 0; i < std::min(k, found.size()); ++i) {
+        result.push_back(found[i].second);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t count = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t query_count = readSizeArgument(argc, argv, 2, 2000);
+    // A box of this side holds about 25 points on average.
+    int box_side = static_cast<int>(5.0 * SIDE / std::sqrt(static_cast<double>(count)));
+    const size_t k = 10;
+
+    std::mt19937 gen(49);
+    std::vector<std::pair<Point, int>> elements(count);
+    for (size_t i = 0; i < count; ++i) {
+        elements[i] = { Point{ static_cast<int>(gen() % SIDE), static_cast<int>(gen() % SIDE) }, static_cast<int>(i) };
+    }
+    std::vector<Point> queries(query_count);
+    for (Point& query : queries) {
+        query = { static_cast<int>(gen() % SIDE), static_cast<int>(gen() % SIDE) };
+    }
+
+    std::printf("points: %zu, queries: %zu, box side: %d, k: %zu\n", count, query_count, box_side, k);
+
+    Stopwatch stopwatch;
+    RedBlackTree<Point, int> line;
+    for (const auto& [point, value] : elements) {
+        line.insert(point, value);
+    }
+    printThroughput("RedBlackTree by x insert", count, stopwatch.seconds(), line.size());
+
+    stopwatch.restart();
+    KdTree<int, 2, int> incremental;
+    for (const auto& [point, value] : elements) {
+        incremental.insert(point, value);
+    }
+    printThroughput("KdTree insert", count, stopwatch.seconds(), incremental.size());
+
+    stopwatch.restart();
+    KdTree<int, 2, int> tree(elements);
+    printThroughput("KdTree bulk build", count, stopwatch.seconds(), tree.size());
+
+    uint64_t checksum = 0;
+    auto addToChecksum = [&checksum](const Point&, const int& value) {
+        checksum += value;
+    };
+
+    stopwatch.restart();
+    for (const Point& query : queries) {
+        forEachInRange(line, query, { query[0] + box_side, query[1] + box_side }, addToChecksum);
+    }
+    printThroughput("RedBlackTree by x range", query_count, stopwatch.seconds(), checksum);
+
+    checksum = 0;
+    stopwatch.restart();
+    for (const Point& query : queries) {
+        incremental.forEachInRange(query, { query[0] + box_side, query[1] + box_side }, addToChecksum);
+    }
+    printThroughput("KdTree range (inserted)", query_count, stopwatch.seconds(), checksum);
+
+    checksum = 0;
+    stopwatch.restart();
+    for (const Point& query : queries) {
+        tree.forEachInRange(query, { query[0] + box_side, query[1] + box_side }, addToChecksum);
+    }
+    printThroughput("KdTree range (bulk built)", query_count, stopwatch.seconds(), checksum);
+
+    checksum = 0;
+    stopwatch.restart();
+    for (const Point& query : queries) {
+        checksum += findNearest(line, query, k).back()[0];
+    }
+    printThroughput("RedBlackTree by x nearest", query_count, stopwatch.seconds(), checksum);
+
+    checksum = 0;
+    stopwatch.restart();
+    for (const Point& query : queries) {
+        checksum += tree.nearest(query, k).back().first[0];
+    }
+    printThroughput("KdTree nearest", query_count, stopwatch.seconds(), checksum);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Event log with several events per timestamp: a multimap tree against std::multimap
+// and a tree of std::vector values.
+//
+// Usage: bench_multi_tree [events] [events per key]
+
+#include <map>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "MultiTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runMultiTree(const char* name, const std::vector<int>& keys) {
+    Stopwatch stopwatch;
+    TreeType tree;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], static_cast<int>(i));
+    }
+    printThroughput((std::string(name) + " insert").c_str(), keys.size(), stopwatch.seconds(), tree.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : keys) {
+        auto [first, last] = tree.equalRange(key);
+        checksum += (*first).second;
+    }
+    printThroughput((std::string(name) + " equalRange").c_str(), keys.size(), stopwatch.seconds(), checksum);
+}
+
+void runMultimap(const std::vector<int>& keys) {
+    Stopwatch stopwatch;
+    std::multimap<int, int> map;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map.insert({ keys[i], static_cast<int>(i) });
+    }
+    printThroughput("std::multimap insert", keys.size(), stopwatch.seconds(), map.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : keys) {
+        auto [first, last] = map.equal_range(key);
+        checksum += first->second;
+    }
+    printThroughput("std::multimap equal_range", keys.size(), stopwatch.seconds(), checksum);
+}
+
+void runVectorValues(const std::vector<int>& keys) {
+    Stopwatch stopwatch;
+    RedBlackTree<int, std::vector<int>> tree;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto it = tree.find(keys[i]);
+        if (it == tree.end()) {
+            it = tree.insert(keys[i], std::vector<int>());
+        }
+        (*it).second.push_back(static_cast<int>(i));
+    }
+    printThroughput("RedBlackTree<std::vector> insert", keys.size(), stopwatch.seconds(), tree.size());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : keys) {
+        checksum += (*tree.find(key)).second.front();
+    }
+    printThroughput("RedBlackTree<std::vector> find", keys.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t events = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t events_per_key = std::max<size_t>(readSizeArgument(argc, argv, 2, 8), 1U);
+
+    std::vector<int> unique_keys = makeUniqueKeys(events / events_per_key + 1, 1);
+    std::mt19937 gen(2);
+    std::vector<int> keys(events);
+    for (int& key : keys) {
+        key = unique_keys[gen() % unique_keys.size()];
+    }
+
+    std::printf("events: %zu, events per key: %zu\n", events, events_per_key);
+
+    runMultimap(keys);
+    runVectorValues(keys);
+    runMultiTree<MultiTree<int, int, AVLTree<int, int>>>("MultiTree<AVLTree>", keys);
+    runMultiTree<MultiTree<int, int>>("MultiTree<RedBlackTree>", keys);
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Moving entries with large payloads from an "active" to an "expired" tree: copying the
+// element out and erasing it, against extract and insert of a node handle.
+//
+// Usage: bench_node_handle [elements] [payload bytes]
+
+#include <map>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::string& payload) {
+    TreeType active;
+    TreeType expired;
+    for (int key : keys) {
+        active.insert(key, payload);
+    }
+
+    Stopwatch stopwatch;
+    for (int key : keys) {
+        std::string value = active[key];
+        active.erase(key);
+        expired.insert(key, value);
+    }
+    printThroughput((std::string(name) + " copy and erase").c_str(), keys.size(), stopwatch.seconds(), expired.size());
+
+    stopwatch.restart();
+    for (int key : keys) {
+        active.insert(expired.extract(key));
+    }
+    printThroughput((std::string(name) + " extract").c_str(), keys.size(), stopwatch.seconds(), active.size());
+}
+
+void runStdMap(const std::vector<int>& keys, const std::string& payload) {
+    std::map<int, std::string> active;
+    std::map<int, std::string> expired;
+    for (int key : keys) {
+        active.insert({ key, payload });
+    }
+
+    Stopwatch stopwatch;
+    for (int key : keys) {
+        expired.insert(active.extract(key));
+    }
+    printThroughput("std::map extract", keys.size(), stopwatch.seconds(), expired.size());
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 500'000);
+    size_t payload_bytes = readSizeArgument(argc, argv, 2, 256);
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+    std::string payload(payload_bytes, 'x');
+
+    std::printf("elements: %zu, payload: %zu bytes\n", elements, payload_bytes);
+
+    runStdMap(keys, payload);
+    runTree<AVLTree<int, std::string>>("AVLTree", keys, payload);
+    runTree<RedBlackTree<int, std::string>>("RedBlackTree", keys, payload);
+
+    return 0;
+}
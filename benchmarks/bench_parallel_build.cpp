@@ -0,0 +1,51 @@
+// Building a tree from unsorted elements: one insert per element against buildParallel on 1 to N threads.
+//
+// Usage: bench_parallel_build [elements] [max threads, default one per core]
+
+#include <algorithm>
+#include <thread>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<std::pair<int, int>>& elements, size_t max_threads) {
+    {
+        Stopwatch stopwatch;
+        TreeType tree;
+        for (const auto& [key, value] : elements) {
+            tree.insert(key, value);
+        }
+        std::printf("%-14s insert loop        %.3f s  (%zu elements)\n", name, stopwatch.seconds(), tree.size());
+    }
+    for (size_t count_of_threads = 1; count_of_threads <= max_threads; ++count_of_threads) {
+        // The copy of the input is part of what buildParallel takes, so it is made outside the timing.
+        std::vector<std::pair<int, int>> input = elements;
+        TreeType tree;
+        Stopwatch stopwatch;
+        tree.buildParallel(std::move(input), count_of_threads);
+        std::printf("%-14s buildParallel, %2zu threads %.3f s  (%zu elements)\n",
+                    name, count_of_threads, stopwatch.seconds(), tree.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = readSizeArgument(argc, argv, 1, 2'000'000);
+    size_t max_threads = readSizeArgument(argc, argv, 2, std::max(std::thread::hardware_concurrency(), 1U));
+
+    std::vector<int> keys = makeUniqueKeys(count, 50);
+    std::vector<std::pair<int, int>> elements;
+    elements.reserve(count);
+    for (int key : keys) {
+        elements.emplace_back(key, key);
+    }
+
+    std::printf("elements: %zu, cores: %u\n", count, std::thread::hardware_concurrency());
+
+    runTree<AVLTree<int, int>>("AVLTree", elements, max_threads);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", elements, max_threads);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Lookups with long string keys: std::string against PrefixedString, which decides most
+// comparisons by an inline 8-byte prefix.
+//
+// Usage: bench_prefixed_string [elements] [lookups]
+
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "PrefixedString.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+std::string makeUuid(std::mt19937_64& gen) {
+    const char digits[] = "0123456789abcdef";
+    std::string result;
+    for (int i = 0; i < 32; ++i) {
+        if (i == 8 || i == 12 || i == 16 || i == 20) {
+            result.push_back('-');
+        }
+        result.push_back(digits[gen() % 16]);
+    }
+    return result;
+}
+
+// A few hosts and a deep path, so keys share long stems.
+std::string makeUrl(std::mt19937_64& gen) {
+    const char* hosts[] = { "https://example.com", "https://api.example.com", "https://cdn.example.org" };
+    return std::string(hosts[gen() % 3]) + "/users/" + std::to_string(gen() % 1000000) +
+           "/items/" + std::to_string(gen() % 1000000);
+}
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<std::string>& keys, const std::vector<std::string>& queries) {
+    using TKey = std::remove_cv_t<std::remove_reference_t<decltype((*std::declval<TreeType&>().begin()).first)>>;
+
+    TreeType tree;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(TKey(keys[i]), static_cast<int>(i));
+    }
+    std::vector<TKey> converted_queries(queries.begin(), queries.end());
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (const TKey& key : converted_queries) {
+        checksum += tree[key];
+    }
+    printThroughput(name, queries.size(), stopwatch.seconds(), checksum);
+}
+
+template <typename MakeKey>
+void runKeys(const char* key_name, size_t elements, size_t lookups, MakeKey make_key) {
+    std::mt19937_64 gen(5);
+    std::vector<std::string> keys(elements);
+    for (std::string& key : keys) {
+        key = make_key(gen);
+    }
+    std::vector<std::string> queries(lookups);
+    for (std::string& key : queries) {
+        key = keys[gen() % elements];
+    }
+
+    std::printf("%s keys:\n", key_name);
+    runTree<AVLTree<std::string, int>>("  AVLTree<std::string>", keys, queries);
+    runTree<AVLTree<PrefixedString, int>>("  AVLTree<PrefixedString>", keys, queries);
+    runTree<RedBlackTree<std::string, int>>("  RedBlackTree<std::string>", keys, queries);
+    runTree<RedBlackTree<PrefixedString, int>>("  RedBlackTree<PrefixedString>", keys, queries);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 2'000'000);
+
+    std::printf("elements: %zu, lookups: %zu\n", elements, lookups);
+
+    runKeys("UUID", elements, lookups, makeUuid);
+    runKeys("URL", elements, lookups, makeUrl);
+
+    return 0;
+}
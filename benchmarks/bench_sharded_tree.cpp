@@ -0,0 +1,94 @@
+// Write scaling: 1 .. N threads insert and erase random keys concurrently.
+// ShardedTree is compared with a single RedBlackTree behind a std::mutex.
+//
+// Usage: bench_sharded_tree [operations per thread] [max threads] [max shard size]
+
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "RedBlackTree.hpp"
+#include "ShardedTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+class MutexTree {
+protected:
+
+    RedBlackTree<int, int> tree;
+    std::mutex mutex;
+
+public:
+
+    explicit MutexTree(size_t) {}
+
+    void insert(int key, int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tree.insert(key, value);
+    }
+
+    void erase(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tree.isExist(key)) {
+            tree.erase(key);
+        }
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.size();
+    }
+};
+
+template <typename TreeType>
+void runTree(const char* name, size_t operations, size_t threads, size_t max_shard_size) {
+    TreeType tree(max_shard_size);
+
+    // Warms the tree up so that the sharded variant starts with a realistic layout.
+    std::vector<int> initial = makeUniqueKeys(operations, 1);
+    for (int key : initial) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    std::vector<std::thread> writers;
+    for (size_t thread = 0; thread < threads; ++thread) {
+        writers.emplace_back([&, thread]() {
+            std::mt19937 gen(static_cast<uint32_t>(thread + 2));
+            std::uniform_int_distribution<int> dist(0, 1 << 30);
+            for (size_t i = 0; i < operations; ++i) {
+                int key = dist(gen);
+                if (i % 2 == 0) {
+                    tree.insert(key, key);
+                }
+                else {
+                    tree.erase(key);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::string label = std::string(name) + " x" + std::to_string(threads);
+    printThroughput(label.c_str(), operations * threads, stopwatch.seconds(), tree.size());
+}
+
+int main(int argc, char** argv) {
+    size_t operations = readSizeArgument(argc, argv, 1, 500'000);
+    size_t max_threads = readSizeArgument(argc, argv, 2, 32);
+    size_t max_shard_size = readSizeArgument(argc, argv, 3, 1U << 14);
+
+    std::printf("operations per thread: %zu, threads: 1 .. %zu, max shard size: %zu\n",
+                operations, max_threads, max_shard_size);
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        runTree<MutexTree>("std::mutex RedBlackTree", operations, threads, max_shard_size);
+        runTree<ShardedTree<int, int>>("ShardedTree<AVLTree>", operations, threads, max_shard_size);
+        runTree<ShardedTree<int, int, RedBlackTree<int, int>>>("ShardedTree<RedBlackTree>", operations, threads,
+                                                               max_shard_size);
+    }
+
+    return 0;
+}
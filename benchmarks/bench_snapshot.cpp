@@ -0,0 +1,51 @@
+// Restart cost: rebuilding a tree with inserts versus mapping a saved snapshot.
+//
+// Usage: bench_snapshot [elements] [lookups] [snapshot path]
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 10'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+    std::string path = argc > 3 ? argv[3] : (std::filesystem::temp_directory_path() / "bench_snapshot.bin").string();
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+    std::vector<int> queries = makeUniqueKeys(lookups, 2);
+
+    std::printf("elements: %zu, lookups: %zu, file: %s\n", elements, lookups, path.c_str());
+
+    Stopwatch stopwatch;
+    RedBlackTree<int, int> tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+    std::printf("%-40s %10.3f s\n", "rebuild with insert", stopwatch.seconds());
+
+    stopwatch.restart();
+    tree.saveSnapshot(path);
+    std::printf("%-40s %10.3f s\n", "saveSnapshot", stopwatch.seconds());
+
+    stopwatch.restart();
+    auto verified = FrozenTree<int, int>::loadSnapshot(path);
+    std::printf("%-40s %10.3f s\n", "loadSnapshot (checksum verified)", stopwatch.seconds());
+
+    stopwatch.restart();
+    auto loaded = FrozenTree<int, int>::loadSnapshot(path, false);
+    std::printf("%-40s %10.3f s\n", "loadSnapshot (no verification)", stopwatch.seconds());
+
+    stopwatch.restart();
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += loaded.isExist(key);
+    }
+    printThroughput("mapped snapshot lookups", lookups, stopwatch.seconds(), checksum);
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Skewed lookups: keys are requested with Zipfian popularity and a short-term reuse window,
+// which is where a splay tree beats the strictly balanced trees.
+//
+// Usage: bench_splay_tree [elements] [lookups] [zipf exponent x100]
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "BPlusTree.hpp"
+#include "SplayTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+// Draws ranks 0 .. n - 1 with probability proportional to 1 / (rank + 1)^exponent.
+std::vector<size_t> makeZipfRanks(size_t n, size_t count, double exponent, uint32_t seed) {
+    std::vector<double> cdf(n);
+    double sum = 0.0;
+    for (size_t rank = 0; rank < n; ++rank) {
+        sum += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+        cdf[rank] = sum;
+    }
+
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, sum);
+    std::vector<size_t> ranks(count);
+    for (size_t& rank : ranks) {
+        rank = std::lower_bound(cdf.begin(), cdf.end(), dist(gen)) - cdf.begin();
+        rank = std::min(rank, n - 1);
+    }
+    return ranks;
+}
+
+template <typename TreeType>
+void runTree(const char* name, const std::vector<int>& keys, const std::vector<int>& queries) {
+    TreeType tree;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (int key : queries) {
+        checksum += tree.find(key)->second;
+    }
+    printThroughput((std::string(name) + " find").c_str(), queries.size(), stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    size_t lookups = readSizeArgument(argc, argv, 2, 10'000'000);
+    double exponent = readSizeArgument(argc, argv, 3, 99) / 100.0;
+
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    // Popularity is unrelated to the key order.
+    std::vector<int> by_popularity = keys;
+    std::mt19937 gen(4);
+    std::shuffle(by_popularity.begin(), by_popularity.end(), gen);
+
+    std::vector<size_t> ranks = makeZipfRanks(elements, lookups, exponent, 5);
+    std::vector<int> queries(lookups);
+    for (size_t i = 0; i < lookups; ++i) {
+        // Every fourth request repeats one of the last few keys.
+        if (i >= 8 && i % 4 == 0) {
+            queries[i] = queries[i - 1 - gen() % 8];
+        }
+        else {
+            queries[i] = by_popularity[ranks[i]];
+        }
+    }
+
+    std::printf("elements: %zu, lookups: %zu, zipf exponent: %.2f\n", elements, lookups, exponent);
+
+    runTree<AVLTree<int, int>>("AVLTree", keys, queries);
+    runTree<RedBlackTree<int, int>>("RedBlackTree", keys, queries);
+    runTree<BPlusTree<int, int>>("BPlusTree", keys, queries);
+    runTree<SplayTree<int, int>>("SplayTree", keys, queries);
+    runTree<SplayTree<int, int, true>>("SplayTree (semi-splaying)", keys, queries);
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Timer-queue workload: every step pops the earliest deadline and schedules a new timer
+// a random delay later, so the queue size stays constant.
+//
+// Usage: bench_timer_queue [timers] [steps]
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+
+#include "RedBlackTree.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+// Deadlines are not unique, so the tree key carries a sequence number in the low bits.
+const uint64_t SEQUENCE_BITS = 24;
+
+uint64_t makeKey(uint64_t deadline, uint64_t& sequence) {
+    return (deadline << SEQUENCE_BITS) | (sequence++ & ((uint64_t(1) << SEQUENCE_BITS) - 1U));
+}
+
+std::vector<uint64_t> makeDelays(size_t count) {
+    std::mt19937 gen(3);
+    std::vector<uint64_t> delays(count);
+    for (uint64_t& delay : delays) {
+        delay = gen() % 100000;
+    }
+    return delays;
+}
+
+void runRedBlackTree(size_t timers, size_t steps, const std::vector<uint64_t>& delays) {
+    RedBlackTree<uint64_t, uint64_t> queue;
+    uint64_t sequence = 0;
+    for (size_t i = 0; i < timers; ++i) {
+        queue.insert(makeKey(delays[i], sequence), i);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        uint64_t delay = delays[step];
+        auto [key, value] = queue.popMin();
+        uint64_t deadline = (key >> SEQUENCE_BITS) + delay;
+        queue.insert(makeKey(deadline, sequence), value);
+        checksum += value;
+    }
+    printThroughput("RedBlackTree popMin", steps, stopwatch.seconds(), checksum);
+}
+
+void runRedBlackTreeErase(size_t timers, size_t steps, const std::vector<uint64_t>& delays) {
+    RedBlackTree<uint64_t, uint64_t> queue;
+    uint64_t sequence = 0;
+    for (size_t i = 0; i < timers; ++i) {
+        queue.insert(makeKey(delays[i], sequence), i);
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        uint64_t delay = delays[step];
+        auto it = queue.begin();
+        uint64_t key = (*it).first;
+        uint64_t value = (*it).second;
+        queue.erase(it);
+        uint64_t deadline = (key >> SEQUENCE_BITS) + delay;
+        queue.insert(makeKey(deadline, sequence), value);
+        checksum += value;
+    }
+    printThroughput("RedBlackTree erase(begin())", steps, stopwatch.seconds(), checksum);
+}
+
+void runMultimap(size_t timers, size_t steps, const std::vector<uint64_t>& delays) {
+    std::multimap<uint64_t, uint64_t> queue;
+    for (size_t i = 0; i < timers; ++i) {
+        queue.insert({ delays[i], i });
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        uint64_t delay = delays[step];
+        auto [deadline, value] = *queue.begin();
+        queue.erase(queue.begin());
+        queue.insert({ deadline + delay, value });
+        checksum += value;
+    }
+    printThroughput("std::multimap", steps, stopwatch.seconds(), checksum);
+}
+
+void runPriorityQueue(size_t timers, size_t steps, const std::vector<uint64_t>& delays) {
+    using Timer = std::pair<uint64_t, uint64_t>;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> queue;
+    for (size_t i = 0; i < timers; ++i) {
+        queue.push({ delays[i], i });
+    }
+
+    Stopwatch stopwatch;
+    uint64_t checksum = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        uint64_t delay = delays[step];
+        auto [deadline, value] = queue.top();
+        queue.pop();
+        queue.push({ deadline + delay, value });
+        checksum += value;
+    }
+    printThroughput("std::priority_queue", steps, stopwatch.seconds(), checksum);
+}
+
+int main(int argc, char** argv) {
+    size_t timers = readSizeArgument(argc, argv, 1, 100'000);
+    size_t steps = readSizeArgument(argc, argv, 2, 10'000'000);
+
+    std::vector<uint64_t> delays = makeDelays(std::max(timers, steps));
+
+    std::printf("timers: %zu, steps: %zu\n", timers, steps);
+
+    runPriorityQueue(timers, steps, delays);
+    runMultimap(timers, steps, delays);
+    runRedBlackTreeErase(timers, steps, delays);
+    runRedBlackTree(timers, steps, delays);
+
+    return 0;
+}
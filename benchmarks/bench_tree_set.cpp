@@ -0,0 +1,88 @@
+// Memory used per element by ordered sets: the key-only set trees against trees with a dummy
+// value and std::set. Counts every byte allocated with operator new, including the spare
+// capacity of the node pools and the heap buffers of std::string keys.
+//
+// Usage: bench_tree_set [elements]
+
+#include <new>
+#include <set>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "TreeSet.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+static size_t allocated_bytes = 0;
+
+void* operator new(size_t size) {
+    allocated_bytes += size;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+    allocated_bytes -= size;
+    std::free(ptr);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+template <typename TKey>
+TKey makeKey(int key);
+
+template <>
+int makeKey<int>(int key) {
+    return key;
+}
+
+// Long enough to need a heap buffer.
+template <>
+std::string makeKey<std::string>(int key) {
+    return "timestamp/" + std::to_string(key) + "/event";
+}
+
+template <typename TKey, typename SetType, typename Insert>
+void run(const char* name, const std::vector<int>& keys, Insert insert) {
+    size_t before = allocated_bytes;
+    {
+        SetType set;
+        Stopwatch stopwatch;
+        for (int key : keys) {
+            insert(set, makeKey<TKey>(key));
+        }
+        double seconds = stopwatch.seconds();
+        std::printf("%-40s %8.1f bytes/element  (insert %.3f s)\n",
+                    name, double(allocated_bytes - before) / keys.size(), seconds);
+    }
+}
+
+template <typename TKey>
+void runKeyType(const char* key_name, const std::vector<int>& keys) {
+    std::printf("%s keys:\n", key_name);
+    auto insert_pair = [](auto& set, const TKey& key) { set.insert(key, 0); };
+    auto insert_key = [](auto& set, const TKey& key) { set.insert(key); };
+
+    run<TKey, AVLTree<TKey, int>>("  AVLTree<TKey, int>", keys, insert_pair);
+    run<TKey, AVLSet<TKey>>("  AVLSet<TKey>", keys, insert_key);
+    run<TKey, RedBlackTree<TKey, int>>("  RedBlackTree<TKey, int>", keys, insert_pair);
+    run<TKey, RedBlackSet<TKey>>("  RedBlackSet<TKey>", keys, insert_key);
+    run<TKey, std::set<TKey>>("  std::set<TKey>", keys, insert_key);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = readSizeArgument(argc, argv, 1, 1'000'000);
+    std::vector<int> keys = makeUniqueKeys(elements, 1);
+
+    std::printf("elements: %zu\n", elements);
+
+    runKeyType<int>("int", keys);
+    runKeyType<std::string>("std::string", keys);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "TestableAVLTree.hpp"
+#include "TestableRedBlackTree.hpp"
+
+template <typename TreeType>
+class BatchApplyTest : public ::testing::Test {
+protected:
+    TreeType tree;
+    std::map<int, int> expected;
+    std::mt19937 gen{ 46 };
+
+    using Operation = BatchOperation<int, int>;
+
+    std::vector<Operation> makeBatch(size_t count, int key_range) {
+        std::vector<Operation> batch(count);
+        for (Operation& operation : batch) {
+            operation.type = gen() % 3 == 0 ? Operation::Type::ERASE : Operation::Type::UPSERT;
+            operation.key = static_cast<int>(gen() % key_range);
+            operation.value = static_cast<int>(gen());
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const Operation& lhs, const Operation& rhs) {
+            return lhs.key < rhs.key;
+        });
+        return batch;
+    }
+
+    void applyAndCheck(const std::vector<Operation>& batch) {
+        std::vector<bool> results = this->tree.applyBatch(batch);
+        ASSERT_EQ(results.size(), batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Operation& operation = batch[i];
+            if (operation.type == Operation::Type::ERASE) {
+                ASSERT_EQ(results[i], expected.erase(operation.key) > 0U) << i;
+            }
+            else {
+                ASSERT_EQ(results[i], expected.count(operation.key) == 0U) << i;
+                expected[operation.key] = operation.value;
+            }
+        }
+
+        ASSERT_TRUE(this->tree.isTreeCorrect());
+        ASSERT_EQ(this->tree.size(), expected.size());
+        auto expected_it = expected.begin();
+        for (auto [key, value] : this->tree) {
+            ASSERT_EQ(key, expected_it->first);
+            ASSERT_EQ(value, expected_it->second);
+            ++expected_it;
+        }
+    }
+};
+
+using BatchApplyImplementations = ::testing::Types<TestableAVLTree<int, int>, TestableRedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(BatchApplyTest, BatchApplyImplementations);
+
+TYPED_TEST(BatchApplyTest, SmallBatchesBySearch) {
+    this->applyAndCheck(this->makeBatch(20000, 50000));
+    for (int round = 0; round < 50; round++) {
+        this->applyAndCheck(this->makeBatch(100, 50000));
+    }
+}
+
+TYPED_TEST(BatchApplyTest, LargeBatchesByMerge) {
+    for (size_t count : { 1U, 2U, 3U, 7U, 100U, 5000U, 30000U }) {
+        this->applyAndCheck(this->makeBatch(count, 20000));
+    }
+    // Still consistent for ordinary updates after a rebuild.
+    for (int i = 0; i < 1000; i++) {
+        this->tree.insert(i * 31 % 20000, i);
+        this->expected.insert({ i * 31 % 20000, i });
+    }
+    this->applyAndCheck({});
+    EXPECT_TRUE(this->tree.isTreeCorrect());
+}
+
+TYPED_TEST(BatchApplyTest, EqualKeysTakeEffectInOrder) {
+    using Operation = BatchOperation<int, int>;
+    std::vector<Operation> batch = {
+        { Operation::Type::UPSERT, 5, 1 },
+        { Operation::Type::UPSERT, 5, 2 },
+        { Operation::Type::ERASE, 5, 0 },
+        { Operation::Type::ERASE, 5, 0 },
+        { Operation::Type::UPSERT, 5, 3 },
+    };
+    // Merged into an empty tree, then searched for in a large one.
+    EXPECT_EQ(this->tree.applyBatch(batch), std::vector<bool>({ true, false, true, false, true }));
+    EXPECT_EQ(this->tree[5], 3);
+
+    this->tree.clear();
+    for (int i = 0; i < 1000; i++) {
+        this->tree.insert(i * 2 + 100, i);
+    }
+    EXPECT_EQ(this->tree.applyBatch(batch), std::vector<bool>({ true, false, true, false, true }));
+    EXPECT_EQ(this->tree[5], 3);
+    EXPECT_TRUE(this->tree.isTreeCorrect());
+
+    std::swap(batch[0], batch[4]);
+    batch[4].key = 4;
+    EXPECT_THROW(this->tree.applyBatch(batch), std::invalid_argument);
+}
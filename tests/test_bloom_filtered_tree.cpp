@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "AVLTree.hpp"
+#include "BloomFilteredTree.hpp"
+
+template <typename TreeType>
+class BloomFilteredTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using BloomFilteredImplementations = ::testing::Types<BloomFilteredTree<int, int>,
+                                                      BloomFilteredTree<int, int, AVLTree<int, int>>>;
+
+TYPED_TEST_SUITE(BloomFilteredTreeTest, BloomFilteredImplementations);
+
+TYPED_TEST(BloomFilteredTreeTest, MatchesStdMapThroughRebuilds) {
+    std::map<int, int> expected;
+    std::mt19937 gen(51);
+
+    for (int step = 0; step < 50000; step++) {
+        // The key range widens, so the filter both grows and gets rebuilt after erases.
+        int key = static_cast<int>(gen() % (1000 + step / 4));
+        switch (gen() % 3) {
+        case 0:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 1:
+            if (expected.erase(key) > 0) {
+                this->tree.erase(key);
+            }
+            else {
+                EXPECT_THROW(this->tree.erase(key), std::out_of_range);
+            }
+            break;
+        default: {
+            auto it = this->tree.find(key);
+            auto expected_it = expected.find(key);
+            ASSERT_EQ(it == this->tree.end(), expected_it == expected.end());
+            if (it != this->tree.end()) {
+                EXPECT_EQ((*it).second, expected_it->second);
+                EXPECT_EQ(this->tree[key], expected_it->second);
+            }
+            else {
+                EXPECT_THROW(this->tree[key], std::runtime_error);
+            }
+            EXPECT_EQ(this->tree.isExist(key), expected_it != expected.end());
+        }
+        }
+    }
+
+    EXPECT_EQ(this->tree.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto [key, value] : this->tree) {
+        EXPECT_EQ(key, expected_it->first);
+        ++expected_it;
+    }
+}
+
+TYPED_TEST(BloomFilteredTreeTest, FindsEveryKeyAfterClear) {
+    for (int i = 0; i < 10000; i++) {
+        this->tree.insert(i * 7, i);
+    }
+    this->tree.clear();
+    EXPECT_FALSE(this->tree.isExist(7));
+
+    for (int i = 0; i < 10000; i++) {
+        this->tree.insert(i * 3, i);
+    }
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_TRUE(this->tree.isExist(i * 3));
+    }
+}
+
+TYPED_TEST(BloomFilteredTreeTest, ExposesOnlyFilterAwareMutators) {
+    // Bulk mutators of the tree would bypass the filter, so they are not part of the interface.
+    constexpr bool has_apply_batch = requires(TypeParam& tree) { tree.applyBatch({}); };
+    constexpr bool has_erase_if = requires(TypeParam& tree) { tree.eraseIf([](const int&, const int&) { return true; }); };
+    constexpr bool has_build_parallel = requires(TypeParam& tree) { tree.buildParallel({}); };
+    constexpr bool has_merge = requires(TypeParam& tree) { tree.merge(tree); };
+    EXPECT_FALSE(has_apply_batch);
+    EXPECT_FALSE(has_erase_if);
+    EXPECT_FALSE(has_build_parallel);
+    EXPECT_FALSE(has_merge);
+
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, i);
+    }
+    EXPECT_EQ(this->tree.size(), 100U);
+    EXPECT_EQ((*this->tree.lowerBound(50)).first, 50);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(this->tree.isExist(i));
+    }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "BufferedTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class BufferedTreeTest : public ::testing::Test {
+protected:
+    // A small buffer, so that merges happen often.
+    TreeType tree = TreeType(16);
+
+    static std::vector<std::pair<int, int>> getElements(const TreeType& tree) {
+        std::vector<std::pair<int, int>> elements;
+        for (auto [key, value] : tree) {
+            elements.push_back({ key, value });
+        }
+        return elements;
+    }
+};
+
+using BufferedTreeImplementations = ::testing::Types<BufferedTree<int, int>,
+                                                     BufferedTree<int, int, RedBlackTree<int, int>>>;
+
+TYPED_TEST_SUITE(BufferedTreeTest, BufferedTreeImplementations);
+
+TYPED_TEST(BufferedTreeTest, MatchesStdMap) {
+    std::map<int, int> expected;
+    std::mt19937 gen(41);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 300);
+        switch (gen() % 5) {
+        case 0:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 1:
+            this->tree.assign(key, step);
+            expected[key] = step;
+            break;
+        case 2:
+            this->tree.erase(key);
+            expected.erase(key);
+            break;
+        case 3: {
+            ASSERT_EQ(this->tree.isExist(key), expected.contains(key));
+            if (expected.contains(key)) {
+                EXPECT_EQ(this->tree[key], expected[key]);
+            }
+            else {
+                EXPECT_THROW(this->tree[key], std::runtime_error);
+            }
+            break;
+        }
+        default: {
+            auto it = this->tree.lowerBound(key);
+            auto expected_it = expected.lower_bound(key);
+            for (int i = 0; i < 3 && expected_it != expected.end(); i++, ++it, ++expected_it) {
+                ASSERT_NE(it, this->tree.end());
+                EXPECT_EQ(it->first, expected_it->first);
+                EXPECT_EQ(it->second, expected_it->second);
+            }
+            if (expected_it == expected.end()) {
+                EXPECT_EQ(it, this->tree.end());
+            }
+
+            auto upper = this->tree.upperBound(key);
+            auto expected_upper = expected.upper_bound(key);
+            ASSERT_EQ(upper == this->tree.end(), expected_upper == expected.end());
+            if (upper != this->tree.end()) {
+                EXPECT_EQ(upper->first, expected_upper->first);
+            }
+        }
+        }
+
+        if (step % 1000 == 0) {
+            std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+            ASSERT_EQ(this->getElements(this->tree), expected_elements);
+        }
+    }
+
+    EXPECT_EQ(this->tree.size(), expected.size());
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(this->getElements(this->tree), expected_elements);
+}
+
+TYPED_TEST(BufferedTreeTest, BufferedEntriesShadowTheTree) {
+    for (int key = 0; key < 10; key++) {
+        this->tree.insert(key, key);
+    }
+    this->tree.flush();
+
+    this->tree.insert(3, 100);
+    this->tree.assign(4, 200);
+    this->tree.erase(5);
+    this->tree.erase(42);
+    this->tree.insert(10, 300);
+
+    std::vector<std::pair<int, int>> expected = {
+        { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 3 }, { 4, 200 }, { 6, 6 }, { 7, 7 }, { 8, 8 }, { 9, 9 }, { 10, 300 }
+    };
+    EXPECT_EQ(this->getElements(this->tree), expected);
+    EXPECT_EQ(this->tree.find(5), this->tree.end());
+    EXPECT_EQ(this->tree.find(4)->second, 200);
+    EXPECT_FALSE(this->tree.empty());
+
+    this->tree.erase(5);
+    this->tree.insert(5, 500);
+    EXPECT_EQ(this->tree[5], 500);
+
+    this->tree.clear();
+    EXPECT_TRUE(this->tree.empty());
+    EXPECT_EQ(this->tree.size(), 0U);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "TestableAVLTree.hpp"
+#include "TestableRedBlackTree.hpp"
+
+template <typename TreeType>
+class BulkEraseTest : public ::testing::Test {
+protected:
+    TreeType tree;
+    std::map<int, int> expected;
+
+    void fill(int count) {
+        std::mt19937 gen(47);
+        for (int i = 0; i < count; i++) {
+            int key = static_cast<int>(gen() % (count * 4));
+            this->tree.insert(key, i);
+            expected.insert({ key, i });
+        }
+    }
+
+    void check() {
+        ASSERT_TRUE(this->tree.isTreeCorrect());
+        ASSERT_EQ(this->tree.size(), expected.size());
+        auto expected_it = expected.begin();
+        for (auto [key, value] : this->tree) {
+            ASSERT_EQ(key, expected_it->first);
+            ASSERT_EQ(value, expected_it->second);
+            ++expected_it;
+        }
+    }
+};
+
+using BulkEraseImplementations = ::testing::Types<TestableAVLTree<int, int>, TestableRedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(BulkEraseTest, BulkEraseImplementations);
+
+TYPED_TEST(BulkEraseTest, EraseIfAtDifferentFractions) {
+    this->fill(20000);
+    // Small fractions erase node by node, large ones rebuild.
+    for (int percent : { 1, 5, 30, 70, 100 }) {
+        auto predicate = [percent](const int& key, const int& value) {
+            return (key * 7 + value) % 100 < percent;
+        };
+        size_t count = this->tree.eraseIf(predicate);
+        size_t expected_count = std::erase_if(this->expected, [&](const auto& element) {
+            return predicate(element.first, element.second);
+        });
+        EXPECT_EQ(count, expected_count);
+        this->check();
+
+        // The tree stays usable after the free slots are compacted or the pool is rebuilt.
+        for (int i = 0; i < 2000; i++) {
+            this->tree.insert(i * 13, -i);
+            this->expected.insert({ i * 13, -i });
+        }
+        this->check();
+    }
+}
+
+TYPED_TEST(BulkEraseTest, EraseRange) {
+    this->fill(20000);
+    std::mt19937 gen(48);
+    for (int round = 0; round < 40; round++) {
+        int from = static_cast<int>(gen() % 80000);
+        // Mostly short ranges, sometimes a large part of the tree.
+        int length = round % 4 == 0 ? static_cast<int>(gen() % 40000) : static_cast<int>(gen() % 500);
+
+        auto it = this->tree.eraseRange(this->tree.lowerBound(from), this->tree.lowerBound(from + length));
+        auto expected_it = this->expected.erase(this->expected.lower_bound(from), this->expected.lower_bound(from + length));
+        ASSERT_EQ(it == this->tree.end(), expected_it == this->expected.end());
+        if (it != this->tree.end()) {
+            EXPECT_EQ((*it).first, expected_it->first);
+        }
+        this->check();
+    }
+
+    auto it = this->tree.eraseRange(this->tree.begin(), this->tree.end());
+    EXPECT_EQ(it, this->tree.end());
+    EXPECT_TRUE(this->tree.empty());
+    this->tree.insert(1, 1);
+    EXPECT_EQ(this->tree.size(), 1U);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentRedBlackTree.hpp"
+
+TEST(ConcurrentRedBlackTreeTest, MatchesStdMapInOneThread) {
+    ConcurrentRedBlackTree<int, int> tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(11);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 500);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(tree.insert(key, step), expected.insert({ key, step }).second);
+            break;
+        case 1:
+            tree.assign(key, step);
+            expected[key] = step;
+            break;
+        case 2:
+            EXPECT_EQ(tree.erase(key), expected.erase(key) > 0);
+            break;
+        default: {
+            auto value = tree.find(key);
+            auto it = expected.find(key);
+            ASSERT_EQ(value.has_value(), it != expected.end());
+            if (value.has_value()) {
+                EXPECT_EQ(*value, it->second);
+            }
+
+            auto lower = tree.lowerBound(key);
+            auto expected_lower = expected.lower_bound(key);
+            ASSERT_EQ(lower.has_value(), expected_lower != expected.end());
+            if (lower.has_value()) {
+                EXPECT_EQ(lower->first, expected_lower->first);
+            }
+
+            auto upper = tree.upperBound(key);
+            auto expected_upper = expected.upper_bound(key);
+            ASSERT_EQ(upper.has_value(), expected_upper != expected.end());
+            if (upper.has_value()) {
+                EXPECT_EQ(upper->first, expected_upper->first);
+            }
+        }
+        }
+    }
+
+    EXPECT_EQ(tree.size(), expected.size());
+
+    std::vector<std::pair<int, int>> elements;
+    tree.forEach([&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+
+    elements.clear();
+    tree.forEach(250, [&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    expected_elements.assign(expected.lower_bound(250), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+}
+
+TEST(ConcurrentRedBlackTreeTest, CanClearAndReuse) {
+    ConcurrentRedBlackTree<int, int> tree;
+    for (int i = 0; i < 1000; i++) {
+        tree.insert(i, i);
+    }
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.isExist(5));
+
+    for (int i = 0; i < 1000; i++) {
+        tree.insert(i, -i);
+    }
+    EXPECT_EQ(tree.size(), 1000U);
+    EXPECT_EQ(*tree.find(5), -5);
+}
+
+// One writer churns the odd keys while readers check that every answer they get
+// belongs to some consistent state of the tree. Even keys are never erased.
+TEST(ConcurrentRedBlackTreeTest, ReadersSeeConsistentStatesUnderWrites) {
+    const int KEY_RANGE = 4000;
+    const int READERS = 4;
+
+    ConcurrentRedBlackTree<int, int> tree;
+    for (int key = 0; key < KEY_RANGE; key += 2) {
+        tree.insert(key, key * 3);
+    }
+
+    std::atomic<bool> is_done = false;
+    std::atomic<int> errors = 0;
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < READERS; reader++) {
+        readers.emplace_back([&, reader]() {
+            std::mt19937 gen(100 + reader);
+            while (!is_done.load()) {
+                int key = static_cast<int>(gen() % KEY_RANGE);
+
+                auto value = tree.find(key);
+                if ((key % 2 == 0 && !value.has_value()) || (value.has_value() && *value != key * 3)) {
+                    ++errors;
+                }
+
+                auto lower = tree.lowerBound(key);
+                if (key < KEY_RANGE - 1 && (!lower.has_value() || lower->first < key || lower->first > key + 1 ||
+                                            lower->second != lower->first * 3)) {
+                    ++errors;
+                }
+
+                if (gen() % 64 == 0) {
+                    int previous = -1;
+                    int even_keys = 0;
+                    tree.forEach([&](int element_key, int element_value) {
+                        if (element_key <= previous || element_value != element_key * 3) {
+                            ++errors;
+                        }
+                        previous = element_key;
+                        even_keys += (element_key % 2 == 0);
+                    });
+                    if (even_keys != KEY_RANGE / 2) {
+                        ++errors;
+                    }
+                }
+            }
+        });
+    }
+
+    std::mt19937 gen(7);
+    for (int step = 0; step < 200000; step++) {
+        int key = static_cast<int>(gen() % (KEY_RANGE / 2)) * 2 + 1;
+        if (gen() % 2 == 0) {
+            tree.insert(key, key * 3);
+        }
+        else {
+            tree.erase(key);
+        }
+    }
+
+    is_done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(errors.load(), 0);
+}
+
+// Too wide for a lock-free atomic, so it is copied byte by byte.
+struct Triple {
+    int a, b, c;
+};
+
+TEST(ConcurrentRedBlackTreeTest, ReadersNeverSeeTornWideValues) {
+    const int KEYS = 256;
+    const int READERS = 3;
+
+    ConcurrentRedBlackTree<int, Triple> tree;
+    for (int key = 0; key < KEYS; key++) {
+        tree.insert(key, { 0, 0, 0 });
+    }
+
+    std::atomic<bool> is_done = false;
+    std::atomic<int> errors = 0;
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < READERS; reader++) {
+        readers.emplace_back([&, reader]() {
+            std::mt19937 gen(200 + reader);
+            while (!is_done.load()) {
+                auto value = tree.find(static_cast<int>(gen() % KEYS));
+                if (!value.has_value() || value->a != value->b || value->b != value->c) {
+                    ++errors;
+                }
+            }
+        });
+    }
+
+    std::mt19937 gen(8);
+    for (int step = 1; step <= 100000; step++) {
+        tree.assign(static_cast<int>(gen() % KEYS), { step, step, step });
+    }
+
+    is_done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(errors.load(), 0);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+
+#include "DurableTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class DurableTreeTest : public ::testing::Test {
+protected:
+    std::string path;
+    std::string crash_path;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = (std::filesystem::temp_directory_path() /
+                (std::string("durable_") + info->type_param() + "_" + info->name())).string();
+        for (char& c : path) {
+            if (c == '<' || c == '>' || c == ',' || c == ' ' || c == ':') {
+                c = '_';
+            }
+        }
+        crash_path = path + "_crash";
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const std::string& base : { path, crash_path }) {
+            for (const char* suffix : { ".wal", ".checkpoint", ".checkpoint.tmp" }) {
+                std::filesystem::remove(base + suffix);
+            }
+        }
+    }
+
+    // Copies the files as they are on disk now, as if the process had crashed at this point.
+    void simulateCrash() {
+        for (const char* suffix : { ".wal", ".checkpoint" }) {
+            std::filesystem::remove(crash_path + suffix);
+            if (std::filesystem::exists(path + suffix)) {
+                std::filesystem::copy_file(path + suffix, crash_path + suffix);
+            }
+        }
+    }
+
+    static void expectEqual(const TreeType& tree, const std::map<int, int>& expected) {
+        ASSERT_EQ(tree.size(), expected.size());
+        auto it = expected.begin();
+        for (auto [key, value] : tree) {
+            EXPECT_EQ(key, it->first);
+            EXPECT_EQ(value, it->second);
+            ++it;
+        }
+    }
+
+    static void applyRandomUpdates(TreeType& tree, std::map<int, int>& expected, std::mt19937& gen, int count) {
+        for (int step = 0; step < count; step++) {
+            int key = static_cast<int>(gen() % 1000);
+            switch (gen() % 3) {
+            case 0:
+                tree.insert(key, step);
+                expected.insert({ key, step });
+                break;
+            case 1:
+                tree.assign(key, -step);
+                expected[key] = -step;
+                break;
+            default:
+                if (expected.erase(key) > 0) {
+                    tree.erase(key);
+                }
+            }
+        }
+    }
+};
+
+using DurableTreeImplementations = ::testing::Types<DurableTree<int, int>,
+                                                    DurableTree<int, int, RedBlackTree<int, int>>>;
+
+TYPED_TEST_SUITE(DurableTreeTest, DurableTreeImplementations);
+
+TYPED_TEST(DurableTreeTest, RecoversFromLogAfterCleanShutdown) {
+    std::map<int, int> expected;
+    std::mt19937 gen(31);
+    {
+        TypeParam tree(this->path);
+        this->applyRandomUpdates(tree, expected, gen, 5000);
+        EXPECT_THROW(tree.erase(-1), std::out_of_range);
+    }
+
+    TypeParam tree(this->path);
+    this->expectEqual(tree, expected);
+}
+
+TYPED_TEST(DurableTreeTest, CrashLosesOnlyUnsyncedUpdates) {
+    typename TypeParam::Options options;
+    options.group_size = 1000000;
+
+    std::map<int, int> expected;
+    std::mt19937 gen(32);
+
+    TypeParam tree(this->path, options);
+    this->applyRandomUpdates(tree, expected, gen, 3000);
+    tree.checkpoint();
+    this->applyRandomUpdates(tree, expected, gen, 3000);
+    tree.sync();
+    std::map<int, int> synced = expected;
+
+    this->applyRandomUpdates(tree, expected, gen, 500);
+    this->simulateCrash();
+
+    TypeParam recovered(this->crash_path, options);
+    this->expectEqual(recovered, synced);
+}
+
+TYPED_TEST(DurableTreeTest, IgnoresTornTailOfTheLog) {
+    std::map<int, int> expected;
+    std::mt19937 gen(33);
+    {
+        TypeParam tree(this->path);
+        this->applyRandomUpdates(tree, expected, gen, 2000);
+    }
+    {
+        std::ofstream wal(this->path + ".wal", std::ios::binary | std::ios::app);
+        wal.write("partial record", 14);
+    }
+    {
+        TypeParam tree(this->path);
+        this->expectEqual(tree, expected);
+        tree.insert(100000, 1);
+        expected.insert({ 100000, 1 });
+    }
+
+    TypeParam tree(this->path);
+    this->expectEqual(tree, expected);
+}
+
+TYPED_TEST(DurableTreeTest, AutomaticCheckpointsTruncateTheLog) {
+    typename TypeParam::Options options;
+    options.checkpoint_interval = 1000;
+
+    std::map<int, int> expected;
+    std::mt19937 gen(34);
+    {
+        TypeParam tree(this->path, options);
+        this->applyRandomUpdates(tree, expected, gen, 4500);
+        tree.clear();
+        expected.clear();
+        this->applyRandomUpdates(tree, expected, gen, 100);
+    }
+    EXPECT_TRUE(std::filesystem::exists(this->path + ".checkpoint"));
+    EXPECT_LT(std::filesystem::file_size(this->path + ".wal"), 1000U * 32U);
+
+    TypeParam tree(this->path, options);
+    this->expectEqual(tree, expected);
+}
+
+// Seven bytes of padding follow `tag`.
+struct PaddedValue {
+    char tag;
+    int64_t amount;
+};
+
+TEST(DurableTreePaddingTest, ValuesWithPaddingSurviveReopen) {
+    std::string path = (std::filesystem::temp_directory_path() / "durable_padded_values").string();
+    for (const char* suffix : { ".wal", ".checkpoint" }) {
+        std::filesystem::remove(path + suffix);
+    }
+
+    {
+        DurableTree<int, PaddedValue> tree(path);
+        for (int key = 0; key < 1000; key++) {
+            // The padding holds garbage, which must not make the records look torn.
+            PaddedValue value;
+            std::memset(&value, key & 0xFF, sizeof(value));
+            value.tag = static_cast<char>('a' + key % 26);
+            value.amount = key * 1000LL;
+            tree.insert(key, value);
+        }
+    }
+
+    {
+        DurableTree<int, PaddedValue> tree(path);
+        ASSERT_EQ(tree.size(), 1000U);
+        for (int key = 0; key < 1000; key++) {
+            EXPECT_EQ(tree[key].tag, static_cast<char>('a' + key % 26));
+            EXPECT_EQ(tree[key].amount, key * 1000LL);
+        }
+    }
+
+    for (const char* suffix : { ".wal", ".checkpoint" }) {
+        std::filesystem::remove(path + suffix);
+    }
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iterator>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class EytzingerIndexTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using ExportableTreeImplementations = ::testing::Types<AVLTree<int, int>,
+                                                       RedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(EytzingerIndexTest, ExportableTreeImplementations);
+
+TYPED_TEST(EytzingerIndexTest, CanExportEmptyTree) {
+    auto index = this->tree.toEytzinger();
+
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.begin(), index.end());
+    EXPECT_EQ(index.find(0), index.end());
+    EXPECT_EQ(index.lowerBound(0), index.end());
+    EXPECT_ANY_THROW(*index.end());
+}
+
+TYPED_TEST(EytzingerIndexTest, CanFindAllElements) {
+    std::vector<int> keys;
+    std::set<int> was;
+
+    while (keys.size() < 3000) {
+        int key = std::rand();
+
+        if (!was.contains(key)) {
+            was.insert(key);
+            keys.push_back(key);
+        }
+    }
+
+    for (int key : keys) {
+        this->tree.insert(key, key + 1);
+    }
+
+    auto index = this->tree.toEytzinger();
+    EXPECT_EQ(index.size(), keys.size());
+
+    for (int key : keys) {
+        auto it = index.find(key);
+        ASSERT_NE(it, index.end());
+        EXPECT_EQ(it->first, key);
+        EXPECT_EQ(it->second, key + 1);
+        EXPECT_EQ(index[key], key + 1);
+    }
+
+    EXPECT_FALSE(index.isExist(-1));
+    EXPECT_ANY_THROW(index[-1]);
+}
+
+TYPED_TEST(EytzingerIndexTest, IteratesInOrder) {
+    for (int size = 0; size <= 70; size++) {
+        TypeParam tree;
+        for (int i = size - 1; i >= 0; i--) {
+            tree.insert(i * 2, i);
+        }
+
+        auto index = tree.toEytzinger();
+
+        int p = 0;
+        for (auto [key, value] : index) {
+            EXPECT_EQ(key, p * 2);
+            EXPECT_EQ(value, p++);
+        }
+        EXPECT_EQ(p, size);
+    }
+}
+
+TYPED_TEST(EytzingerIndexTest, BoundsMatchTheTree) {
+    for (int size : { 1, 2, 7, 8, 100, 1023, 1024 }) {
+        TypeParam tree;
+        for (int i = 0; i < size; i++) {
+            tree.insert(i * 3, i);
+        }
+
+        auto index = tree.toEytzinger();
+
+        for (int key = -2; key <= size * 3 + 2; key++) {
+            auto tree_lower = tree.lowerBound(key);
+            auto index_lower = index.lowerBound(key);
+            if (tree_lower == tree.end()) {
+                EXPECT_EQ(index_lower, index.end());
+            }
+            else {
+                ASSERT_NE(index_lower, index.end());
+                EXPECT_EQ(index_lower->first, tree_lower->first);
+            }
+
+            auto tree_upper = tree.upperBound(key);
+            auto index_upper = index.upperBound(key);
+            if (tree_upper == tree.end()) {
+                EXPECT_EQ(index_upper, index.end());
+            }
+            else {
+                ASSERT_NE(index_upper, index.end());
+                EXPECT_EQ(index_upper->first, tree_upper->first);
+            }
+        }
+    }
+}
+
+TYPED_TEST(EytzingerIndexTest, BatchLowerBoundMatchesSingleLookups) {
+    for (int i = 0; i < 1000; i++) {
+        this->tree.insert(i * 5, i);
+    }
+
+    auto index = this->tree.toEytzinger();
+
+    std::vector<int> queries;
+    for (int key = -3; key <= 5010; key++) {
+        queries.push_back(key);
+    }
+    std::mt19937 gen(7);
+    std::shuffle(queries.begin(), queries.end(), gen);
+
+    std::vector<decltype(index.end())> result;
+    index.lowerBound(queries.data(), queries.data() + queries.size(), std::back_inserter(result));
+
+    ASSERT_EQ(result.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        EXPECT_EQ(result[i], index.lowerBound(queries[i]));
+    }
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class FingerSearchTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using FingerSearchImplementations = ::testing::Types<AVLTree<int, int>, RedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(FingerSearchTest, FingerSearchImplementations);
+
+TYPED_TEST(FingerSearchTest, MatchesSearchFromRoot) {
+    std::map<int, int> expected;
+    std::mt19937 gen(45);
+    for (int i = 0; i < 5000; i++) {
+        int key = static_cast<int>(gen() % 20000);
+        this->tree.insert(key, i);
+        expected.insert({ key, i });
+    }
+
+    auto finger = this->tree.begin();
+    for (int step = 0; step < 50000; step++) {
+        // Mostly near the finger, sometimes far away or outside the key range.
+        int key = gen() % 10 == 0 ? static_cast<int>(gen() % 22000) - 1000 :
+                  (finger == this->tree.end() ? 0 : (*finger).first) + static_cast<int>(gen() % 200) - 100;
+
+        auto it = this->tree.lowerBound(finger, key);
+        auto expected_it = expected.lower_bound(key);
+        ASSERT_EQ(it == this->tree.end(), expected_it == expected.end()) << key;
+        if (it != this->tree.end()) {
+            ASSERT_EQ((*it).first, expected_it->first);
+        }
+
+        auto found = this->tree.find(finger, key);
+        ASSERT_EQ(found == this->tree.end(), expected.count(key) == 0U);
+        if (found != this->tree.end()) {
+            ASSERT_EQ((*found).first, key);
+        }
+        finger = it;
+    }
+}
+
+TYPED_TEST(FingerSearchTest, ScansSortedStream) {
+    for (int i = 0; i < 10000; i++) {
+        this->tree.insert(i * 2, i);
+    }
+    auto finger = this->tree.begin();
+    for (int key = 0; key < 19999; key++) {
+        finger = this->tree.lowerBound(finger, key);
+        ASSERT_NE(finger, this->tree.end());
+        ASSERT_EQ((*finger).first, key + key % 2);
+    }
+    EXPECT_EQ(this->tree.lowerBound(finger, 19999), this->tree.end());
+    EXPECT_EQ(this->tree.find(this->tree.end(), 42), this->tree.find(42));
+}
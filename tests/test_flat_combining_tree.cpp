@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <compare>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "FlatCombiningTree.hpp"
+
+TEST(FlatCombiningTreeTest, MatchesStdMapInOneThread) {
+    FlatCombiningTree<int, int> tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(5);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 500);
+        switch (gen() % 3) {
+        case 0:
+            EXPECT_EQ(tree.insert(key, step), expected.insert({ key, step }).second);
+            break;
+        case 1:
+            EXPECT_EQ(tree.erase(key), expected.erase(key) > 0);
+            break;
+        default: {
+            auto value = tree.find(key);
+            auto it = expected.find(key);
+            ASSERT_EQ(value.has_value(), it != expected.end());
+            if (value.has_value()) {
+                EXPECT_EQ(*value, it->second);
+            }
+        }
+        }
+    }
+
+    EXPECT_EQ(tree.size(), expected.size());
+
+    std::vector<std::pair<int, int>> elements;
+    tree.forEach([&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+}
+
+TEST(FlatCombiningTreeTest, ConcurrentThreadsSeeTheirOwnOperations) {
+    const int THREADS = 8;
+    const int KEYS_PER_THREAD = 5000;
+
+    FlatCombiningTree<int, int> tree;
+    std::vector<int> errors(THREADS, 0);
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < THREADS; thread++) {
+        threads.emplace_back([&, thread]() {
+            for (int i = 0; i < KEYS_PER_THREAD; i++) {
+                int key = i * THREADS + thread;
+                errors[thread] += !tree.insert(key, -key);
+                errors[thread] += tree.insert(key, key);
+                errors[thread] += tree.find(key) != -key;
+                if (i % 2 == 0) {
+                    errors[thread] += !tree.erase(key);
+                    errors[thread] += tree.isExist(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int thread = 0; thread < THREADS; thread++) {
+        EXPECT_EQ(errors[thread], 0);
+    }
+    EXPECT_EQ(tree.size(), static_cast<size_t>(THREADS * KEYS_PER_THREAD / 2));
+
+    int previous = -1;
+    tree.forEach([&](int key, int value) {
+        EXPECT_GT(key, previous);
+        EXPECT_EQ(value, -key);
+        EXPECT_EQ((key / THREADS) % 2, 1);
+        previous = key;
+    });
+}
+
+TEST(FlatCombiningTreeTest, ContendedKeysKeepSuccessesConsistent) {
+    const int THREADS = 8;
+    const int STEPS = 20000;
+    const int KEYS = 16;
+
+    // Batches hold several operations on the same key, which are answered in the order of arrival.
+    FlatCombiningTree<int, int> tree;
+    std::vector<long long> balances(THREADS, 0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < THREADS; thread++) {
+        threads.emplace_back([&, thread]() {
+            std::mt19937 gen(thread);
+            for (int step = 0; step < STEPS; step++) {
+                int key = static_cast<int>(gen() % KEYS);
+                if (gen() % 2 == 0) {
+                    balances[thread] += tree.insert(key, key);
+                }
+                else {
+                    balances[thread] -= tree.erase(key);
+                }
+                auto value = tree.find(key);
+                if (value.has_value()) {
+                    EXPECT_EQ(*value, key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    long long balance = 0;
+    for (long long thread_balance : balances) {
+        balance += thread_balance;
+    }
+    size_t count = 0;
+    tree.forEach([&](int key, int value) {
+        EXPECT_EQ(value, key);
+        ++count;
+    });
+    EXPECT_EQ(static_cast<long long>(count), balance);
+    EXPECT_EQ(tree.size(), count);
+}
+
+TEST(FlatCombiningTreeTest, ThrowingCallbackReleasesCombiner) {
+    FlatCombiningTree<int, int> tree;
+    tree.insert(1, 10);
+    EXPECT_THROW(tree.forEach([](int, int) { throw std::runtime_error("callback"); }), std::runtime_error);
+
+    // The next operation would wait forever if forEach had kept the combiner role.
+    EXPECT_TRUE(tree.insert(2, 20));
+    EXPECT_EQ(tree.find(2), 20);
+}
+
+// Comparing a negative key throws, standing for any exception from applying a batch.
+struct FragileKey {
+    int value = 0;
+
+    std::strong_ordering operator<=>(const FragileKey& other) const {
+        if (value < 0 || other.value < 0) {
+            throw std::runtime_error("fragile key");
+        }
+        return value <=> other.value;
+    }
+
+    bool operator==(const FragileKey& other) const {
+        return (*this <=> other) == 0;
+    }
+};
+
+TEST(FlatCombiningTreeTest, ThrowingBatchReleasesEveryWaiter) {
+    const int THREADS = 4;
+    const int STEPS = 2000;
+
+    FlatCombiningTree<FragileKey, int> tree;
+    tree.insert({ 1 }, 1);
+    EXPECT_THROW(tree.insert({ -1 }, -1), std::runtime_error);
+
+    // Operations that share a batch with a throwing one fail with it; none of them hangs.
+    std::atomic<int> count_of_failures = 0;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < THREADS; thread++) {
+        threads.emplace_back([&, thread]() {
+            for (int step = 0; step < STEPS; step++) {
+                int key = step % 7 == 0 && thread == 0 ? -1 : step * THREADS + thread + 2;
+                try {
+                    tree.insert({ key }, key);
+                }
+                catch (const std::runtime_error&) {
+                    ++count_of_failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GE(count_of_failures.load(), (STEPS + 6) / 7);
+
+    EXPECT_TRUE(tree.insert({ 0 }, 0));
+    EXPECT_EQ(tree.find({ 0 }), 0);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class FrozenTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+const int FROZEN_TESTS_SIZE = 3000;
+
+using FreezableTreeImplementations = ::testing::Types<AVLTree<int, int>,
+                                                      RedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(FrozenTreeTest, FreezableTreeImplementations);
+
+TYPED_TEST(FrozenTreeTest, CanFreezeEmptyTree) {
+    auto frozen = this->tree.freeze();
+
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(frozen.begin(), frozen.end());
+    EXPECT_EQ(frozen.find(0), frozen.end());
+    EXPECT_EQ(frozen.lowerBound(0), frozen.end());
+}
+
+TYPED_TEST(FrozenTreeTest, CanFindAllElements) {
+    std::vector<int> keys;
+    std::set<int> was;
+
+    while (keys.size() < FROZEN_TESTS_SIZE) {
+        // Bounded so that `key * 2` fits in an int.
+        int key = std::rand() % 1'000'000;
+
+        if (!was.contains(key)) {
+            was.insert(key);
+            keys.push_back(key);
+        }
+    }
+
+    for (int key : keys) {
+        this->tree.insert(key, key * 2);
+    }
+
+    auto frozen = this->tree.freeze();
+    EXPECT_EQ(frozen.size(), keys.size());
+
+    for (int key : keys) {
+        auto it = frozen.find(key);
+        ASSERT_NE(it, frozen.end());
+        EXPECT_EQ(it->first, key);
+        EXPECT_EQ(it->second, key * 2);
+        EXPECT_EQ(frozen[key], key * 2);
+    }
+
+    EXPECT_EQ(frozen.find(-1), frozen.end());
+    EXPECT_FALSE(frozen.isExist(-1));
+    EXPECT_ANY_THROW(frozen[-1]);
+}
+
+TYPED_TEST(FrozenTreeTest, IteratesInOrder) {
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back(i * 3);
+    }
+
+    std::mt19937 gen(42);
+    std::shuffle(keys.begin(), keys.end(), gen);
+
+    for (int key : keys) {
+        this->tree.insert(key, key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    auto frozen = this->tree.freeze();
+
+    size_t p = 0;
+    for (auto [key, value] : frozen) {
+        ASSERT_LT(p, keys.size());
+        EXPECT_EQ(key, keys[p]);
+        EXPECT_EQ(value, keys[p++]);
+    }
+    EXPECT_EQ(p, keys.size());
+}
+
+TYPED_TEST(FrozenTreeTest, BoundsMatchTheTree) {
+    for (int i = 0; i < 500; i++) {
+        this->tree.insert(i * 2, i);
+    }
+
+    auto frozen = this->tree.freeze();
+
+    for (int key = -1; key <= 1000; key++) {
+        auto tree_lower = this->tree.lowerBound(key);
+        auto frozen_lower = frozen.lowerBound(key);
+        if (tree_lower == this->tree.end()) {
+            EXPECT_EQ(frozen_lower, frozen.end());
+        }
+        else {
+            ASSERT_NE(frozen_lower, frozen.end());
+            EXPECT_EQ(frozen_lower->first, tree_lower->first);
+        }
+
+        auto tree_upper = this->tree.upperBound(key);
+        auto frozen_upper = frozen.upperBound(key);
+        if (tree_upper == this->tree.end()) {
+            EXPECT_EQ(frozen_upper, frozen.end());
+        }
+        else {
+            ASSERT_NE(frozen_upper, frozen.end());
+            EXPECT_EQ(frozen_upper->first, tree_upper->first);
+        }
+    }
+}
+
+TYPED_TEST(FrozenTreeTest, IsIndependentOfTheTree) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, i);
+    }
+
+    auto frozen = this->tree.freeze();
+
+    this->tree.erase(50);
+    this->tree.insert(1000, 1000);
+
+    EXPECT_TRUE(frozen.isExist(50));
+    EXPECT_FALSE(frozen.isExist(1000));
+    EXPECT_EQ(frozen.size(), 100U);
+}
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.hpp"
+#include "HashIndexedTree.hpp"
+
+template <typename TreeType>
+class HashIndexedTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using HashIndexedImplementations = ::testing::Types<HashIndexedTree<int, int>,
+                                                    HashIndexedTree<int, int, AVLTree<int, int>>>;
+
+TYPED_TEST_SUITE(HashIndexedTreeTest, HashIndexedImplementations);
+
+TYPED_TEST(HashIndexedTreeTest, MatchesStdMap) {
+    std::map<int, int> expected;
+    std::mt19937 gen(39);
+
+    for (int step = 0; step < 50000; step++) {
+        int key = static_cast<int>(gen() % 2000);
+        switch (gen() % 3) {
+        case 0:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 1:
+            if (expected.erase(key) > 0) {
+                this->tree.erase(key);
+            }
+            else {
+                EXPECT_THROW(this->tree.erase(key), std::out_of_range);
+            }
+            break;
+        default: {
+            auto it = this->tree.find(key);
+            auto expected_it = expected.find(key);
+            ASSERT_EQ(it == this->tree.end(), expected_it == expected.end());
+            if (it != this->tree.end()) {
+                EXPECT_EQ((*it).first, key);
+                EXPECT_EQ((*it).second, expected_it->second);
+                EXPECT_EQ(this->tree[key], expected_it->second);
+            }
+            else {
+                EXPECT_THROW(this->tree[key], std::runtime_error);
+            }
+            EXPECT_EQ(this->tree.isExist(key), expected_it != expected.end());
+        }
+        }
+    }
+
+    EXPECT_EQ(this->tree.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto [key, value] : this->tree) {
+        EXPECT_EQ(key, expected_it->first);
+        EXPECT_EQ(value, expected_it->second);
+        ++expected_it;
+    }
+}
+
+TYPED_TEST(HashIndexedTreeTest, FindsKeysMovedByErase) {
+    for (int i = 0; i < 4096; i++) {
+        this->tree.insert(i, i * 2);
+    }
+    // Inner nodes are erased first, so their successors move into their positions.
+    for (int i = 0; i < 4096; i += 3) {
+        auto it = this->tree.erase(this->tree.find(i));
+        if (i + 1 < 4096) {
+            ASSERT_NE(it, this->tree.end());
+            EXPECT_EQ((*it).first, i + 1);
+        }
+        for (int j = i + 1; j < std::min(i + 64, 4096); j++) {
+            if (j % 3 != 0) {
+                auto found = this->tree.find(j);
+                ASSERT_NE(found, this->tree.end());
+                ASSERT_EQ((*found).first, j);
+            }
+        }
+    }
+    for (int i = 0; i < 4096; i++) {
+        EXPECT_EQ(this->tree.isExist(i), i % 3 != 0);
+        if (i % 3 != 0) {
+            EXPECT_EQ(this->tree[i], i * 2);
+        }
+    }
+}
+
+TYPED_TEST(HashIndexedTreeTest, ClearResetsIndex) {
+    for (int i = 0; i < 1000; i++) {
+        this->tree.insert(i, i);
+    }
+    this->tree.clear();
+    EXPECT_FALSE(this->tree.isExist(5));
+    EXPECT_EQ(this->tree.find(5), this->tree.end());
+
+    this->tree.insert(5, 50);
+    EXPECT_EQ(this->tree[5], 50);
+    EXPECT_EQ(this->tree.size(), 1U);
+}
+
+// Checks that every element of the tree is found through the index at its own position
+// and that the index knows no other key of [0, max_key).
+template <typename TreeType>
+void expectIndexMatchesTree(const TreeType& tree, const std::map<int, int>& expected, int max_key) {
+    ASSERT_EQ(tree.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ((*it).first, expected_it->first);
+        ASSERT_EQ((*it).second, expected_it->second);
+        ASSERT_EQ(tree.find((*it).first), it);
+        ++expected_it;
+    }
+    for (int key = 0; key < max_key; key++) {
+        ASSERT_EQ(tree.isExist(key), expected.contains(key)) << key;
+    }
+}
+
+TYPED_TEST(HashIndexedTreeTest, EveryMutatorKeepsIndexInSync) {
+    constexpr int MAX_KEY = 3000;
+    std::map<int, int> expected;
+    std::mt19937 gen(390);
+    auto fill = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            int key = static_cast<int>(gen() % MAX_KEY);
+            this->tree.insert(key, key * 3);
+            expected.insert({ key, key * 3 });
+        }
+    };
+    fill(2000);
+    expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+
+    for (int i = 0; i < 100; i++) {
+        auto [min_key, min_value] = this->tree.popMin();
+        EXPECT_EQ(min_key, expected.begin()->first);
+        expected.erase(expected.begin());
+        auto [max_key, max_value] = this->tree.popMax();
+        EXPECT_EQ(max_key, expected.rbegin()->first);
+        expected.erase(std::prev(expected.end()));
+    }
+    expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+
+    // A small batch goes through the index, a large one rebuilds it.
+    for (size_t batch_size : { 10U, 3000U }) {
+        std::vector<BatchOperation<int, int>> batch;
+        for (size_t i = 0; i < batch_size; i++) {
+            int key = static_cast<int>(gen() % MAX_KEY);
+            auto type = gen() % 2 == 0 ? BatchOperation<int, int>::Type::UPSERT : BatchOperation<int, int>::Type::ERASE;
+            batch.push_back({ type, key, key * 5 });
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.key < rhs.key;
+        });
+        this->tree.applyBatch(batch);
+        for (const auto& operation : batch) {
+            if (operation.type == BatchOperation<int, int>::Type::UPSERT) {
+                expected[operation.key] = operation.value;
+            }
+            else {
+                expected.erase(operation.key);
+            }
+        }
+        expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+    }
+
+    // Erasing every fiftieth element erases node by node, erasing every other one rebuilds the tree.
+    for (int divisor : { 50, 2 }) {
+        fill(500);
+        auto isErased = [divisor](int key, int) {
+            return key % divisor == 0;
+        };
+        EXPECT_EQ(this->tree.eraseIf(isErased), std::erase_if(expected, [&](const auto& element) {
+            return isErased(element.first, element.second);
+        }));
+        expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+    }
+
+    for (auto [low, high] : { std::pair{ 1000, 1030 }, std::pair{ 500, 2500 } }) {
+        fill(500);
+        auto it = this->tree.eraseRange(this->tree.lowerBound(low), this->tree.lowerBound(high));
+        expected.erase(expected.lower_bound(low), expected.lower_bound(high));
+        auto expected_it = expected.lower_bound(high);
+        ASSERT_EQ(it == this->tree.end(), expected_it == expected.end());
+        if (it != this->tree.end()) {
+            EXPECT_EQ((*it).first, expected_it->first);
+        }
+        expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+    }
+
+    fill(500);
+    for (int i = 0; i < 200; i++) {
+        int key = expected.begin()->first + static_cast<int>(gen() % 50);
+        if (!expected.contains(key)) {
+            EXPECT_THROW(this->tree.extract(key), std::out_of_range);
+            continue;
+        }
+        auto handle = this->tree.extract(key);
+        EXPECT_EQ(handle.getKey(), key);
+        EXPECT_EQ(handle.getValue(), expected[key]);
+        expected.erase(key);
+        if (i % 2 == 0) {
+            handle.getValue() = -key;
+            this->tree.insert(std::move(handle));
+            expected[key] = -key;
+        }
+    }
+    expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+
+    TypeParam other;
+    std::map<int, int> other_expected;
+    for (int key = 0; key < MAX_KEY; key += 7) {
+        other.insert(key, key);
+        if (!expected.insert({ key, key }).second) {
+            other_expected.insert({ key, key });
+        }
+    }
+    this->tree.merge(other);
+    expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+    expectIndexMatchesTree(other, other_expected, MAX_KEY);
+
+    std::vector<std::pair<int, int>> elements;
+    expected.clear();
+    for (int i = 0; i < 1000; i++) {
+        int key = static_cast<int>(gen() % MAX_KEY);
+        elements.emplace_back(key, i);
+        expected.insert({ key, i });
+    }
+    this->tree.buildParallel(elements, 2);
+    expectIndexMatchesTree(this->tree, expected, MAX_KEY);
+}
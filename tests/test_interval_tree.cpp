@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "TestableIntervalTree.hpp"
+
+class IntervalTreeTest : public ::testing::Test {
+protected:
+    TestableIntervalTree<int, int> tree;
+    std::map<Interval<int>, int> expected;
+
+    std::vector<std::pair<Interval<int>, int>> scan(int low, int high) const {
+        std::vector<std::pair<Interval<int>, int>> result;
+        for (const auto& [interval, value] : expected) {
+            if (interval.low <= high && low <= interval.high) {
+                result.emplace_back(interval, value);
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(IntervalTreeTest, PointAndRangeQueries) {
+    EXPECT_TRUE(tree.insert({ 1, 5 }, 10));
+    EXPECT_TRUE(tree.insert({ 3, 3 }, 20));
+    EXPECT_TRUE(tree.insert({ 6, 9 }, 30));
+    EXPECT_FALSE(tree.insert({ 1, 5 }, 40));
+    EXPECT_THROW(tree.insert({ 4, 2 }, 50), std::invalid_argument);
+    EXPECT_EQ(tree.size(), 3U);
+    EXPECT_EQ((tree[Interval<int>{ 1, 5 }]), 10);
+
+    using Result = std::vector<std::pair<Interval<int>, int>>;
+    EXPECT_EQ(tree.overlapping(3), (Result{ { { 1, 5 }, 10 }, { { 3, 3 }, 20 } }));
+    // Both ends of an interval belong to it.
+    EXPECT_EQ(tree.overlapping(5), (Result{ { { 1, 5 }, 10 } }));
+    EXPECT_EQ(tree.overlapping(6), (Result{ { { 6, 9 }, 30 } }));
+    EXPECT_TRUE(tree.overlapping(10).empty());
+    EXPECT_EQ(tree.overlapping(4, 6).size(), 2U);
+    EXPECT_EQ(tree.overlapping(0, 100).size(), 3U);
+
+    int sum = 0;
+    tree.forEachOverlapping(2, 7, [&sum](const Interval<int>&, const int& value) {
+        sum += value;
+    });
+    EXPECT_EQ(sum, 60);
+
+    tree.erase({ 1, 5 });
+    EXPECT_THROW(tree.erase({ 1, 5 }), std::out_of_range);
+    EXPECT_EQ(tree.overlapping(3), (Result{ { { 3, 3 }, 20 } }));
+    EXPECT_TRUE(tree.isTreeCorrect());
+}
+
+TEST_F(IntervalTreeTest, MatchesLinearScan) {
+    std::mt19937 gen(48);
+    for (int step = 0; step < 20000; step++) {
+        int low = static_cast<int>(gen() % 10000);
+        Interval<int> interval{ low, low + static_cast<int>(gen() % (gen() % 8 == 0 ? 2000 : 50)) };
+        if (gen() % 3 == 0 && !expected.empty()) {
+            auto it = expected.lower_bound(interval);
+            if (it == expected.end()) {
+                it = expected.begin();
+            }
+            tree.erase(it->first);
+            expected.erase(it);
+        }
+        else {
+            EXPECT_EQ(tree.insert(interval, step), expected.insert({ interval, step }).second);
+        }
+
+        if (step % 500 == 0) {
+            ASSERT_TRUE(tree.isTreeCorrect());
+            ASSERT_EQ(tree.size(), expected.size());
+            for (int query = 0; query < 50; query++) {
+                int from = static_cast<int>(gen() % 12000);
+                int to = from + static_cast<int>(gen() % 100);
+                ASSERT_EQ(tree.overlapping(from), scan(from, from));
+                ASSERT_EQ(tree.overlapping(from, to), scan(from, to));
+            }
+        }
+    }
+    ASSERT_TRUE(tree.isTreeCorrect());
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.overlapping(0, 20000).empty());
+}
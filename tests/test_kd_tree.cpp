@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "TestableKdTree.hpp"
+
+template <typename TreeType>
+class KdTreeTest : public ::testing::Test {
+protected:
+    using Point = typename TreeType::Point;
+
+    TreeType tree;
+    std::map<Point, int> expected;
+
+    Point makePoint(std::mt19937& gen, int range) const {
+        Point point;
+        for (auto& coordinate : point) {
+            coordinate = static_cast<int>(gen() % range);
+        }
+        return point;
+    }
+
+    std::vector<std::pair<Point, int>> scan(const Point& low, const Point& high) const {
+        std::vector<std::pair<Point, int>> result;
+        for (const auto& [point, value] : expected) {
+            bool is_inside = true;
+            for (size_t i = 0; i < point.size(); ++i) {
+                is_inside = is_inside && low[i] <= point[i] && point[i] <= high[i];
+            }
+            if (is_inside) {
+                result.emplace_back(point, value);
+            }
+        }
+        return result;
+    }
+
+    static long long getSquaredDistance(const Point& lhs, const Point& rhs) {
+        long long result = 0;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            result += static_cast<long long>(lhs[i] - rhs[i]) * (lhs[i] - rhs[i]);
+        }
+        return result;
+    }
+
+    void check(std::mt19937& gen, int range) {
+        ASSERT_TRUE(this->tree.isTreeCorrect());
+        ASSERT_EQ(this->tree.size(), expected.size());
+        for (int query = 0; query < 20; query++) {
+            Point low = makePoint(gen, range);
+            Point high = low;
+            for (auto& coordinate : high) {
+                coordinate += static_cast<int>(gen() % (range / 4));
+            }
+            auto result = this->tree.inRange(low, high);
+            std::sort(result.begin(), result.end());
+            ASSERT_EQ(result, scan(low, high));
+
+            Point center = makePoint(gen, range);
+            size_t k = gen() % 10;
+            auto nearest = this->tree.nearest(center, k);
+            ASSERT_EQ(nearest.size(), std::min(k, expected.size()));
+            std::vector<long long> distances;
+            for (const auto& [point, value] : expected) {
+                distances.push_back(getSquaredDistance(point, center));
+            }
+            std::sort(distances.begin(), distances.end());
+            for (size_t i = 0; i < nearest.size(); ++i) {
+                // Ties may be broken either way, so the distances are compared.
+                ASSERT_EQ(getSquaredDistance(nearest[i].first, center), distances[i]);
+                ASSERT_EQ(nearest[i].second, expected.at(nearest[i].first));
+            }
+        }
+    }
+};
+
+using KdTreeImplementations = ::testing::Types<TestableKdTree<int, 2, int>, TestableKdTree<int, 3, int>>;
+
+TYPED_TEST_SUITE(KdTreeTest, KdTreeImplementations);
+
+TYPED_TEST(KdTreeTest, InsertEraseAndQueries) {
+    std::mt19937 gen(49);
+    // A small range makes equal coordinates, which a split tells apart by the next coordinates.
+    for (int range : { 16, 1000 }) {
+        this->tree.clear();
+        this->expected.clear();
+        for (int step = 0; step < 6000; step++) {
+            auto point = this->makePoint(gen, range);
+            if (gen() % 3 == 0) {
+                if (this->expected.erase(point) != 0U) {
+                    this->tree.erase(point);
+                }
+                else {
+                    EXPECT_THROW(this->tree.erase(point), std::out_of_range);
+                }
+            }
+            else {
+                EXPECT_EQ(this->tree.insert(point, step), this->expected.insert({ point, step }).second);
+            }
+            if (step % 1000 == 0) {
+                this->check(gen, range);
+            }
+        }
+        this->check(gen, range);
+
+        for (const auto& [point, value] : this->expected) {
+            ASSERT_TRUE(this->tree.isExist(point));
+            ASSERT_EQ(this->tree[point], value);
+        }
+    }
+}
+
+TYPED_TEST(KdTreeTest, BulkBuild) {
+    using Point = typename TypeParam::Point;
+    std::mt19937 gen(50);
+    std::vector<std::pair<Point, int>> elements;
+    for (int i = 0; i < 5000; i++) {
+        auto point = this->makePoint(gen, 300);
+        elements.emplace_back(point, i);
+        this->expected.insert({ point, i });
+    }
+    this->tree = TypeParam(elements);
+    this->check(gen, 300);
+
+    // Erasing most points rebuilds the tree without the tombstones.
+    for (auto it = this->expected.begin(); it != this->expected.end();) {
+        if (gen() % 4 != 0) {
+            this->tree.erase(it->first);
+            it = this->expected.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    this->check(gen, 300);
+
+    Point missing;
+    missing.fill(-1);
+    EXPECT_THROW(this->tree[missing], std::runtime_error);
+}
+
+TYPED_TEST(KdTreeTest, RepeatedCoordinatesStayBalanced) {
+    using Point = typename TypeParam::Point;
+    std::mt19937 gen(4949);
+    // The first coordinate takes only four values, so most splits by it meet equal coordinates.
+    constexpr int COUNT = 20000;
+    for (int i = 0; i < COUNT; i++) {
+        Point point;
+        point.fill(i);
+        point[0] = i % 4;
+        ASSERT_TRUE(this->tree.insert(point, i));
+        this->expected.insert({ point, i });
+    }
+    this->check(gen, COUNT);
+    // A scapegoat tree with 3/4 balance is at most log_{4/3}(n) + 1 deep, which is 36 here.
+    EXPECT_LE(this->tree.getHeight(), 36U);
+
+    for (int i = 0; i < COUNT; i += 2) {
+        Point point;
+        point.fill(i);
+        point[0] = i % 4;
+        this->tree.erase(point);
+        this->expected.erase(point);
+    }
+    this->check(gen, COUNT);
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+#include "MappedJournal.hpp"
+#include "MappedVector.hpp"
+
+template <typename TreeType>
+class FileBackedTreeTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = (std::filesystem::temp_directory_path() /
+                (std::string("file_backed_") + info->type_param() + "_" + info->name() + ".bin")).string();
+        for (char& c : path) {
+            if (c == '<' || c == '>' || c == ',' || c == ' ' || c == ':') {
+                c = '_';
+            }
+        }
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        std::remove(path.c_str());
+        std::remove((path + ".free").c_str());
+        std::remove((path + ".journal").c_str());
+    }
+};
+
+using FileBackedTreeImplementations = ::testing::Types<AVLTree<int, int, MappedVector>,
+                                                       RedBlackTree<int, int, MappedVector>>;
+
+TYPED_TEST_SUITE(FileBackedTreeTest, FileBackedTreeImplementations);
+
+TYPED_TEST(FileBackedTreeTest, ReopenedTreeKeepsFlushedState) {
+    std::map<int, int> expected;
+    std::mt19937 gen(21);
+    {
+        TypeParam tree(this->path);
+        EXPECT_TRUE(tree.empty());
+        for (int step = 0; step < 20000; step++) {
+            int key = static_cast<int>(gen() % 5000);
+            if (gen() % 3 == 0) {
+                if (expected.erase(key) > 0) {
+                    tree.erase(key);
+                }
+            }
+            else {
+                tree.insert(key, key * 7);
+                expected.insert({ key, key * 7 });
+            }
+        }
+        tree.flush();
+    }
+
+    TypeParam tree(this->path);
+    ASSERT_EQ(tree.size(), expected.size());
+    auto it = expected.begin();
+    for (auto [key, value] : tree) {
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(value, it->second);
+        ++it;
+    }
+
+    // The reopened tree keeps working, including reuse of freed slots.
+    for (int key = 0; key < 5000; key++) {
+        tree.insert(key, expected.contains(key) ? key * 7 : -key);
+    }
+    EXPECT_EQ(tree.size(), 5000U);
+    for (int key = 0; key < 5000; key++) {
+        EXPECT_EQ(tree[key], expected.contains(key) ? key * 7 : -key);
+    }
+}
+
+TYPED_TEST(FileBackedTreeTest, ReopenedTreeDropsChangesAfterFlush) {
+    {
+        TypeParam tree(this->path);
+        for (int key = 0; key < 3000; key++) {
+            tree.insert(key, key);
+        }
+        tree.flush();
+
+        // Closing without a flush stands for a crash: neither file may see these changes.
+        for (int key = 0; key < 3000; key += 2) {
+            tree.erase(key);
+        }
+        for (int key = 3000; key < 20000; key++) {
+            tree.insert(key, -key);
+        }
+    }
+
+    TypeParam tree(this->path);
+    ASSERT_EQ(tree.size(), 3000U);
+    int expected_key = 0;
+    for (auto [key, value] : tree) {
+        EXPECT_EQ(key, expected_key);
+        EXPECT_EQ(value, expected_key);
+        ++expected_key;
+    }
+    tree.insert(5000, 5);
+    EXPECT_EQ(tree.size(), 3001U);
+}
+
+// Stops a flush right after the journal is committed, as a crash before the files are written would.
+template <typename T>
+class CrashingMappedVector : public MappedVector<T> {
+public:
+    using MappedVector<T>::MappedVector;
+
+    void commitJournalOnly() {
+        MappedJournal journal(this->path + ".journal");
+        this->addToJournal(journal);
+        journal.commit();
+    }
+};
+
+class MappedVectorJournalTest : public ::testing::Test {
+protected:
+    std::string path = (std::filesystem::temp_directory_path() / "mapped_vector_journal.bin").string();
+
+    void SetUp() override {
+        TearDown();
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove((path + ".journal").c_str());
+    }
+
+    void fill(MappedVector<int>& vector, int count, int shift) {
+        vector.clear();
+        for (int i = 0; i < count; i++) {
+            vector.push_back(i + shift);
+        }
+    }
+
+    void expectContents(int count, int shift) {
+        MappedVector<int> vector(path);
+        ASSERT_EQ(vector.size(), static_cast<size_t>(count));
+        for (int i = 0; i < count; i++) {
+            ASSERT_EQ(vector[i], i + shift);
+        }
+    }
+};
+
+TEST_F(MappedVectorJournalTest, CommittedJournalIsReplayedOnOpen) {
+    {
+        CrashingMappedVector<int> vector(path);
+        fill(vector, 1000, 0);
+        vector.flush();
+        fill(vector, 50000, 7);
+        vector.commitJournalOnly();
+    }
+    expectContents(50000, 7);
+    EXPECT_EQ(std::filesystem::file_size(path + ".journal"), 0U);
+}
+
+TEST_F(MappedVectorJournalTest, TornJournalIsDropped) {
+    {
+        CrashingMappedVector<int> vector(path);
+        fill(vector, 1000, 0);
+        vector.flush();
+        fill(vector, 50000, 7);
+        vector.commitJournalOnly();
+    }
+    // The last bytes of the journal never reached the disk.
+    std::filesystem::resize_file(path + ".journal", std::filesystem::file_size(path + ".journal") - 1U);
+    expectContents(1000, 0);
+}
+
+TEST(MappedVectorTest, RejectsFileOfAnotherElementType) {
+    std::string path = (std::filesystem::temp_directory_path() / "mapped_vector_type_check.bin").string();
+    std::remove(path.c_str());
+    {
+        MappedVector<int> vector(path);
+        for (int i = 0; i < 100000; i++) {
+            vector.push_back(i);
+        }
+        vector.flush();
+    }
+    {
+        MappedVector<int> vector(path);
+        ASSERT_EQ(vector.size(), 100000U);
+        EXPECT_EQ(vector[12345], 12345);
+        EXPECT_EQ(vector.back(), 99999);
+    }
+    EXPECT_THROW(MappedVector<long long> vector(path), std::runtime_error);
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+}
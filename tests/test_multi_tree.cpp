@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "AVLTree.hpp"
+#include "MultiTree.hpp"
+
+template <typename TreeType>
+class MultiTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using MultiTreeImplementations = ::testing::Types<MultiTree<int, int>,
+                                                  MultiTree<int, int, AVLTree<int, int>>>;
+
+TYPED_TEST_SUITE(MultiTreeTest, MultiTreeImplementations);
+
+TYPED_TEST(MultiTreeTest, KeepsInsertionOrderOfEqualKeys) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i % 5, i);
+    }
+    EXPECT_EQ(this->tree.size(), 100U);
+    EXPECT_EQ(this->tree.count(3), 20U);
+    EXPECT_EQ(this->tree.count(7), 0U);
+    EXPECT_EQ(this->tree[3], 3);
+
+    auto [first, last] = this->tree.equalRange(3);
+    int expected_value = 3;
+    for (auto it = first; it != last; ++it) {
+        EXPECT_EQ((*it).first, 3);
+        EXPECT_EQ((*it).second, expected_value);
+        expected_value += 5;
+    }
+    EXPECT_EQ(expected_value, 103);
+
+    EXPECT_EQ(this->tree.erase(3), 20U);
+    EXPECT_FALSE(this->tree.isExist(3));
+    EXPECT_THROW(this->tree.erase(3), std::out_of_range);
+    EXPECT_EQ(this->tree.size(), 80U);
+}
+
+TYPED_TEST(MultiTreeTest, MatchesStdMultimap) {
+    std::multimap<int, int> expected;
+    std::mt19937 gen(41);
+
+    for (int step = 0; step < 30000; step++) {
+        int key = static_cast<int>(gen() % 300);
+        switch (gen() % 5) {
+        case 0:
+        case 1:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 2: {
+            // Erases one element from the middle of the run of equal keys.
+            auto [first, last] = this->tree.equalRange(key);
+            auto [expected_first, expected_last] = expected.equal_range(key);
+            size_t count = std::distance(expected_first, expected_last);
+            ASSERT_EQ(this->tree.count(key), count);
+            if (count > 0U) {
+                for (size_t i = 0; i < count / 2; ++i) {
+                    ++first;
+                    ++expected_first;
+                }
+                auto next = this->tree.erase(first);
+                auto expected_next = expected.erase(expected_first);
+                ASSERT_EQ(next == this->tree.end(), expected_next == expected.end());
+                if (expected_next != expected.end()) {
+                    EXPECT_EQ((*next).first, expected_next->first);
+                    EXPECT_EQ((*next).second, expected_next->second);
+                }
+            }
+            break;
+        }
+        case 3:
+            if (expected.count(key) > 0U) {
+                EXPECT_EQ(this->tree.erase(key), expected.erase(key));
+            }
+            break;
+        default: {
+            auto it = this->tree.find(key);
+            auto expected_it = expected.find(key);
+            ASSERT_EQ(it == this->tree.end(), expected_it == expected.end());
+            if (it != this->tree.end()) {
+                EXPECT_EQ((*it).second, expected.lower_bound(key)->second);
+            }
+        }
+        }
+    }
+
+    EXPECT_EQ(this->tree.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto [key, value] : this->tree) {
+        EXPECT_EQ(key, expected_it->first);
+        EXPECT_EQ(value, expected_it->second);
+        ++expected_it;
+    }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class NodeHandleTest : public ::testing::Test {
+protected:
+    TreeType first;
+    TreeType second;
+
+    // Move-only values: any copy of a payload would not compile.
+    void insert(TreeType& tree, int key) {
+        tree.insert(NodeHandle<int, std::unique_ptr<int>>(key, std::make_unique<int>(key * 10)));
+    }
+
+    void expectTree(TreeType& tree, const std::map<int, int>& expected) {
+        ASSERT_EQ(tree.size(), expected.size());
+        auto expected_it = expected.begin();
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            EXPECT_EQ((*it).first, expected_it->first);
+            EXPECT_EQ(*(*it).second, expected_it->second);
+            ++expected_it;
+        }
+    }
+};
+
+using NodeHandleImplementations = ::testing::Types<AVLTree<int, std::unique_ptr<int>>,
+                                                   RedBlackTree<int, std::unique_ptr<int>>>;
+
+TYPED_TEST_SUITE(NodeHandleTest, NodeHandleImplementations);
+
+TYPED_TEST(NodeHandleTest, ExtractAndReinsert) {
+    for (int i = 0; i < 100; i++) {
+        this->insert(this->first, i);
+    }
+    int* payload = (*this->first.find(42)).second.get();
+
+    auto handle = this->first.extract(42);
+    ASSERT_FALSE(handle.empty());
+    EXPECT_EQ(handle.getKey(), 42);
+    EXPECT_EQ(handle.getValue().get(), payload);
+    EXPECT_FALSE(this->first.isExist(42));
+    EXPECT_EQ(this->first.size(), 99U);
+    EXPECT_THROW(this->first.extract(42), std::out_of_range);
+
+    auto it = this->second.insert(std::move(handle));
+    EXPECT_TRUE(handle.empty());
+    EXPECT_EQ((*it).first, 42);
+    EXPECT_EQ((*it).second.get(), payload);
+
+    // A conflicting key leaves the element in the handle.
+    this->insert(this->first, 1000);
+    auto conflicting = this->first.extract(this->first.find(1000));
+    this->insert(this->second, 1000);
+    this->second.insert(std::move(conflicting));
+    EXPECT_FALSE(conflicting.empty());
+    EXPECT_EQ(*conflicting.getValue(), 10000);
+}
+
+TYPED_TEST(NodeHandleTest, ExtractMatchesStdMap) {
+    std::map<int, int> expected_first;
+    std::map<int, int> expected_second;
+    std::mt19937 gen(44);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 500);
+        if (gen() % 2 == 0) {
+            if (expected_first.count(key) == 0U) {
+                this->insert(this->first, key);
+                expected_first[key] = key * 10;
+            }
+        }
+        else if (expected_first.count(key) > 0U) {
+            auto handle = this->first.extract(key);
+            this->second.insert(std::move(handle));
+            expected_second.insert(expected_first.extract(key));
+        }
+    }
+    this->expectTree(this->first, expected_first);
+    this->expectTree(this->second, expected_second);
+}
+
+TYPED_TEST(NodeHandleTest, MergeMovesNonConflictingElements) {
+    std::map<int, int> expected_first;
+    std::map<int, int> expected_second;
+    for (int i = 0; i < 3000; i++) {
+        if (i % 2 == 0) {
+            this->insert(this->first, i);
+            expected_first[i] = i * 10;
+        }
+        if (i % 3 == 0) {
+            this->insert(this->second, i);
+            expected_second[i] = i * 10;
+        }
+    }
+
+    this->first.merge(this->second);
+    expected_first.merge(expected_second);
+
+    this->expectTree(this->first, expected_first);
+    this->expectTree(this->second, expected_second);
+    EXPECT_EQ(this->second.size(), 500U);
+}
+
+TYPED_TEST(NodeHandleTest, MovedFromHandleIsEmpty) {
+    this->insert(this->first, 1);
+    this->insert(this->first, 2);
+    auto handle = this->first.extract(1);
+    int* payload = handle.getValue().get();
+
+    auto moved(std::move(handle));
+    EXPECT_TRUE(handle.empty());
+    EXPECT_FALSE(static_cast<bool>(handle));
+    EXPECT_THROW(handle.getKey(), std::out_of_range);
+    ASSERT_FALSE(moved.empty());
+    EXPECT_EQ(moved.getKey(), 1);
+    EXPECT_EQ(moved.getValue().get(), payload);
+
+    // Assigning over a full handle drops its old element.
+    auto assigned = this->first.extract(2);
+    assigned = std::move(moved);
+    EXPECT_TRUE(moved.empty());
+    ASSERT_FALSE(assigned.empty());
+    EXPECT_EQ(assigned.getKey(), 1);
+    EXPECT_EQ(assigned.getValue().get(), payload);
+
+    // An empty moved-from handle inserts nothing.
+    EXPECT_EQ(this->second.insert(std::move(moved)), this->second.end());
+    EXPECT_TRUE(this->second.empty());
+}
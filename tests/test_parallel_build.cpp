@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "TestableAVLTree.hpp"
+#include "TestableRedBlackTree.hpp"
+
+template <typename TreeType>
+class ParallelBuildTest : public ::testing::Test {
+protected:
+    TreeType tree;
+
+    void check(const std::map<int, int>& expected) {
+        ASSERT_TRUE(this->tree.isTreeCorrect());
+        ASSERT_EQ(this->tree.size(), expected.size());
+        auto expected_it = expected.begin();
+        for (auto [key, value] : this->tree) {
+            ASSERT_EQ(key, expected_it->first);
+            ASSERT_EQ(value, expected_it->second);
+            ++expected_it;
+        }
+    }
+};
+
+using ParallelBuildImplementations = ::testing::Types<TestableAVLTree<int, int>, TestableRedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(ParallelBuildTest, ParallelBuildImplementations);
+
+TYPED_TEST(ParallelBuildTest, MatchesInsertion) {
+    std::mt19937 gen(50);
+    for (size_t count : { 0, 1, 2, 5, 100, 20000 }) {
+        // Many duplicates, some of them crossing the parts sorted by different threads.
+        std::vector<std::pair<int, int>> elements;
+        std::map<int, int> expected;
+        for (size_t i = 0; i < count; i++) {
+            int key = static_cast<int>(gen() % (count / 2 + 1));
+            elements.emplace_back(key, static_cast<int>(i));
+            expected.insert({ key, static_cast<int>(i) });
+        }
+        for (size_t count_of_threads : { 1, 2, 3, 4, 7 }) {
+            this->tree.buildParallel(elements, count_of_threads);
+            this->check(expected);
+        }
+    }
+}
+
+TYPED_TEST(ParallelBuildTest, TreeStaysUsable) {
+    std::vector<std::pair<int, int>> elements;
+    for (int i = 9999; i >= 0; i--) {
+        elements.emplace_back(i * 2, i);
+    }
+    this->tree.insert(-5, -5);
+    this->tree.buildParallel(elements, 4);
+    EXPECT_FALSE(this->tree.isExist(-5));
+
+    std::map<int, int> expected;
+    for (int i = 0; i < 10000; i++) {
+        expected[i * 2] = i;
+    }
+    for (int i = 0; i < 5000; i++) {
+        this->tree.insert(i * 4 + 1, -i);
+        expected[i * 4 + 1] = -i;
+        this->tree.erase(i * 4);
+        expected.erase(i * 4);
+    }
+    this->check(expected);
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "TestablePersistentAVLTree.hpp"
+
+using Tree = TestablePersistentAVLTree<int, int>;
+
+static std::vector<std::pair<int, int>> getElements(const Tree& tree) {
+    std::vector<std::pair<int, int>> elements;
+    for (auto [key, value] : tree) {
+        elements.push_back({ key, value });
+    }
+    return elements;
+}
+
+TEST(PersistentAVLTreeTest, MatchesStdMap) {
+    Tree tree;
+    std::map<int, int> expected;
+    std::mt19937 gen(9);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 1000);
+        switch (gen() % 4) {
+        case 0:
+            tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 1:
+            tree.assign(key, step);
+            expected[key] = step;
+            break;
+        case 2:
+            if (expected.erase(key) > 0) {
+                tree.erase(key);
+            }
+            else {
+                EXPECT_THROW(tree.erase(key), std::out_of_range);
+            }
+            break;
+        default: {
+            auto it = tree.lowerBound(key);
+            auto expected_it = expected.lower_bound(key);
+            ASSERT_EQ(it == tree.end(), expected_it == expected.end());
+            if (it != tree.end()) {
+                EXPECT_EQ(it->first, expected_it->first);
+                EXPECT_EQ(it->second, expected_it->second);
+            }
+            EXPECT_EQ(tree.isExist(key), expected.contains(key));
+        }
+        }
+    }
+
+    ASSERT_TRUE(tree.isTreeCorrect());
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(getElements(tree), expected_elements);
+}
+
+TEST(PersistentAVLTreeTest, SnapshotsAreNotAffectedByUpdates) {
+    Tree tree;
+    std::map<int, int> expected;
+    std::vector<Tree> snapshots;
+    std::vector<std::map<int, int>> expected_snapshots;
+    std::mt19937 gen(10);
+
+    for (int step = 0; step < 5000; step++) {
+        int key = static_cast<int>(gen() % 300);
+        if (gen() % 3 != 0) {
+            tree.assign(key, step);
+            expected[key] = step;
+        }
+        else if (expected.erase(key) > 0) {
+            tree.erase(key);
+        }
+        if (step % 500 == 0) {
+            snapshots.push_back(tree.snapshot());
+            expected_snapshots.push_back(expected);
+        }
+    }
+
+    for (size_t i = 0; i < snapshots.size(); i++) {
+        EXPECT_TRUE(snapshots[i].isTreeCorrect());
+        std::vector<std::pair<int, int>> expected_elements(expected_snapshots[i].begin(),
+                                                           expected_snapshots[i].end());
+        EXPECT_EQ(getElements(snapshots[i]), expected_elements);
+    }
+
+    // A snapshot can be updated without affecting its origin.
+    Tree copy = tree.snapshot();
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(tree.size(), expected.size());
+}
+
+TEST(PersistentAVLTreeTest, DroppedVersionsReturnNodesToThePool) {
+    Tree tree;
+    for (int i = 0; i < 1000; i++) {
+        tree.insert(i, i);
+    }
+    {
+        std::vector<Tree> snapshots;
+        for (int i = 0; i < 1000; i++) {
+            snapshots.push_back(tree.snapshot());
+            tree.erase(i);
+            tree.insert(i, -i);
+        }
+        EXPECT_GT(tree.getCountOfUsedNodes(), 2000U);
+    }
+    EXPECT_EQ(tree.getCountOfUsedNodes(), tree.size());
+
+    tree.clear();
+    EXPECT_EQ(tree.getCountOfUsedNodes(), 0U);
+}
+
+TEST(PersistentAVLTreeTest, SnapshotsCanBeReadWhileTheTreeChanges) {
+    const int KEY_RANGE = 2000;
+
+    Tree tree;
+    for (int key = 0; key < KEY_RANGE; key++) {
+        tree.insert(key, key);
+    }
+
+    std::atomic<int> errors = 0;
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 4; reader++) {
+        readers.emplace_back([&errors, snapshot = tree.snapshot()]() {
+            for (int round = 0; round < 20; round++) {
+                int expected_key = 0;
+                for (auto [key, value] : snapshot) {
+                    errors += (key != expected_key || value != key);
+                    ++expected_key;
+                }
+                errors += (expected_key != KEY_RANGE);
+            }
+        });
+    }
+
+    std::mt19937 gen(12);
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % KEY_RANGE);
+        tree.assign(key, -step);
+    }
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_TRUE(tree.isTreeCorrect());
+}
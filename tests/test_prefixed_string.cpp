@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AVLTree.hpp"
+#include "PrefixedString.hpp"
+#include "RedBlackTree.hpp"
+
+namespace {
+
+// Short alphabet and shared stems, so many pairs tie on the prefix; includes zero bytes.
+std::string makeString(std::mt19937& gen) {
+    static const std::vector<std::string> stems = { "", "https://", "https://www.", std::string("a\0b", 3) };
+    std::string result = stems[gen() % stems.size()];
+    size_t length = gen() % 12;
+    for (size_t i = 0; i < length; ++i) {
+        const char alphabet[] = { '\0', 'a', 'b', '\x7f', '\x80', '\xff' };
+        result.push_back(alphabet[gen() % sizeof(alphabet)]);
+    }
+    return result;
+}
+
+}
+
+TEST(PrefixedStringTest, OrdersLikeStdString) {
+    std::mt19937 gen(43);
+    for (int i = 0; i < 100000; i++) {
+        std::string lhs = makeString(gen);
+        std::string rhs = makeString(gen);
+        PrefixedString prefixed_lhs = lhs;
+        PrefixedString prefixed_rhs = rhs;
+
+        ASSERT_EQ(prefixed_lhs < prefixed_rhs, lhs < rhs) << i;
+        ASSERT_EQ(prefixed_lhs == prefixed_rhs, lhs == rhs) << i;
+        ASSERT_EQ(prefixed_lhs > prefixed_rhs, lhs > rhs) << i;
+    }
+}
+
+template <typename TreeType>
+class PrefixedStringTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using PrefixedStringTrees = ::testing::Types<AVLTree<PrefixedString, int>, RedBlackTree<PrefixedString, int>>;
+
+TYPED_TEST_SUITE(PrefixedStringTreeTest, PrefixedStringTrees);
+
+TYPED_TEST(PrefixedStringTreeTest, MatchesStdMap) {
+    std::map<std::string, int> expected;
+    std::mt19937 gen(44);
+
+    for (int step = 0; step < 20000; step++) {
+        std::string key = makeString(gen);
+        if (gen() % 3 == 0 && expected.erase(key) > 0) {
+            this->tree.erase(key);
+        }
+        else {
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+        }
+    }
+
+    EXPECT_EQ(this->tree.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (auto [key, value] : this->tree) {
+        EXPECT_EQ(key.getString(), expected_it->first);
+        EXPECT_EQ(value, expected_it->second);
+        ++expected_it;
+    }
+    for (const auto& [key, value] : expected) {
+        EXPECT_EQ(this->tree[key], value);
+    }
+}
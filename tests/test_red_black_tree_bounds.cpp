@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "MappedVector.hpp"
+#include "TestableRedBlackTree.hpp"
+
+template <typename TreeType>
+class RedBlackTreeBoundsTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using BoundsImplementations = ::testing::Types<TestableRedBlackTree<int, int>,
+                                               TestableRedBlackTree<int, int, MappedVector>>;
+
+TYPED_TEST_SUITE(RedBlackTreeBoundsTest, BoundsImplementations);
+
+TYPED_TEST(RedBlackTreeBoundsTest, EmptyTree) {
+    EXPECT_EQ(this->tree.begin(), this->tree.end());
+    EXPECT_THROW(this->tree.front(), std::out_of_range);
+    EXPECT_THROW(this->tree.back(), std::out_of_range);
+    EXPECT_THROW(this->tree.popMin(), std::out_of_range);
+    EXPECT_THROW(this->tree.popMax(), std::out_of_range);
+}
+
+TYPED_TEST(RedBlackTreeBoundsTest, FrontAndBackFollowUpdates) {
+    std::map<int, int> expected;
+    std::mt19937 gen(40);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 1000);
+        switch (gen() % 4) {
+        case 0:
+        case 1:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 2:
+            if (expected.erase(key) > 0) {
+                this->tree.erase(key);
+            }
+            break;
+        default:
+            if (!expected.empty()) {
+                auto [popped_key, popped_value] = gen() % 2 ? this->tree.popMin() : this->tree.popMax();
+                auto expected_it = popped_key == expected.begin()->first ? expected.begin() : std::prev(expected.end());
+                EXPECT_EQ(popped_key, expected_it->first);
+                EXPECT_EQ(popped_value, expected_it->second);
+                expected.erase(expected_it);
+            }
+        }
+
+        ASSERT_EQ(this->tree.size(), expected.size());
+        if (!expected.empty()) {
+            ASSERT_EQ(this->tree.front().first, expected.begin()->first);
+            ASSERT_EQ(this->tree.back().first, expected.rbegin()->first);
+            ASSERT_EQ((*this->tree.begin()).first, expected.begin()->first);
+        }
+        if (step % 1000 == 0) {
+            ASSERT_TRUE(this->tree.isTreeCorrect());
+        }
+    }
+    EXPECT_TRUE(this->tree.isTreeCorrect());
+}
+
+TYPED_TEST(RedBlackTreeBoundsTest, PopsInOrder) {
+    for (int i = 0; i < 1000; i++) {
+        this->tree.insert((i * 7919) % 1000, i);
+    }
+    this->tree.front().second = -1;
+    EXPECT_EQ(this->tree[0], -1);
+
+    for (int i = 0; i < 500; i++) {
+        EXPECT_EQ(this->tree.popMin().first, i);
+        EXPECT_EQ(this->tree.popMax().first, 999 - i);
+    }
+    EXPECT_TRUE(this->tree.empty());
+    EXPECT_TRUE(this->tree.isTreeCorrect());
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ShardedTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename T>
+class ShardedTreeTest : public testing::Test {};
+
+using ShardedImplementations = testing::Types<
+    ShardedTree<int, int>,
+    ShardedTree<int, int, RedBlackTree<int, int>>
+>;
+
+TYPED_TEST_SUITE(ShardedTreeTest, ShardedImplementations);
+
+TYPED_TEST(ShardedTreeTest, MatchesStdMapAcrossShards) {
+    TypeParam tree(64);
+    std::map<int, int> expected;
+    std::mt19937 gen(3);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = static_cast<int>(gen() % 2000);
+        switch (gen() % 4) {
+        case 0:
+            EXPECT_EQ(tree.insert(key, step), expected.insert({ key, step }).second);
+            break;
+        case 1:
+            tree.assign(key, step);
+            expected[key] = step;
+            break;
+        case 2:
+            EXPECT_EQ(tree.erase(key), expected.erase(key) > 0);
+            break;
+        default: {
+            auto value = tree.find(key);
+            auto it = expected.find(key);
+            ASSERT_EQ(value.has_value(), it != expected.end());
+            if (value.has_value()) {
+                EXPECT_EQ(*value, it->second);
+            }
+
+            auto upper = tree.upperBound(key);
+            auto expected_upper = expected.upper_bound(key);
+            ASSERT_EQ(upper.has_value(), expected_upper != expected.end());
+            if (upper.has_value()) {
+                EXPECT_EQ(upper->first, expected_upper->first);
+                EXPECT_EQ(upper->second, expected_upper->second);
+            }
+        }
+        }
+        if (step % 1000 == 0) {
+            tree.rebalance();
+        }
+    }
+
+    tree.rebalance();
+    EXPECT_GT(tree.getCountOfShards(), 1U);
+    EXPECT_EQ(tree.size(), expected.size());
+
+    std::vector<std::pair<int, int>> elements;
+    tree.forEach([&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+
+    elements.clear();
+    tree.forEach(1000, [&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    expected_elements.assign(expected.lower_bound(1000), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+}
+
+TYPED_TEST(ShardedTreeTest, LowerBoundSkipsEmptyShards) {
+    TypeParam tree(16);
+    for (int key = 0; key < 1000; key++) {
+        tree.insert(key, key);
+    }
+    tree.rebalance();
+    ASSERT_GT(tree.getCountOfShards(), 4U);
+
+    // Empties the middle shards; the answer must not depend on whether they were merged yet.
+    for (int key = 100; key < 900; key++) {
+        tree.erase(key);
+    }
+
+    auto lower = tree.lowerBound(100);
+    ASSERT_TRUE(lower.has_value());
+    EXPECT_EQ(lower->first, 900);
+    EXPECT_FALSE(tree.lowerBound(1000).has_value());
+
+    tree.rebalance();
+    EXPECT_EQ(tree.lowerBound(100)->first, 900);
+    EXPECT_EQ(tree.size(), 200U);
+}
+
+TYPED_TEST(ShardedTreeTest, ConcurrentWritersKeepEveryKey) {
+    const int THREADS = 8;
+    const int KEYS_PER_THREAD = 5000;
+
+    TypeParam tree(256);
+    std::vector<std::thread> writers;
+    for (int thread = 0; thread < THREADS; thread++) {
+        writers.emplace_back([&, thread]() {
+            for (int i = 0; i < KEYS_PER_THREAD; i++) {
+                int key = i * THREADS + thread;
+                tree.insert(key, key);
+                if (i % 3 == 0) {
+                    tree.erase(key);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    size_t expected_size = 0;
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        expected_size += (i % 3 != 0) * THREADS;
+    }
+    EXPECT_EQ(tree.size(), expected_size);
+
+    int previous = -1;
+    size_t count = 0;
+    tree.forEach([&](int key, int value) {
+        EXPECT_GT(key, previous);
+        EXPECT_EQ(key, value);
+        EXPECT_NE((key / THREADS) % 3, 0);
+        previous = key;
+        ++count;
+    });
+    EXPECT_EQ(count, expected_size);
+}
+
+TYPED_TEST(ShardedTreeTest, SizeStaysExactUnderConcurrentClear) {
+    const int THREADS = 4;
+    const int STEPS = 20000;
+
+    TypeParam tree(256);
+    std::atomic<bool> is_running = true;
+    std::vector<std::thread> writers;
+    for (int thread = 0; thread < THREADS; thread++) {
+        writers.emplace_back([&, thread]() {
+            for (int i = 0; i < STEPS; i++) {
+                int key = (i % 500) * THREADS + thread;
+                if (i % 2 == 0) {
+                    tree.insert(key, key);
+                }
+                else {
+                    tree.erase(key);
+                }
+                // The count may never wrap below zero.
+                ASSERT_LE(tree.size(), static_cast<size_t>(500 * THREADS));
+            }
+        });
+    }
+    std::thread clearer([&]() {
+        while (is_running) {
+            tree.clear();
+            std::this_thread::yield();
+        }
+    });
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    is_running = false;
+    clearer.join();
+
+    size_t count = 0;
+    tree.forEach([&](int, int) {
+        ++count;
+    });
+    EXPECT_EQ(tree.size(), count);
+}
+
+TYPED_TEST(ShardedTreeTest, RebalanceRacesWithWriters) {
+    const int THREADS = 4;
+    const int KEYS_PER_THREAD = 20000;
+
+    // Every writer hits the same key range, so a split usually has to be built again.
+    TypeParam tree(512);
+    std::atomic<bool> is_running = true;
+    std::thread rebalancer([&]() {
+        while (is_running) {
+            tree.rebalance();
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int thread = 0; thread < THREADS; thread++) {
+        writers.emplace_back([&, thread]() {
+            for (int i = 0; i < KEYS_PER_THREAD; i++) {
+                tree.insert(i * THREADS + thread, i);
+                if (i % 4 == 0) {
+                    tree.erase((i / 2) * THREADS + thread);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    is_running = false;
+    rebalancer.join();
+    tree.rebalance();
+
+    std::map<int, int> expected;
+    for (int thread = 0; thread < THREADS; thread++) {
+        for (int i = 0; i < KEYS_PER_THREAD; i++) {
+            expected.insert({ i * THREADS + thread, i });
+            if (i % 4 == 0) {
+                expected.erase((i / 2) * THREADS + thread);
+            }
+        }
+    }
+    std::vector<std::pair<int, int>> elements;
+    tree.forEach([&](int key, int value) {
+        elements.push_back({ key, value });
+    });
+    std::vector<std::pair<int, int>> expected_elements(expected.begin(), expected.end());
+    EXPECT_EQ(elements, expected_elements);
+    EXPECT_EQ(tree.size(), expected.size());
+    EXPECT_GE(tree.getCountOfShards(), expected.size() / 512U);
+}
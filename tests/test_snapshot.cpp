@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <string>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+template <typename TreeType>
+class SnapshotTest : public ::testing::Test {
+protected:
+    TreeType tree;
+    std::string path;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = (std::filesystem::temp_directory_path() /
+                (std::string("snapshot_") + info->type_param() + "_" + info->name() + ".bin")).string();
+        for (char& c : path) {
+            if (c == '<' || c == '>' || c == ',' || c == ' ' || c == ':') {
+                c = '_';
+            }
+        }
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+using SnapshotTreeImplementations = ::testing::Types<AVLTree<int, int>,
+                                                     RedBlackTree<int, int>>;
+
+TYPED_TEST_SUITE(SnapshotTest, SnapshotTreeImplementations);
+
+TYPED_TEST(SnapshotTest, CanLoadEmptySnapshot) {
+    this->tree.saveSnapshot(this->path);
+    auto loaded = FrozenTree<int, int>::loadSnapshot(this->path);
+
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_EQ(loaded.begin(), loaded.end());
+    EXPECT_EQ(loaded.find(0), loaded.end());
+}
+
+TYPED_TEST(SnapshotTest, LoadedSnapshotMatchesTree) {
+    std::mt19937 gen(17);
+    for (int i = 0; i < 5000; i++) {
+        int key = static_cast<int>(gen() % 100000);
+        this->tree.insert(key, key * 2);
+    }
+
+    this->tree.saveSnapshot(this->path);
+    auto loaded = FrozenTree<int, int>::loadSnapshot(this->path);
+
+    ASSERT_EQ(loaded.size(), this->tree.size());
+
+    auto it = this->tree.begin();
+    for (auto [key, value] : loaded) {
+        EXPECT_EQ(key, (*it).first);
+        EXPECT_EQ(value, (*it).second);
+        ++it;
+    }
+    EXPECT_EQ(it, this->tree.end());
+
+    for (int i = 0; i < 1000; i++) {
+        int key = static_cast<int>(gen() % 100001);
+        auto expected = this->tree.lowerBound(key);
+        auto actual = loaded.lowerBound(key);
+        ASSERT_EQ(actual == loaded.end(), expected == this->tree.end());
+        if (actual != loaded.end()) {
+            EXPECT_EQ(actual->first, expected->first);
+        }
+        EXPECT_EQ(loaded.isExist(key), this->tree.isExist(key));
+    }
+}
+
+TYPED_TEST(SnapshotTest, CopiesOutliveTheOriginal) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, -i);
+    }
+    this->tree.saveSnapshot(this->path);
+
+    FrozenTree<int, int> copy;
+    {
+        auto loaded = FrozenTree<int, int>::loadSnapshot(this->path);
+        copy = loaded;
+    }
+    EXPECT_EQ(copy.size(), 100U);
+    EXPECT_EQ(copy[42], -42);
+}
+
+TYPED_TEST(SnapshotTest, RejectsCorruptedSnapshot) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, i);
+    }
+    this->tree.saveSnapshot(this->path);
+
+    {
+        std::fstream file(this->path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put('\x7f');
+    }
+    using Loaded = FrozenTree<int, int>;
+    EXPECT_THROW(Loaded::loadSnapshot(this->path), std::runtime_error);
+    EXPECT_NO_THROW(Loaded::loadSnapshot(this->path, false));
+
+    // Snapshots are typed: the node layout must match.
+    this->tree.saveSnapshot(this->path);
+    EXPECT_THROW((FrozenTree<int, long long>::loadSnapshot(this->path)), std::runtime_error);
+
+    EXPECT_THROW(Loaded::loadSnapshot(this->path + ".missing"), std::runtime_error);
+}
+
+TYPED_TEST(SnapshotTest, UncheckedSnapshotRejectsCorruptLinks) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, i);
+    }
+    this->tree.saveSnapshot(this->path);
+
+    using Loaded = FrozenTree<int, int>;
+    const std::streamoff HEADER_SIZE = 64;
+    const std::streamoff NODE_SIZE = 5 * sizeof(int);
+
+    // Points a left link of every node far outside the node array.
+    {
+        std::fstream file(this->path, std::ios::binary | std::ios::in | std::ios::out);
+        for (std::streamoff node = 0; node < 100; node++) {
+            int link = 1 << 30;
+            file.seekp(HEADER_SIZE + node * NODE_SIZE + static_cast<std::streamoff>(sizeof(int)));
+            file.write(reinterpret_cast<const char*>(&link), sizeof(link));
+        }
+    }
+    Loaded loaded = Loaded::loadSnapshot(this->path, false);
+    EXPECT_THROW(loaded.find(0), std::runtime_error);
+    EXPECT_THROW(loaded.begin(), std::runtime_error);
+
+    // Makes every left link point back to its node: a descent would never end.
+    this->tree.saveSnapshot(this->path);
+    {
+        std::fstream file(this->path, std::ios::binary | std::ios::in | std::ios::out);
+        for (int node = 0; node < 100; node++) {
+            file.seekp(HEADER_SIZE + node * NODE_SIZE + static_cast<std::streamoff>(sizeof(int)));
+            file.write(reinterpret_cast<const char*>(&node), sizeof(node));
+        }
+    }
+    loaded = Loaded::loadSnapshot(this->path, false);
+    EXPECT_THROW(loaded.lowerBound(-1), std::runtime_error);
+
+    // A truncated file is rejected whether or not the checksum is verified.
+    this->tree.saveSnapshot(this->path);
+    std::filesystem::resize_file(this->path, std::filesystem::file_size(this->path) - 1);
+    EXPECT_THROW(Loaded::loadSnapshot(this->path, false), std::runtime_error);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include "TestableSplayTree.hpp"
+
+template <typename TreeType>
+class SplayTreeTest : public ::testing::Test {
+protected:
+    TreeType tree;
+};
+
+using SplayTreeImplementations = ::testing::Types<TestableSplayTree<int, int>,
+                                                  TestableSplayTree<int, int, true>>;
+
+TYPED_TEST_SUITE(SplayTreeTest, SplayTreeImplementations);
+
+TYPED_TEST(SplayTreeTest, EraseReturnsNextElement) {
+    for (int i = 0; i < 100; i++) {
+        this->tree.insert(i, i);
+    }
+
+    for (int i = 0; i < 100; i += 2) {
+        this->tree.find(i + 1);
+        auto it = this->tree.erase(i);
+        if (i + 1 < 100) {
+            ASSERT_NE(it, this->tree.end());
+            EXPECT_EQ(it->first, i + 1);
+        }
+        ASSERT_TRUE(this->tree.isTreeCorrect());
+    }
+}
+
+TYPED_TEST(SplayTreeTest, MatchesStdMapOnSkewedAccesses) {
+    std::map<int, int> expected;
+    std::mt19937 gen(3);
+    std::geometric_distribution<int> skewed(0.05);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = skewed(gen);
+        switch (gen() % 4) {
+        case 0:
+            this->tree.insert(key, step);
+            expected.insert({ key, step });
+            break;
+        case 1:
+            if (expected.erase(key) > 0) {
+                this->tree.erase(key);
+            }
+            break;
+        case 2:
+            EXPECT_EQ(this->tree.isExist(key), expected.contains(key));
+            break;
+        default: {
+            auto it = this->tree.lowerBound(key);
+            auto expected_it = expected.lower_bound(key);
+            if (expected_it == expected.end()) {
+                EXPECT_EQ(it, this->tree.end());
+            }
+            else {
+                ASSERT_NE(it, this->tree.end());
+                EXPECT_EQ(it->first, expected_it->first);
+                EXPECT_EQ(it->second, expected_it->second);
+            }
+        }
+        }
+    }
+
+    EXPECT_TRUE(this->tree.isTreeCorrect());
+    EXPECT_EQ(this->tree.size(), expected.size());
+}
+
+TYPED_TEST(SplayTreeTest, BoundsOnDegenerateTree) {
+    // Ascending inserts leave a path of left sons that is as long as the tree.
+    constexpr int COUNT = 300000;
+    for (int i = 0; i < COUNT; i++) {
+        this->tree.insert(i, i);
+    }
+    auto it = this->tree.lowerBound(-1);
+    ASSERT_NE(it, this->tree.end());
+    EXPECT_EQ(it->first, 0);
+
+    this->tree.clear();
+    for (int i = 0; i < COUNT; i++) {
+        this->tree.insert(i, i);
+    }
+    it = this->tree.upperBound(0);
+    ASSERT_NE(it, this->tree.end());
+    EXPECT_EQ(it->first, 1);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+
+#include "TreeSet.hpp"
+
+template <typename SetType>
+class TreeSetTest : public ::testing::Test {
+protected:
+    SetType set;
+};
+
+using TreeSetImplementations = ::testing::Types<AVLSet<int>, RedBlackSet<int>>;
+
+TYPED_TEST_SUITE(TreeSetTest, TreeSetImplementations);
+
+TYPED_TEST(TreeSetTest, MatchesStdSet) {
+    std::set<int> expected;
+    std::mt19937 gen(42);
+
+    for (int step = 0; step < 30000; step++) {
+        int key = static_cast<int>(gen() % 2000);
+        switch (gen() % 3) {
+        case 0:
+            EXPECT_EQ(*this->set.insert(key), key);
+            expected.insert(key);
+            break;
+        case 1:
+            if (expected.erase(key) > 0) {
+                this->set.erase(key);
+            }
+            else {
+                EXPECT_THROW(this->set.erase(key), std::out_of_range);
+            }
+            break;
+        default: {
+            EXPECT_EQ(this->set.isExist(key), expected.count(key) > 0U);
+            auto it = this->set.lowerBound(key);
+            auto expected_it = expected.lower_bound(key);
+            ASSERT_EQ(it == this->set.end(), expected_it == expected.end());
+            if (it != this->set.end()) {
+                EXPECT_EQ(*it, *expected_it);
+            }
+        }
+        }
+    }
+
+    EXPECT_EQ(this->set.size(), expected.size());
+    auto expected_it = expected.begin();
+    for (const int& key : this->set) {
+        EXPECT_EQ(key, *expected_it);
+        ++expected_it;
+    }
+}
+
+TEST(TreeSetStringTest, StoresKeysOnly) {
+    static_assert(sizeof(NodeData<std::string, NoValue>) == sizeof(std::string));
+    static_assert(sizeof(NodeData<int, NoValue>) == sizeof(int));
+
+    RedBlackSet<std::string> set;
+    for (int i = 0; i < 100; i++) {
+        set.insert("key" + std::to_string(i));
+    }
+    EXPECT_EQ(set.size(), 100U);
+    EXPECT_EQ(set.find("key42")->size(), 5U);
+    EXPECT_EQ(set.find("key100"), set.end());
+
+    std::string previous;
+    for (const std::string& key : set) {
+        EXPECT_LT(previous, key);
+        previous = key;
+    }
+}
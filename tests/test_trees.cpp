@@ -7,6 +7,9 @@
 
 #include "TestableAVLTree.hpp"
 #include "TestableRedBlackTree.hpp"
+#include "TestableBPlusTree.hpp"
+#include "TestableSplayTree.hpp"
+#include "MappedVector.hpp"
 
 template <typename TreeType>
 class SearchTreeTest : public ::testing::Test {
@@ -17,7 +20,13 @@ protected:
 const int BIG_TESTS_SIZE = 3000;
 
 using TreeImplementations = ::testing::Types<TestableAVLTree<int, int>,
-                                             TestableRedBlackTree<int, int>>;
+                                             TestableRedBlackTree<int, int>,
+                                             TestableBPlusTree<int, int>,
+                                             TestableBPlusTree<int, int, 4>,
+                                             TestableSplayTree<int, int>,
+                                             TestableSplayTree<int, int, true>,
+                                             TestableAVLTree<int, int, MappedVector>,
+                                             TestableRedBlackTree<int, int, MappedVector>>;
 
 TYPED_TEST_SUITE(SearchTreeTest, TreeImplementations);
 
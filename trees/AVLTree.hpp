@@ -1,16 +1,35 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <utility>
 #include <cmath>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-template <typename TKey, typename TValue>
+#include "BatchOperation.hpp"
+#include "EytzingerIndex.hpp"
+#include "FrozenTree.hpp"
+#include "NodeData.hpp"
+#include "NodeHandle.hpp"
+#include "ParallelBuild.hpp"
+
+template <typename TKey, typename TValue, template <typename...> class TContainer = std::vector>
 class AVLTree {
 protected:
 
     using node_ptr = int;
     const static node_ptr NULL_PTR = -1;
 
+    // applyBatch rebuilds the tree when the batch has at least 1/REBUILD_BATCH_RATIO of its size.
+    constexpr static size_t REBUILD_BATCH_RATIO = 32;
+
+    // eraseIf and eraseRange rebuild the tree when at least 1/REBUILD_ERASE_RATIO of it is erased.
+    constexpr static size_t REBUILD_ERASE_RATIO = 16;
+
     struct Node {
 
         node_ptr parent;
@@ -18,7 +37,7 @@ protected:
 
         size_t height;
 
-        std::pair<TKey, TValue> data;
+        NodeData<TKey, TValue> data;
 
         bool is_fictitious;
     };
@@ -30,9 +49,9 @@ public:
 
         node_ptr ptr = 0;
 
-        AVLTree<TKey, TValue>* container_ptr;
+        AVLTree<TKey, TValue, TContainer>* container_ptr;
 
-        Iterator(node_ptr ptr, AVLTree<TKey, TValue>* container_ptr) :
+        Iterator(node_ptr ptr, AVLTree<TKey, TValue, TContainer>* container_ptr) :
             ptr(ptr),
             container_ptr(container_ptr)
         {}
@@ -53,7 +72,7 @@ public:
             return { container_ptr->tree[ptr].data.first, container_ptr->tree[ptr].data.second };
         }
 
-        std::pair<TKey, TValue>* operator->() const {
+        NodeData<TKey, TValue>* operator->() const {
             return &container_ptr->tree[ptr].data;
         }
 
@@ -90,17 +109,17 @@ public:
 
 protected:
 
-    std::vector<Node> tree;
+    TContainer<Node> tree;
     size_t count_of_elements = 0;
 
     node_ptr root;
 
-    std::vector<node_ptr> free_poses;
+    TContainer<node_ptr> free_poses;
 
 protected:
 
     Iterator makeIterator(node_ptr position) const {
-        return Iterator(position, const_cast<AVLTree<TKey, TValue>*>(this));
+        return Iterator(position, const_cast<AVLTree<TKey, TValue, TContainer>*>(this));
     }
 
     node_ptr createNode(node_ptr parent) {
@@ -265,9 +284,10 @@ protected:
         return current_ptr;
     }
 
-    void insertPosition(node_ptr ptr, const TKey& key, const TValue& value) {
-        tree[ptr].data.first = key;
-        tree[ptr].data.second = value;
+    // Takes the key and value by value, so that a moved-in element is not copied.
+    void insertPosition(node_ptr ptr, TKey key, TValue value) {
+        tree[ptr].data.first = std::move(key);
+        tree[ptr].data.second = std::move(value);
 
         tree[ptr].is_fictitious = false;
 
@@ -347,6 +367,26 @@ protected:
         }
     }
 
+    // Climbs from the finger to the lowest ancestor whose subtree holds the lower bound of the key.
+    // An ancestor that bounds that subtree from above and is not less than the key goes to `nearest_pos`.
+    node_ptr climbFromFinger(node_ptr finger, const TKey& key, node_ptr& nearest_pos) const {
+        bool is_key_after_finger = getKey(finger) < key;
+        node_ptr current_ptr = finger;
+        while (getParent(current_ptr) != NULL_PTR) {
+            node_ptr parent = getParent(current_ptr);
+            bool is_left_son = getLeftSon(parent) == current_ptr;
+            if (is_key_after_finger && is_left_son && !(getKey(parent) < key)) {
+                nearest_pos = parent;
+                return current_ptr;
+            }
+            if (!is_key_after_finger && !is_left_son && getKey(parent) < key) {
+                return current_ptr;
+            }
+            current_ptr = parent;
+        }
+        return current_ptr;
+    }
+
     void upperBound(const TKey& key, node_ptr x, node_ptr& nearest_pos) const {
         if (isFictitious(x)) {
             return;
@@ -360,12 +400,197 @@ protected:
         }
     }
 
+    std::vector<bool> applyBatchBySearch(std::span<const BatchOperation<TKey, TValue>> batch) {
+        std::vector<bool> results(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const BatchOperation<TKey, TValue>& operation = batch[i];
+            // One descent per update; sorted keys share the top of their paths in cache.
+            node_ptr ptr = findPosition(operation.key);
+            bool is_found = !isFictitious(ptr);
+
+            if (operation.type == BatchOperation<TKey, TValue>::Type::ERASE) {
+                results[i] = is_found;
+                if (is_found) {
+                    --count_of_elements;
+                    erasePosition(ptr);
+                }
+            }
+            else if (is_found) {
+                tree[ptr].data.second = operation.value;
+            }
+            else {
+                ++count_of_elements;
+                insertPosition(ptr, operation.key, operation.value);
+                results[i] = true;
+            }
+        }
+        return results;
+    }
+
+    std::vector<bool> applyBatchByMerge(std::span<const BatchOperation<TKey, TValue>> batch) {
+        std::vector<bool> results(batch.size());
+        std::vector<std::pair<TKey, TValue>> merged;
+        merged.reserve(size() + batch.size());
+
+        Iterator it = begin();
+        auto takeElement = [&]() {
+            merged.emplace_back(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+            ++it;
+        };
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const BatchOperation<TKey, TValue>& operation = batch[i];
+            while (it != end() && !(operation.key < getKey(it.ptr))) {
+                takeElement();
+            }
+            bool is_found = !merged.empty() && merged.back().first == operation.key;
+
+            if (operation.type == BatchOperation<TKey, TValue>::Type::ERASE) {
+                results[i] = is_found;
+                if (is_found) {
+                    merged.pop_back();
+                }
+            }
+            else if (is_found) {
+                merged.back().second = operation.value;
+            }
+            else {
+                merged.emplace_back(operation.key, operation.value);
+                results[i] = true;
+            }
+        }
+        while (it != end()) {
+            takeElement();
+        }
+
+        buildFromSorted(std::move(merged));
+        return results;
+    }
+
+    // Sorts the free list so that new nodes take the lowest free slots, and gives the free slots
+    // at the end of the pool back to the container.
+    void compactFreePoses() {
+        std::vector<node_ptr> poses;
+        poses.reserve(free_poses.size());
+        for (size_t i = 0; i < free_poses.size(); ++i) {
+            poses.push_back(free_poses[i]);
+        }
+        std::sort(poses.begin(), poses.end());
+        while (!poses.empty() && static_cast<size_t>(poses.back()) + 1U == tree.size()) {
+            poses.pop_back();
+            tree.pop_back();
+        }
+        free_poses.clear();
+        for (auto it = poses.rbegin(); it != poses.rend(); ++it) {
+            free_poses.push_back(*it);
+        }
+    }
+
+    // Replaces the contents with the sorted elements of `sorted_data`, as a tree of minimal height.
+    void buildFromSorted(std::vector<std::pair<TKey, TValue>>&& sorted_data) {
+        if (sorted_data.empty()) {
+            clear();
+            return;
+        }
+        tree.clear();
+        free_poses.clear();
+        count_of_elements = sorted_data.size();
+        root = buildSubtree(sorted_data, 0U, sorted_data.size(), NULL_PTR);
+    }
+
+    // Each node takes the middle of its range, so the subtree heights differ by at most one.
+    node_ptr buildSubtree(std::vector<std::pair<TKey, TValue>>& sorted_data, size_t begin, size_t end, node_ptr parent) {
+        node_ptr ptr = createNode(parent);
+        if (begin == end) {
+            return ptr;
+        }
+        size_t middle = begin + (end - begin) / 2U;
+        tree[ptr].data.first = std::move(sorted_data[middle].first);
+        tree[ptr].data.second = std::move(sorted_data[middle].second);
+        tree[ptr].is_fictitious = false;
+
+        node_ptr left_son = buildSubtree(sorted_data, begin, middle, ptr);
+        node_ptr right_son = buildSubtree(sorted_data, middle + 1U, end, ptr);
+        tree[ptr].left_node = left_son;
+        tree[ptr].right_node = right_son;
+
+        updateHeight(ptr);
+        return ptr;
+    }
+
+    // A subtree of the parallel build left to a worker thread.
+    struct BuildTask {
+        size_t begin;
+        size_t end;
+        node_ptr parent;
+        node_ptr position;
+    };
+
+    // Builds the subtree of [begin, end) like buildSubtree, but into the slots from `position` on:
+    // in preorder a subtree of k elements takes 2k + 1 slots with its fictitious leaves, so each
+    // subtree knows its place in advance. With `tasks`, the subtrees `levels_to_split` levels down
+    // are left to the workers, and the heights above them to updateTopHeights.
+    void placeSubtree(std::vector<std::pair<TKey, TValue>>& sorted_data, size_t begin, size_t end, node_ptr parent,
+                      node_ptr position, std::vector<BuildTask>* tasks, size_t levels_to_split) {
+        if (tasks != nullptr && levels_to_split == 0U) {
+            tasks->push_back({ begin, end, parent, position });
+            return;
+        }
+        tree[position].parent = parent;
+        tree[position].left_node = NULL_PTR;
+        tree[position].right_node = NULL_PTR;
+        tree[position].height = 0U;
+        tree[position].is_fictitious = true;
+        if (begin == end) {
+            return;
+        }
+        size_t middle = begin + (end - begin) / 2U;
+        tree[position].data.first = std::move(sorted_data[middle].first);
+        tree[position].data.second = std::move(sorted_data[middle].second);
+        tree[position].is_fictitious = false;
+
+        node_ptr left_son = position + 1;
+        node_ptr right_son = position + 2 * static_cast<node_ptr>(middle - begin) + 2;
+        tree[position].left_node = left_son;
+        tree[position].right_node = right_son;
+        placeSubtree(sorted_data, begin, middle, position, left_son, tasks, levels_to_split - 1U);
+        placeSubtree(sorted_data, middle + 1U, end, position, right_son, tasks, levels_to_split - 1U);
+
+        if (tasks == nullptr) {
+            updateHeight(position);
+        }
+    }
+
+    void updateTopHeights(node_ptr x, size_t levels) {
+        if (levels == 0U || isFictitious(x)) {
+            return;
+        }
+        updateTopHeights(getLeftSon(x), levels - 1U);
+        updateTopHeights(getRightSon(x), levels - 1U);
+        updateHeight(x);
+    }
+
 public:
 
     AVLTree() {
         root = createNode(-1);
     }
 
+    // Opens the tree stored at `path` or creates an empty one there. Needs a file-backed
+    // TContainer such as MappedVector; the free list is kept next to it in `path`.free. Changes
+    // reach the files only through flush().
+    explicit AVLTree(const std::string& path) :
+        tree(path),
+        free_poses(path + ".free")
+    {
+        if (tree.empty()) {
+            root = createNode(-1);
+            return;
+        }
+        root = static_cast<node_ptr>(tree.getUserData()[0]);
+        count_of_elements = static_cast<size_t>(tree.getUserData()[1]);
+    }
+
     Iterator begin() const {
         if (empty()) {
             return end();
@@ -384,6 +609,21 @@ public:
         return makeIterator(nearest_pos);
     }
 
+    // Finger search: starts from `from` instead of the root, so a key near the finger is found
+    // after climbing only a few levels.
+    Iterator lowerBound(Iterator from, const TKey& key) {
+        if (from == end()) {
+            return lowerBound(key);
+        }
+        if (getKey(from.ptr) == key) {
+            return from;
+        }
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr subtree_root = climbFromFinger(from.ptr, key, nearest_pos);
+        lowerBound(key, subtree_root, nearest_pos);
+        return makeIterator(nearest_pos);
+    }
+
     Iterator upperBound(const TKey& key) {
         node_ptr nearest_pos = NULL_PTR;
         upperBound(key, root, nearest_pos);
@@ -408,12 +648,198 @@ public:
             throw std::out_of_range("No such key in the tree");
         }
         --count_of_elements;
+        // Erasing a node with two sons moves the next element into it.
         auto result = it;
-        ++result;
+        if (isFictitious(getLeftSon(it.ptr)) || isFictitious(getRightSon(it.ptr))) {
+            ++result;
+        }
         erasePosition(it.ptr);
         return result;
     }
 
+    // Applies a batch of updates sorted by key (equal keys in the order they should take effect).
+    // Returns for each update whether it inserted a new key (UPSERT) or erased a present one (ERASE).
+    // A batch that is small next to the tree is applied with one descent per update;
+    // a large one is merged with the elements of the tree and the tree is rebuilt.
+    std::vector<bool> applyBatch(std::span<const BatchOperation<TKey, TValue>> batch) {
+        for (size_t i = 1; i < batch.size(); ++i) {
+            if (batch[i].key < batch[i - 1].key) {
+                throw std::invalid_argument("The batch is not sorted by key");
+            }
+        }
+        if (batch.size() * REBUILD_BATCH_RATIO >= size()) {
+            return applyBatchByMerge(batch);
+        }
+        return applyBatchBySearch(batch);
+    }
+
+    // Replaces the contents with `elements`, which must be sorted by key without repeats, in O(n).
+    void assignSorted(std::vector<std::pair<TKey, TValue>> elements) {
+        for (size_t i = 1; i < elements.size(); ++i) {
+            if (!(elements[i - 1].first < elements[i].first)) {
+                throw std::invalid_argument("The elements are not sorted by key");
+            }
+        }
+        buildFromSorted(std::move(elements));
+    }
+
+    // Replaces the contents with `elements`, which may be unsorted; of equal keys the first one is kept.
+    // Sorting and building run on `count_of_threads` threads (0 means one per core): the top levels
+    // of the tree are built first, then the threads fill in the subtrees below them.
+    void buildParallel(std::vector<std::pair<TKey, TValue>> elements, size_t count_of_threads = 0) {
+        count_of_threads = getCountOfThreads(count_of_threads);
+        sortAndDeduplicate(elements, count_of_threads);
+        if (elements.empty()) {
+            clear();
+            return;
+        }
+        tree.clear();
+        free_poses.clear();
+        for (size_t i = 0; i < 2U * elements.size() + 1U; ++i) {
+            tree.push_back(Node());
+        }
+        count_of_elements = elements.size();
+
+        // About four subtrees per thread even out the work of the threads.
+        size_t split_levels = std::bit_width(4U * count_of_threads - 1U);
+        std::vector<BuildTask> tasks;
+        root = 0;
+        placeSubtree(elements, 0U, elements.size(), NULL_PTR, root, &tasks, split_levels);
+
+        size_t count_of_workers = std::min(count_of_threads, std::max<size_t>(tasks.size(), 1U));
+        runInThreads(count_of_workers, [&](size_t worker) {
+            for (size_t i = worker; i < tasks.size(); i += count_of_workers) {
+                const BuildTask& task = tasks[i];
+                placeSubtree(elements, task.begin, task.end, task.parent, task.position, nullptr, 0U);
+            }
+        });
+        updateTopHeights(root, split_levels);
+    }
+
+    // Erases the elements for which `predicate(key, value)` is true and returns their number.
+    // When a large part of the tree goes, the rest is rebuilt instead of being erased node by node.
+    template <typename TPredicate>
+    size_t eraseIf(TPredicate predicate) {
+        std::vector<node_ptr> erased_poses;
+        std::vector<node_ptr> kept_poses;
+        kept_poses.reserve(size());
+        for (auto it = begin(); it != end(); ++it) {
+            if (predicate(getKey(it.ptr), getValue(it.ptr))) {
+                erased_poses.push_back(it.ptr);
+            }
+            else {
+                kept_poses.push_back(it.ptr);
+            }
+        }
+
+        if (erased_poses.size() * REBUILD_ERASE_RATIO >= size()) {
+            std::vector<std::pair<TKey, TValue>> kept;
+            kept.reserve(kept_poses.size());
+            for (node_ptr x : kept_poses) {
+                kept.emplace_back(std::move(tree[x].data.first), std::move(tree[x].data.second));
+            }
+            buildFromSorted(std::move(kept));
+            return erased_poses.size();
+        }
+
+        // Erasing a node with two sons moves the next element into it and rotations do not move
+        // elements, so going from the highest key down keeps the remaining positions valid.
+        count_of_elements -= erased_poses.size();
+        for (auto it = erased_poses.rbegin(); it != erased_poses.rend(); ++it) {
+            erasePosition(*it);
+        }
+        compactFreePoses();
+        return erased_poses.size();
+    }
+
+    // Erases the elements of [first, last) and returns the iterator to the element after them.
+    Iterator eraseRange(Iterator first, Iterator last) {
+        size_t count = 0;
+        for (auto it = first; it != last; ++it) {
+            ++count;
+        }
+
+        if (count * REBUILD_ERASE_RATIO >= size()) {
+            std::optional<TKey> next_key;
+            if (last != end()) {
+                next_key = getKey(last.ptr);
+            }
+            std::vector<std::pair<TKey, TValue>> kept;
+            kept.reserve(size() - count);
+            bool is_inside = false;
+            for (auto it = begin(); it != end(); ++it) {
+                if (it == first) {
+                    is_inside = true;
+                }
+                if (it == last) {
+                    is_inside = false;
+                }
+                if (!is_inside) {
+                    kept.emplace_back(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+                }
+            }
+            buildFromSorted(std::move(kept));
+            return next_key.has_value() ? find(*next_key) : end();
+        }
+
+        // `last` may lose its node when its element moves into an erased one, so the elements are counted.
+        for (; count > 0U; --count) {
+            first = erase(first);
+        }
+        compactFreePoses();
+        return first;
+    }
+
+    // Removes the element and hands its key and value over without copying them.
+    NodeHandle<TKey, TValue> extract(const TKey& key) {
+        return extract(find(key));
+    }
+
+    NodeHandle<TKey, TValue> extract(Iterator it) {
+        if (it == end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        NodeHandle<TKey, TValue> handle(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+        --count_of_elements;
+        erasePosition(it.ptr);
+        return handle;
+    }
+
+    // Inserts the element of the handle. If the key is already present, the handle keeps the element.
+    Iterator insert(NodeHandle<TKey, TValue>&& handle) {
+        if (handle.empty()) {
+            return end();
+        }
+        node_ptr ptr = findPosition(handle.getKey());
+        if (isFictitious(ptr)) {
+            ++count_of_elements;
+            auto data = handle.release();
+            insertPosition(ptr, std::move(data.first), std::move(data.second));
+        }
+        return makeIterator(ptr);
+    }
+
+    // Moves every element of `other` whose key is not in this tree; the rest stay in `other`.
+    void merge(AVLTree<TKey, TValue, TContainer>& other) {
+        auto it = other.begin();
+        while (it != other.end()) {
+            node_ptr source = it.ptr;
+            node_ptr ptr = findPosition(other.getKey(source));
+            if (!isFictitious(ptr)) {
+                ++it;
+                continue;
+            }
+            // Erasing a node with two sons moves the next element into it.
+            if (other.isFictitious(other.getLeftSon(source)) || other.isFictitious(other.getRightSon(source))) {
+                ++it;
+            }
+            ++count_of_elements;
+            insertPosition(ptr, std::move(other.tree[source].data.first), std::move(other.tree[source].data.second));
+            --other.count_of_elements;
+            other.erasePosition(source);
+        }
+    }
+
     Iterator find(const TKey& key) const {
         node_ptr ptr = findPosition(key);
         if (isFictitious(ptr)) {
@@ -422,6 +848,19 @@ public:
         return makeIterator(ptr);
     }
 
+    Iterator find(Iterator from, const TKey& key) const {
+        if (from == end()) {
+            return find(key);
+        }
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr subtree_root = climbFromFinger(from.ptr, key, nearest_pos);
+        lowerBound(key, subtree_root, nearest_pos);
+        if (nearest_pos == NULL_PTR || getKey(nearest_pos) != key) {
+            return end();
+        }
+        return makeIterator(nearest_pos);
+    }
+
     bool isExist(const TKey& key) const {
         return find(key) != end();
     }
@@ -455,4 +894,35 @@ public:
         free_poses.clear();
         root = createNode(-1);
     }
+
+    FrozenTree<TKey, TValue> freeze() const {
+        std::vector<std::pair<TKey, TValue>> sorted_data;
+        sorted_data.reserve(size());
+        for (auto [key, value] : *this) {
+            sorted_data.emplace_back(key, value);
+        }
+        return FrozenTree<TKey, TValue>(std::move(sorted_data));
+    }
+
+    EytzingerIndex<TKey, TValue> toEytzinger() const {
+        std::vector<std::pair<TKey, TValue>> sorted_data;
+        sorted_data.reserve(size());
+        for (auto [key, value] : *this) {
+            sorted_data.emplace_back(key, value);
+        }
+        return EytzingerIndex<TKey, TValue>(std::move(sorted_data));
+    }
+
+    // Makes the current state of a file-backed tree durable: the nodes, the free list and the
+    // root are written as one atomic step, so after a crash the tree reopens as of the last flush.
+    void flush() {
+        tree.getUserData()[0] = static_cast<uint64_t>(root);
+        tree.getUserData()[1] = count_of_elements;
+        tree.flush(free_poses);
+    }
+
+    // Writes a frozen copy of the tree to `path`; FrozenTree::loadSnapshot maps it back.
+    void saveSnapshot(const std::string& path) const {
+        freeze().saveSnapshot(path);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,649 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// B+ tree with up to `Fanout` keys per node. Values live only in the leaves,
+// which are linked into a list for sequential scans. Inner node key i separates
+// children i and i + 1: keys in children[i] are less than it, keys in children[i + 1] are not.
+template <typename TKey, typename TValue, size_t Fanout = 32>
+class BPlusTree {
+    static_assert(Fanout >= 4, "B+ tree fanout must be at least 4");
+
+protected:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+    const static size_t MIN_LEAF_KEYS = Fanout / 2;
+    const static size_t MIN_INNER_KEYS = (Fanout - 1) / 2;
+
+    // Deep enough for any tree that fits into memory.
+    const static size_t MAX_HEIGHT = 32;
+
+    struct LeafNode {
+
+        size_t count;
+
+        node_ptr prev_leaf, next_leaf;
+
+        std::array<TKey, Fanout> keys;
+        std::array<TValue, Fanout> values;
+    };
+
+    struct InnerNode {
+
+        size_t count;
+
+        std::array<TKey, Fanout> keys;
+        std::array<node_ptr, Fanout + 1> children;
+    };
+
+    struct PathEntry {
+        node_ptr node;
+        size_t child_index;
+    };
+
+public:
+
+    class Iterator {
+    protected:
+
+        node_ptr leaf = 0;
+        size_t pos = 0;
+
+        BPlusTree<TKey, TValue, Fanout>* container_ptr;
+
+        Iterator(node_ptr leaf, size_t pos, BPlusTree<TKey, TValue, Fanout>* container_ptr) :
+            leaf(leaf),
+            pos(pos),
+            container_ptr(container_ptr)
+        {}
+
+        struct Pointer {
+            std::pair<const TKey&, TValue&> data;
+
+            std::pair<const TKey&, TValue&>* operator->() {
+                return &data;
+            }
+        };
+
+    public:
+
+        std::pair<const TKey&, TValue&> operator*() const {
+            if (leaf == NULL_PTR) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            return { container_ptr->leaves[leaf].keys[pos], container_ptr->leaves[leaf].values[pos] };
+        }
+
+        Pointer operator->() const {
+            return { **this };
+        }
+
+        Iterator& operator++() {
+            ++pos;
+            if (pos == container_ptr->leaves[leaf].count) {
+                leaf = container_ptr->leaves[leaf].next_leaf;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return this->leaf == other.leaf && this->pos == other.pos;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        friend class BPlusTree;
+    };
+
+protected:
+
+    std::vector<LeafNode> leaves;
+    std::vector<InnerNode> inners;
+
+    std::vector<node_ptr> free_leaves;
+    std::vector<node_ptr> free_inners;
+
+    size_t count_of_elements = 0;
+
+    // Number of inner levels above the leaves: the root is a leaf when it is zero.
+    size_t height = 0;
+
+    node_ptr root;
+
+protected:
+
+    Iterator makeIterator(node_ptr leaf, size_t pos) const {
+        if (leaf != NULL_PTR && pos == leaves[leaf].count) {
+            leaf = leaves[leaf].next_leaf;
+            pos = 0;
+        }
+        if (leaf == NULL_PTR) {
+            pos = 0;
+        }
+        return Iterator(leaf, pos, const_cast<BPlusTree<TKey, TValue, Fanout>*>(this));
+    }
+
+    node_ptr createLeaf() {
+        if (free_leaves.empty()) {
+            free_leaves.push_back(static_cast<node_ptr>(leaves.size()));
+            leaves.push_back(LeafNode());
+        }
+        node_ptr ptr = free_leaves.back();
+        free_leaves.pop_back();
+
+        leaves[ptr].count = 0U;
+        leaves[ptr].prev_leaf = NULL_PTR;
+        leaves[ptr].next_leaf = NULL_PTR;
+
+        return ptr;
+    }
+
+    node_ptr createInner() {
+        if (free_inners.empty()) {
+            free_inners.push_back(static_cast<node_ptr>(inners.size()));
+            inners.push_back(InnerNode());
+        }
+        node_ptr ptr = free_inners.back();
+        free_inners.pop_back();
+
+        inners[ptr].count = 0U;
+
+        return ptr;
+    }
+
+    void deleteLeaf(node_ptr ptr) {
+        free_leaves.push_back(ptr);
+    }
+
+    void deleteInner(node_ptr ptr) {
+        free_inners.push_back(ptr);
+    }
+
+protected:
+
+    constexpr static bool hasVectorSearch() {
+#if defined(__AVX2__)
+        return std::is_integral_v<TKey> && std::is_signed_v<TKey> && sizeof(TKey) == 4U;
+#else
+        return false;
+#endif
+    }
+
+    // Number of keys among the first `count` that are less than `key` (or not greater than it
+    // when `inclusive` is set). Arithmetic keys are counted without branches so that the loop
+    // vectorizes; signed 32-bit keys use AVX2 explicitly when it is enabled.
+    template <bool inclusive>
+    static size_t countBelow(const std::array<TKey, Fanout>& keys, size_t count, const TKey& key) {
+        if constexpr (std::is_arithmetic_v<TKey>) {
+            size_t result = 0;
+            size_t i = 0;
+#if defined(__AVX2__)
+            if constexpr (hasVectorSearch()) {
+                __m256i key_vec = _mm256_set1_epi32(key);
+                for (; i + 8 <= count; i += 8) {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys.data() + i));
+                    __m256i mask;
+                    if constexpr (inclusive) {
+                        mask = _mm256_cmpgt_epi32(block, key_vec);
+                        result += 8U - std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))));
+                    }
+                    else {
+                        mask = _mm256_cmpgt_epi32(key_vec, block);
+                        result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))));
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                if constexpr (inclusive) {
+                    result += static_cast<size_t>(keys[i] <= key);
+                }
+                else {
+                    result += static_cast<size_t>(keys[i] < key);
+                }
+            }
+            return result;
+        }
+        else if constexpr (inclusive) {
+            return std::upper_bound(keys.begin(), keys.begin() + count, key) - keys.begin();
+        }
+        else {
+            return std::lower_bound(keys.begin(), keys.begin() + count, key) - keys.begin();
+        }
+    }
+
+    // Descends to the leaf that may contain `key`, remembering the inner nodes on the way.
+    node_ptr findLeaf(const TKey& key, PathEntry* path) const {
+        node_ptr x = root;
+        for (size_t level = 0; level < height; ++level) {
+            size_t child_index = countBelow<true>(inners[x].keys, inners[x].count, key);
+            if (path != nullptr) {
+                path[level] = { x, child_index };
+            }
+            x = inners[x].children[child_index];
+        }
+        return x;
+    }
+
+    node_ptr getLowestLeaf() const {
+        node_ptr x = root;
+        for (size_t level = 0; level < height; ++level) {
+            x = inners[x].children[0];
+        }
+        return x;
+    }
+
+protected:
+
+    void insertIntoLeaf(node_ptr leaf, size_t pos, const TKey& key, const TValue& value) {
+        LeafNode& node = leaves[leaf];
+        for (size_t i = node.count; i > pos; --i) {
+            node.keys[i] = std::move(node.keys[i - 1]);
+            node.values[i] = std::move(node.values[i - 1]);
+        }
+        node.keys[pos] = key;
+        node.values[pos] = value;
+        ++node.count;
+    }
+
+    void eraseFromLeaf(node_ptr leaf, size_t pos) {
+        LeafNode& node = leaves[leaf];
+        for (size_t i = pos; i + 1 < node.count; ++i) {
+            node.keys[i] = std::move(node.keys[i + 1]);
+            node.values[i] = std::move(node.values[i + 1]);
+        }
+        --node.count;
+    }
+
+    // Inserts `key` at position `pos` and the child to the right of it.
+    void insertIntoInner(node_ptr inner, size_t pos, const TKey& key, node_ptr right_child) {
+        InnerNode& node = inners[inner];
+        for (size_t i = node.count; i > pos; --i) {
+            node.keys[i] = std::move(node.keys[i - 1]);
+            node.children[i + 1] = node.children[i];
+        }
+        node.keys[pos] = key;
+        node.children[pos + 1] = right_child;
+        ++node.count;
+    }
+
+    // Removes key `pos` together with the child to the right of it.
+    void eraseFromInner(node_ptr inner, size_t pos) {
+        InnerNode& node = inners[inner];
+        for (size_t i = pos; i + 1 < node.count; ++i) {
+            node.keys[i] = std::move(node.keys[i + 1]);
+            node.children[i + 1] = node.children[i + 2];
+        }
+        --node.count;
+    }
+
+    // Moves the upper half of a full leaf into a new leaf linked after it.
+    node_ptr splitLeaf(node_ptr leaf) {
+        node_ptr right = createLeaf();
+
+        LeafNode& left_node = leaves[leaf];
+        LeafNode& right_node = leaves[right];
+
+        size_t left_count = Fanout / 2;
+        for (size_t i = left_count; i < Fanout; ++i) {
+            right_node.keys[i - left_count] = std::move(left_node.keys[i]);
+            right_node.values[i - left_count] = std::move(left_node.values[i]);
+        }
+        right_node.count = Fanout - left_count;
+        left_node.count = left_count;
+
+        right_node.next_leaf = left_node.next_leaf;
+        right_node.prev_leaf = leaf;
+        if (left_node.next_leaf != NULL_PTR) {
+            leaves[left_node.next_leaf].prev_leaf = right;
+        }
+        left_node.next_leaf = right;
+
+        return right;
+    }
+
+    // Moves the keys after the middle one into a new node; the middle key goes to `separator`.
+    node_ptr splitInner(node_ptr inner, TKey& separator) {
+        node_ptr right = createInner();
+
+        InnerNode& left_node = inners[inner];
+        InnerNode& right_node = inners[right];
+
+        size_t mid = Fanout / 2;
+        separator = std::move(left_node.keys[mid]);
+        for (size_t i = mid + 1; i < Fanout; ++i) {
+            right_node.keys[i - mid - 1] = std::move(left_node.keys[i]);
+        }
+        for (size_t i = mid + 1; i <= Fanout; ++i) {
+            right_node.children[i - mid - 1] = left_node.children[i];
+        }
+        right_node.count = Fanout - mid - 1;
+        left_node.count = mid;
+
+        return right;
+    }
+
+    // Links `right` (split off a node at `level`) and its first key into the parents.
+    void insertIntoParent(PathEntry* path, size_t level, TKey separator, node_ptr right) {
+        while (level > 0) {
+            --level;
+            node_ptr parent = path[level].node;
+            size_t pos = path[level].child_index;
+
+            if (inners[parent].count < Fanout) {
+                insertIntoInner(parent, pos, separator, right);
+                return;
+            }
+
+            TKey up_key;
+            node_ptr parent_right = splitInner(parent, up_key);
+            size_t left_count = inners[parent].count;
+            if (pos <= left_count) {
+                insertIntoInner(parent, pos, separator, right);
+            }
+            else {
+                insertIntoInner(parent_right, pos - left_count - 1, separator, right);
+            }
+
+            separator = std::move(up_key);
+            right = parent_right;
+        }
+
+        node_ptr new_root = createInner();
+        inners[new_root].count = 1U;
+        inners[new_root].keys[0] = std::move(separator);
+        inners[new_root].children[0] = root;
+        inners[new_root].children[1] = right;
+
+        root = new_root;
+        ++height;
+    }
+
+    void fixLeafUnderflow(PathEntry* path, node_ptr leaf) {
+        if (height == 0U || leaves[leaf].count >= MIN_LEAF_KEYS) {
+            return;
+        }
+
+        node_ptr parent = path[height - 1].node;
+        size_t child_index = path[height - 1].child_index;
+
+        if (child_index > 0) {
+            node_ptr left = inners[parent].children[child_index - 1];
+            if (leaves[left].count > MIN_LEAF_KEYS) {
+                LeafNode& left_node = leaves[left];
+                insertIntoLeaf(leaf, 0U, left_node.keys[left_node.count - 1], left_node.values[left_node.count - 1]);
+                eraseFromLeaf(left, left_node.count - 1);
+                inners[parent].keys[child_index - 1] = leaves[leaf].keys[0];
+                return;
+            }
+        }
+        if (child_index < inners[parent].count) {
+            node_ptr right = inners[parent].children[child_index + 1];
+            if (leaves[right].count > MIN_LEAF_KEYS) {
+                LeafNode& right_node = leaves[right];
+                insertIntoLeaf(leaf, leaves[leaf].count, right_node.keys[0], right_node.values[0]);
+                eraseFromLeaf(right, 0U);
+                inners[parent].keys[child_index] = leaves[right].keys[0];
+                return;
+            }
+        }
+
+        if (child_index > 0) {
+            mergeLeaves(inners[parent].children[child_index - 1], leaf);
+            eraseFromInner(parent, child_index - 1);
+        }
+        else {
+            mergeLeaves(leaf, inners[parent].children[child_index + 1]);
+            eraseFromInner(parent, child_index);
+        }
+
+        fixInnerUnderflow(path, height - 1);
+    }
+
+    // Appends `right` to `left` and frees it.
+    void mergeLeaves(node_ptr left, node_ptr right) {
+        LeafNode& left_node = leaves[left];
+        LeafNode& right_node = leaves[right];
+
+        for (size_t i = 0; i < right_node.count; ++i) {
+            left_node.keys[left_node.count + i] = std::move(right_node.keys[i]);
+            left_node.values[left_node.count + i] = std::move(right_node.values[i]);
+        }
+        left_node.count += right_node.count;
+
+        left_node.next_leaf = right_node.next_leaf;
+        if (right_node.next_leaf != NULL_PTR) {
+            leaves[right_node.next_leaf].prev_leaf = left;
+        }
+
+        deleteLeaf(right);
+    }
+
+    void fixInnerUnderflow(PathEntry* path, size_t level) {
+        node_ptr x = path[level].node;
+
+        if (level == 0U) {
+            if (inners[x].count == 0U) {
+                root = inners[x].children[0];
+                deleteInner(x);
+                --height;
+            }
+            return;
+        }
+        if (inners[x].count >= MIN_INNER_KEYS) {
+            return;
+        }
+
+        node_ptr parent = path[level - 1].node;
+        size_t child_index = path[level - 1].child_index;
+
+        if (child_index > 0) {
+            node_ptr left = inners[parent].children[child_index - 1];
+            if (inners[left].count > MIN_INNER_KEYS) {
+                InnerNode& node = inners[x];
+                InnerNode& left_node = inners[left];
+
+                for (size_t i = node.count; i > 0; --i) {
+                    node.keys[i] = std::move(node.keys[i - 1]);
+                }
+                for (size_t i = node.count + 1; i > 0; --i) {
+                    node.children[i] = node.children[i - 1];
+                }
+                node.keys[0] = std::move(inners[parent].keys[child_index - 1]);
+                node.children[0] = left_node.children[left_node.count];
+                ++node.count;
+
+                inners[parent].keys[child_index - 1] = std::move(left_node.keys[left_node.count - 1]);
+                --left_node.count;
+                return;
+            }
+        }
+        if (child_index < inners[parent].count) {
+            node_ptr right = inners[parent].children[child_index + 1];
+            if (inners[right].count > MIN_INNER_KEYS) {
+                InnerNode& node = inners[x];
+                InnerNode& right_node = inners[right];
+
+                node.keys[node.count] = std::move(inners[parent].keys[child_index]);
+                node.children[node.count + 1] = right_node.children[0];
+                ++node.count;
+
+                inners[parent].keys[child_index] = std::move(right_node.keys[0]);
+                for (size_t i = 0; i + 1 < right_node.count; ++i) {
+                    right_node.keys[i] = std::move(right_node.keys[i + 1]);
+                }
+                for (size_t i = 0; i < right_node.count; ++i) {
+                    right_node.children[i] = right_node.children[i + 1];
+                }
+                --right_node.count;
+                return;
+            }
+        }
+
+        if (child_index > 0) {
+            mergeInners(inners[parent].children[child_index - 1], x, inners[parent].keys[child_index - 1]);
+            eraseFromInner(parent, child_index - 1);
+        }
+        else {
+            mergeInners(x, inners[parent].children[child_index + 1], inners[parent].keys[child_index]);
+            eraseFromInner(parent, child_index);
+        }
+
+        fixInnerUnderflow(path, level - 1);
+    }
+
+    // Appends the separator and `right` to `left` and frees `right`.
+    void mergeInners(node_ptr left, node_ptr right, const TKey& separator) {
+        InnerNode& left_node = inners[left];
+        InnerNode& right_node = inners[right];
+
+        left_node.keys[left_node.count] = separator;
+        for (size_t i = 0; i < right_node.count; ++i) {
+            left_node.keys[left_node.count + 1 + i] = std::move(right_node.keys[i]);
+        }
+        for (size_t i = 0; i <= right_node.count; ++i) {
+            left_node.children[left_node.count + 1 + i] = right_node.children[i];
+        }
+        left_node.count += right_node.count + 1;
+
+        deleteInner(right);
+    }
+
+public:
+
+    BPlusTree() {
+        root = createLeaf();
+    }
+
+    Iterator begin() const {
+        return makeIterator(getLowestLeaf(), 0U);
+    }
+
+    Iterator end() const {
+        return makeIterator(NULL_PTR, 0U);
+    }
+
+    Iterator lowerBound(const TKey& key) const {
+        node_ptr leaf = findLeaf(key, nullptr);
+        return makeIterator(leaf, countBelow<false>(leaves[leaf].keys, leaves[leaf].count, key));
+    }
+
+    Iterator upperBound(const TKey& key) const {
+        node_ptr leaf = findLeaf(key, nullptr);
+        return makeIterator(leaf, countBelow<true>(leaves[leaf].keys, leaves[leaf].count, key));
+    }
+
+    Iterator insert(const TKey& key, const TValue& value) {
+        PathEntry path[MAX_HEIGHT];
+        node_ptr leaf = findLeaf(key, path);
+        size_t pos = countBelow<false>(leaves[leaf].keys, leaves[leaf].count, key);
+
+        if (pos < leaves[leaf].count && leaves[leaf].keys[pos] == key) {
+            return makeIterator(leaf, pos);
+        }
+
+        ++count_of_elements;
+
+        if (leaves[leaf].count < Fanout) {
+            insertIntoLeaf(leaf, pos, key, value);
+            return makeIterator(leaf, pos);
+        }
+
+        node_ptr right = splitLeaf(leaf);
+        size_t left_count = leaves[leaf].count;
+        if (pos <= left_count) {
+            insertIntoLeaf(leaf, pos, key, value);
+        }
+        else {
+            insertIntoLeaf(right, pos - left_count, key, value);
+        }
+        insertIntoParent(path, height, leaves[right].keys[0], right);
+
+        if (pos <= left_count) {
+            return makeIterator(leaf, pos);
+        }
+        return makeIterator(right, pos - left_count);
+    }
+
+    Iterator erase(const TKey& key) {
+        return erase(find(key));
+    }
+
+    Iterator erase(Iterator it) {
+        if (it == end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        TKey key = it->first;
+
+        PathEntry path[MAX_HEIGHT];
+        node_ptr leaf = findLeaf(key, path);
+
+        --count_of_elements;
+        eraseFromLeaf(leaf, it.pos);
+        fixLeafUnderflow(path, leaf);
+
+        return upperBound(key);
+    }
+
+    Iterator find(const TKey& key) const {
+        node_ptr leaf = findLeaf(key, nullptr);
+        size_t pos = countBelow<false>(leaves[leaf].keys, leaves[leaf].count, key);
+        if (pos < leaves[leaf].count && leaves[leaf].keys[pos] == key) {
+            return makeIterator(leaf, pos);
+        }
+        return end();
+    }
+
+    bool isExist(const TKey& key) const {
+        return find(key) != end();
+    }
+
+    TValue& operator[](const TKey& key) {
+        if (!isExist(key)) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*find(key)).second;
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        if (!isExist(key)) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*find(key)).second;
+    }
+
+    size_t size() const {
+        return count_of_elements;
+    }
+
+    bool empty() const {
+        return count_of_elements == 0U;
+    }
+
+    void clear() {
+        leaves.clear();
+        inners.clear();
+        free_leaves.clear();
+        free_inners.clear();
+
+        count_of_elements = 0U;
+        height = 0U;
+
+        root = createLeaf();
+    }
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// One update of a sorted batch given to applyBatch.
+template <typename TKey, typename TValue>
+struct BatchOperation {
+    enum class Type {
+        // Inserts the element or overwrites the value of an existing one.
+        UPSERT,
+        // Erases the key if it is present.
+        ERASE
+    };
+
+    Type type;
+    TKey key;
+    TValue value;
+};
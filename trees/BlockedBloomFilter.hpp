@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Bloom filter whose probes for a key all fall into one 64-byte block,
+// so a query costs a single cache miss.
+template <typename TKey, typename THash = std::hash<TKey>>
+class BlockedBloomFilter {
+protected:
+
+    const static size_t WORDS_PER_BLOCK = 8;
+    const static size_t BITS_PER_KEY = 12;
+
+    struct alignas(64) Block {
+        std::array<uint64_t, WORDS_PER_BLOCK> words{};
+    };
+
+    std::vector<Block> blocks;
+
+protected:
+
+    // std::hash of integers is often the identity, so the bits are mixed again.
+    static uint64_t getHash(const TKey& key) {
+        uint64_t hash = static_cast<uint64_t>(THash()(key));
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // The high half of the hash picks the block.
+    const Block& getBlock(uint64_t hash) const {
+        return blocks[static_cast<size_t>(((hash >> 32) * blocks.size()) >> 32)];
+    }
+
+    // One bit in each word of the block, chosen by 6 bits of a rehash apiece.
+    static uint64_t getBit(uint64_t hash, size_t word) {
+        uint64_t bits = hash * 0x9E3779B97F4A7C15ULL;
+        return uint64_t(1) << ((bits >> (6U * word + 16U)) & 63U);
+    }
+
+public:
+
+    explicit BlockedBloomFilter(size_t expected_keys = 0) {
+        reset(expected_keys);
+    }
+
+    // Empties the filter and sizes it for `expected_keys` keys.
+    void reset(size_t expected_keys) {
+        size_t count_of_blocks = std::max<size_t>(1U, expected_keys * BITS_PER_KEY / (64U * WORDS_PER_BLOCK) + 1U);
+        blocks.assign(count_of_blocks, Block());
+    }
+
+    void add(const TKey& key) {
+        uint64_t hash = getHash(key);
+        Block& block = const_cast<Block&>(getBlock(hash));
+        for (size_t word = 0; word < WORDS_PER_BLOCK; ++word) {
+            block.words[word] |= getBit(hash, word);
+        }
+    }
+
+    // False means that the key was never added.
+    bool mayContain(const TKey& key) const {
+        uint64_t hash = getHash(key);
+        const Block& block = getBlock(hash);
+        bool result = true;
+        for (size_t word = 0; word < WORDS_PER_BLOCK; ++word) {
+            result &= (block.words[word] & getBit(hash, word)) != 0U;
+        }
+        return result;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "BlockedBloomFilter.hpp"
+#include "RedBlackTree.hpp"
+
+// Tree with a Bloom filter sidecar: lookups of keys that were never inserted
+// are answered by the filter without walking the tree.
+// Erased keys stay in the filter until it is rebuilt, which happens once there are
+// as many of them as live keys, or when the tree outgrows the size the filter was built for.
+// The tree is inherited non-publicly: only the operations that keep the filter in sync are exposed.
+template <typename TKey, typename TValue, typename TTree = RedBlackTree<TKey, TValue>>
+class BloomFilteredTree : protected TTree {
+protected:
+
+    constexpr static size_t MIN_FILTER_CAPACITY = 1024;
+
+    using Iterator = decltype(std::declval<TTree&>().begin());
+
+    BlockedBloomFilter<TKey> filter;
+
+    size_t filter_capacity = 0;
+    size_t count_of_stale_keys = 0;
+
+protected:
+
+    void rebuildFilter() {
+        filter_capacity = std::max(MIN_FILTER_CAPACITY, TTree::size() * 2U);
+        filter.reset(filter_capacity);
+        for (auto [key, value] : *this) {
+            filter.add(key);
+        }
+        count_of_stale_keys = 0;
+    }
+
+public:
+
+    using TTree::begin;
+    using TTree::end;
+    using TTree::lowerBound;
+    using TTree::upperBound;
+    using TTree::size;
+    using TTree::empty;
+
+    BloomFilteredTree() {
+        rebuildFilter();
+    }
+
+    Iterator insert(const TKey& key, const TValue& value) {
+        if (TTree::size() + count_of_stale_keys >= filter_capacity) {
+            rebuildFilter();
+        }
+        filter.add(key);
+        return TTree::insert(key, value);
+    }
+
+    Iterator erase(const TKey& key) {
+        return erase(find(key));
+    }
+
+    Iterator erase(Iterator it) {
+        if (it == TTree::end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        auto result = TTree::erase(it);
+        if (++count_of_stale_keys > std::max(MIN_FILTER_CAPACITY, TTree::size())) {
+            rebuildFilter();
+        }
+        return result;
+    }
+
+    Iterator find(const TKey& key) const {
+        if (!filter.mayContain(key)) {
+            return TTree::end();
+        }
+        return TTree::find(key);
+    }
+
+    bool isExist(const TKey& key) const {
+        return filter.mayContain(key) && TTree::isExist(key);
+    }
+
+    TValue& operator[](const TKey& key) {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    void clear() {
+        TTree::clear();
+        rebuildFilter();
+    }
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.hpp"
+
+// Log-structured write buffer in front of a tree.
+// Updates are appended to a small run instead of descending into the tree; once the
+// run is full it is sorted and merged into the tree in key order, so consecutive
+// descents share the top of their path in cache. Reads see the merged view of both
+// (a read sorts the run first if new updates arrived).
+//
+// Writes are blind: erasing a missing key is a no-op, and insert() does not look into
+// the tree, so whether it takes effect is only known when the buffer is merged.
+template <typename TKey, typename TValue, typename TTree = AVLTree<TKey, TValue>>
+class BufferedTree {
+protected:
+
+    enum class EntryType {
+        // Inserts the value unless the key is already in the tree.
+        INSERT,
+        // Overwrites or inserts the value.
+        ASSIGN,
+        // The key is erased.
+        TOMBSTONE
+    };
+
+    struct Entry {
+        std::pair<TKey, TValue> data;
+        EntryType type;
+    };
+
+    using TreeIterator = decltype(std::declval<TTree&>().begin());
+
+public:
+
+    class Iterator {
+    protected:
+
+        size_t buffer_pos;
+        TreeIterator tree_it;
+
+        // Whether the current element is taken from the buffer or from the tree.
+        bool is_from_buffer = false;
+
+        BufferedTree<TKey, TValue, TTree>* container_ptr;
+
+        Iterator(size_t buffer_pos, TreeIterator tree_it, BufferedTree<TKey, TValue, TTree>* container_ptr) :
+            buffer_pos(buffer_pos),
+            tree_it(tree_it),
+            container_ptr(container_ptr)
+        {
+            settle();
+        }
+
+        bool hasBuffer() const {
+            return buffer_pos < container_ptr->buffer.size();
+        }
+
+        bool hasTree() const {
+            return tree_it != container_ptr->tree.end();
+        }
+
+        const Entry& getEntry() const {
+            return container_ptr->buffer[buffer_pos];
+        }
+
+        // Moves to the first position that holds a visible element.
+        void settle() {
+            while (hasBuffer()) {
+                const Entry& entry = getEntry();
+                if (hasTree() && tree_it->first < entry.data.first) {
+                    is_from_buffer = false;
+                    return;
+                }
+                bool is_shadowing = hasTree() && tree_it->first == entry.data.first;
+                if (entry.type == EntryType::TOMBSTONE) {
+                    ++buffer_pos;
+                    if (is_shadowing) {
+                        ++tree_it;
+                    }
+                    continue;
+                }
+                is_from_buffer = !(is_shadowing && entry.type == EntryType::INSERT);
+                return;
+            }
+            is_from_buffer = false;
+        }
+
+    public:
+
+        const std::pair<const TKey&, const TValue&> operator*() const {
+            if (!hasBuffer() && !hasTree()) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            const std::pair<TKey, TValue>& data = *operator->();
+            return { data.first, data.second };
+        }
+
+        const std::pair<TKey, TValue>* operator->() const {
+            if (is_from_buffer) {
+                return &getEntry().data;
+            }
+            return tree_it.operator->();
+        }
+
+        Iterator& operator++() {
+            TKey key = operator->()->first;
+            if (hasBuffer() && getEntry().data.first == key) {
+                ++buffer_pos;
+            }
+            if (hasTree() && tree_it->first == key) {
+                ++tree_it;
+            }
+            settle();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return buffer_pos == other.buffer_pos && tree_it == other.tree_it;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        friend class BufferedTree;
+    };
+
+protected:
+
+    TTree tree;
+
+    // Entries in arrival order; normalize() sorts them and keeps one entry per key.
+    mutable std::vector<Entry> buffer;
+    mutable bool is_normalized = true;
+
+    size_t buffer_capacity;
+
+protected:
+
+    Iterator makeIterator(size_t buffer_pos, TreeIterator tree_it) const {
+        return Iterator(buffer_pos, tree_it, const_cast<BufferedTree<TKey, TValue, TTree>*>(this));
+    }
+
+    // Folds the updates of each key, oldest first, into a single entry.
+    static void combine(Entry& older, const Entry& newer) {
+        if (newer.type == EntryType::INSERT) {
+            // An older entry already decides whether the key exists.
+            if (older.type != EntryType::TOMBSTONE) {
+                return;
+            }
+            older.data.second = newer.data.second;
+            older.type = EntryType::ASSIGN;
+            return;
+        }
+        older = newer;
+    }
+
+    void normalize() const {
+        if (is_normalized) {
+            return;
+        }
+        std::stable_sort(buffer.begin(), buffer.end(), [](const Entry& lhs, const Entry& rhs) {
+            return lhs.data.first < rhs.data.first;
+        });
+
+        size_t count = 0;
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            if (count > 0U && buffer[count - 1].data.first == buffer[i].data.first) {
+                combine(buffer[count - 1], buffer[i]);
+            }
+            else {
+                buffer[count++] = buffer[i];
+            }
+        }
+        buffer.resize(count);
+        is_normalized = true;
+    }
+
+    typename std::vector<Entry>::const_iterator findEntry(const TKey& key) const {
+        normalize();
+        return std::lower_bound(buffer.cbegin(), buffer.cend(), key, [](const Entry& entry, const TKey& key) {
+            return entry.data.first < key;
+        });
+    }
+
+    void put(const TKey& key, const TValue& value, EntryType type) {
+        // Appending in increasing key order keeps the buffer normalized.
+        if (!buffer.empty() && !(buffer.back().data.first < key)) {
+            is_normalized = false;
+        }
+        buffer.push_back(Entry{ { key, value }, type });
+        if (buffer.size() >= buffer_capacity) {
+            flush();
+        }
+    }
+
+public:
+
+    explicit BufferedTree(size_t buffer_capacity = 1024) :
+        buffer_capacity(std::max<size_t>(buffer_capacity, 1U))
+    {
+        buffer.reserve(this->buffer_capacity);
+    }
+
+    Iterator begin() const {
+        normalize();
+        return makeIterator(0U, tree.begin());
+    }
+
+    Iterator end() const {
+        normalize();
+        return makeIterator(buffer.size(), tree.end());
+    }
+
+    Iterator lowerBound(const TKey& key) {
+        return makeIterator(findEntry(key) - buffer.cbegin(), tree.lowerBound(key));
+    }
+
+    Iterator upperBound(const TKey& key) {
+        normalize();
+        auto it = std::upper_bound(buffer.begin(), buffer.end(), key, [](const TKey& key, const Entry& entry) {
+            return key < entry.data.first;
+        });
+        return makeIterator(it - buffer.begin(), tree.upperBound(key));
+    }
+
+    Iterator find(const TKey& key) {
+        auto it = lowerBound(key);
+        if (it == end() || it->first != key) {
+            return end();
+        }
+        return it;
+    }
+
+    bool isExist(const TKey& key) const {
+        auto it = findEntry(key);
+        if (it != buffer.end() && it->data.first == key) {
+            return it->type != EntryType::TOMBSTONE;
+        }
+        return tree.isExist(key);
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        auto it = findEntry(key);
+        if (it != buffer.end() && it->data.first == key) {
+            if (it->type == EntryType::TOMBSTONE) {
+                throw std::runtime_error("No such key in table");
+            }
+            if (it->type == EntryType::ASSIGN || !tree.isExist(key)) {
+                return it->data.second;
+            }
+        }
+        return tree[key];
+    }
+
+    // Inserts the element unless the key is already present.
+    void insert(const TKey& key, const TValue& value) {
+        put(key, value, EntryType::INSERT);
+    }
+
+    // Inserts the element or overwrites the value of an existing one.
+    void assign(const TKey& key, const TValue& value) {
+        put(key, value, EntryType::ASSIGN);
+    }
+
+    void erase(const TKey& key) {
+        put(key, TValue(), EntryType::TOMBSTONE);
+    }
+
+    // Merges the buffer into the tree in key order.
+    void flush() {
+        normalize();
+        for (const Entry& entry : buffer) {
+            const TKey& key = entry.data.first;
+            switch (entry.type) {
+            case EntryType::INSERT:
+                tree.insert(key, entry.data.second);
+                break;
+            case EntryType::ASSIGN: {
+                auto it = tree.find(key);
+                if (it == tree.end()) {
+                    tree.insert(key, entry.data.second);
+                }
+                else {
+                    it->second = entry.data.second;
+                }
+                break;
+            }
+            case EntryType::TOMBSTONE:
+                if (tree.isExist(key)) {
+                    tree.erase(key);
+                }
+                break;
+            }
+        }
+        buffer.clear();
+    }
+
+    // The exact size is only known after a merge, so this flushes the buffer first.
+    size_t size() {
+        flush();
+        return tree.size();
+    }
+
+    bool empty() const {
+        return begin() == end();
+    }
+
+    void clear() {
+        buffer.clear();
+        is_normalized = true;
+        tree.clear();
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <utility>
+
+// Growable array whose elements never move: storage is a list of chunks of
+// geometrically growing size, and growth only appends a new chunk.
+// A single writer may grow it while other threads read published elements
+// through tryGet(). clear() keeps the chunks, so memory a reader may still
+// look at stays valid for the lifetime of the container.
+template <typename T>
+class ChunkedVector {
+protected:
+
+    const static size_t FIRST_CHUNK_BITS = 10;
+    const static size_t MAX_CHUNKS = 48;
+
+    std::array<std::atomic<T*>, MAX_CHUNKS> chunks{};
+
+    size_t count_of_chunks = 0;
+    std::atomic<size_t> count_of_elements = 0;
+
+protected:
+
+    static size_t getChunkIndex(size_t index) {
+        return std::bit_width((index >> FIRST_CHUNK_BITS) + 1U) - 1U;
+    }
+
+    static size_t getChunkBegin(size_t chunk) {
+        return ((size_t(1) << chunk) - 1U) << FIRST_CHUNK_BITS;
+    }
+
+    static size_t getChunkSize(size_t chunk) {
+        return size_t(1) << (chunk + FIRST_CHUNK_BITS);
+    }
+
+    T& at(size_t index) const {
+        size_t chunk = getChunkIndex(index);
+        return chunks[chunk].load(std::memory_order_relaxed)[index - getChunkBegin(chunk)];
+    }
+
+    void reserveSlot(size_t index) {
+        size_t chunk = getChunkIndex(index);
+        if (chunk >= count_of_chunks) {
+            chunks[chunk].store(new T[getChunkSize(chunk)], std::memory_order_release);
+            count_of_chunks = chunk + 1U;
+        }
+    }
+
+public:
+
+    // Trees over this container store what readers load with relaxed atomics, see RedBlackTree.
+    constexpr static bool IS_READ_CONCURRENTLY = true;
+
+    ChunkedVector() = default;
+
+    ChunkedVector(const ChunkedVector&) = delete;
+    ChunkedVector& operator=(const ChunkedVector&) = delete;
+
+    ~ChunkedVector() {
+        for (size_t chunk = 0; chunk < count_of_chunks; ++chunk) {
+            delete[] chunks[chunk].load(std::memory_order_relaxed);
+        }
+    }
+
+    T& operator[](size_t index) {
+        return at(index);
+    }
+
+    const T& operator[](size_t index) const {
+        return at(index);
+    }
+
+    // Safe to call concurrently with the writer: returns nullptr if the chunk holding
+    // `index` has not been published yet.
+    const T* tryGet(size_t index) const {
+        size_t chunk = getChunkIndex(index);
+        if (chunk >= MAX_CHUNKS) {
+            return nullptr;
+        }
+        const T* base = chunks[chunk].load(std::memory_order_acquire);
+        if (base == nullptr) {
+            return nullptr;
+        }
+        return base + (index - getChunkBegin(chunk));
+    }
+
+    void push_back(const T& value) {
+        size_t index = size();
+        reserveSlot(index);
+        at(index) = value;
+        count_of_elements.store(index + 1U, std::memory_order_release);
+    }
+
+    void push_back(T&& value) {
+        size_t index = size();
+        reserveSlot(index);
+        at(index) = std::move(value);
+        count_of_elements.store(index + 1U, std::memory_order_release);
+    }
+
+    // Appends an element without writing to it: the slot holds a default-constructed element or,
+    // after clear(), the one it held before, which a reader may still be copying.
+    void extend() {
+        size_t index = size();
+        reserveSlot(index);
+        count_of_elements.store(index + 1U, std::memory_order_release);
+    }
+
+    void pop_back() {
+        count_of_elements.store(size() - 1U, std::memory_order_release);
+    }
+
+    T& back() {
+        return at(size() - 1U);
+    }
+
+    const T& back() const {
+        return at(size() - 1U);
+    }
+
+    size_t size() const {
+        return count_of_elements.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0U;
+    }
+
+    void clear() {
+        count_of_elements.store(0U, std::memory_order_release);
+    }
+};
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "ChunkedVector.hpp"
+#include "EpochManager.hpp"
+#include "RedBlackTree.hpp"
+#include "RelaxedAtomic.hpp"
+
+// Red-black tree for many readers and one writer at a time.
+//
+// Readers never lock: they walk the tree optimistically and validate the walk
+// against a per-tree version counter (a seqlock), retrying if a write overlapped it.
+// Nodes live in a ChunkedVector, so a racing reader only ever looks at valid memory,
+// and the slots freed by erase are parked until every reader that might still be
+// holding them has finished (epoch-based reclamation).
+// Speculative reads copy links, keys and values before they are validated, so both sides
+// access them with relaxed atomics (the writer through RedBlackTree, which does so over a
+// ChunkedVector); this is why keys and values have to be trivially copyable.
+template <typename TKey, typename TValue>
+class ConcurrentRedBlackTree : protected RedBlackTree<TKey, TValue, ChunkedVector> {
+    static_assert(std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>,
+                  "Optimistic readers copy keys and values while they may be changing");
+
+protected:
+
+    using Base = RedBlackTree<TKey, TValue, ChunkedVector>;
+
+    using typename Base::node_ptr;
+    using typename Base::Node;
+
+    using Base::NULL_PTR;
+
+    // Longer walks than this mean that the reader raced with a writer.
+    const static size_t MAX_WALK = 256;
+
+    // Number of elements forEach copies out under one validation.
+    const static size_t SCAN_BATCH = 64;
+
+    // Retired slots are handed back to the free list in batches of this size.
+    const static size_t RECLAIM_BATCH = 256;
+
+    alignas(64) std::atomic<uint64_t> version = 0;
+    std::atomic<size_t> published_size = 0;
+
+    std::mutex writer_mutex;
+
+    mutable EpochManager epochs;
+    std::deque<std::pair<uint64_t, node_ptr>> retired;
+
+protected:
+
+    const Node* peek(node_ptr x) const {
+        if (x < 0) {
+            return nullptr;
+        }
+        return this->tree.tryGet(static_cast<size_t>(x));
+    }
+
+    static std::pair<TKey, TValue> loadData(const Node* node) {
+        return { loadRelaxed(node->data.first), loadRelaxed(node->data.second) };
+    }
+
+    // Runs `reader` until it completes without a concurrent write.
+    // `reader` returns false when what it saw was inconsistent.
+    template <typename TReader>
+    void readOptimistically(TReader reader) const {
+        auto guard = epochs.pin();
+        while (true) {
+            uint64_t before = version.load(std::memory_order_acquire);
+            if (before % 2U == 0U && reader()) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version.load(std::memory_order_relaxed) == before) {
+                    return;
+                }
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Speculative counterparts of the tree walks: they return NULL_PTR for "no such node"
+    // and nullopt when the walk went astray.
+    std::optional<node_ptr> peekBound(const TKey& key, bool inclusive) const {
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr x = loadRelaxed(this->root);
+        for (size_t step = 0; step < MAX_WALK; ++step) {
+            const Node* node = peek(x);
+            if (node == nullptr) {
+                return std::nullopt;
+            }
+            if (loadRelaxed(node->is_fictitious)) {
+                return nearest_pos;
+            }
+            TKey node_key = loadRelaxed(node->data.first);
+            if (node_key > key || (inclusive && node_key == key)) {
+                nearest_pos = x;
+                x = loadRelaxed(node->left_node);
+            }
+            else {
+                x = loadRelaxed(node->right_node);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<node_ptr> peekLowest() const {
+        node_ptr x = loadRelaxed(this->root);
+        node_ptr lowest_pos = NULL_PTR;
+        for (size_t step = 0; step < MAX_WALK; ++step) {
+            const Node* node = peek(x);
+            if (node == nullptr) {
+                return std::nullopt;
+            }
+            if (loadRelaxed(node->is_fictitious)) {
+                return lowest_pos;
+            }
+            lowest_pos = x;
+            x = loadRelaxed(node->left_node);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<node_ptr> peekNext(node_ptr x) const {
+        const Node* node = peek(x);
+        if (node == nullptr) {
+            return std::nullopt;
+        }
+
+        node_ptr right_son = loadRelaxed(node->right_node);
+        const Node* right_node = peek(right_son);
+        if (right_node == nullptr) {
+            return std::nullopt;
+        }
+
+        if (!loadRelaxed(right_node->is_fictitious)) {
+            x = right_son;
+            for (size_t step = 0; step < MAX_WALK; ++step) {
+                const Node* current = peek(x);
+                if (current == nullptr) {
+                    return std::nullopt;
+                }
+                node_ptr left_son = loadRelaxed(current->left_node);
+                const Node* left_node = peek(left_son);
+                if (left_node == nullptr) {
+                    return std::nullopt;
+                }
+                if (loadRelaxed(left_node->is_fictitious)) {
+                    return x;
+                }
+                x = left_son;
+            }
+            return std::nullopt;
+        }
+
+        for (size_t step = 0; step < MAX_WALK; ++step) {
+            const Node* current = peek(x);
+            if (current == nullptr) {
+                return std::nullopt;
+            }
+            node_ptr parent = loadRelaxed(current->parent);
+            if (parent == NULL_PTR) {
+                return node_ptr(NULL_PTR);
+            }
+            const Node* parent_node = peek(parent);
+            if (parent_node == nullptr) {
+                return std::nullopt;
+            }
+            if (loadRelaxed(parent_node->right_node) != x) {
+                return parent;
+            }
+            x = parent;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::pair<TKey, TValue>> findBound(const TKey& key, bool inclusive) const {
+        std::optional<std::pair<TKey, TValue>> result;
+        readOptimistically([&]() {
+            std::optional<node_ptr> position = peekBound(key, inclusive);
+            if (!position.has_value()) {
+                return false;
+            }
+            result.reset();
+            if (*position != NULL_PTR) {
+                result = loadData(peek(*position));
+            }
+            return true;
+        });
+        return result;
+    }
+
+protected:
+
+    void beginWrite() {
+        uint64_t current = version.load(std::memory_order_relaxed);
+        version.store(current + 1U, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() {
+        uint64_t current = version.load(std::memory_order_relaxed);
+        version.store(current + 1U, std::memory_order_release);
+        published_size.store(Base::size(), std::memory_order_relaxed);
+    }
+
+    // Moves the slots freed since `free_before` out of the free list until no reader can hold them.
+    void retire(size_t free_before) {
+        uint64_t tag = epochs.advance();
+        while (this->free_poses.size() > free_before) {
+            retired.push_back({ tag, this->free_poses.back() });
+            this->free_poses.pop_back();
+        }
+    }
+
+    void reclaim() {
+        if (retired.size() < RECLAIM_BATCH) {
+            return;
+        }
+        uint64_t oldest = epochs.getOldestActiveEpoch();
+        while (!retired.empty() && retired.front().first < oldest) {
+            this->free_poses.push_back(retired.front().second);
+            retired.pop_front();
+        }
+    }
+
+public:
+
+    ConcurrentRedBlackTree() = default;
+
+    std::optional<TValue> find(const TKey& key) const {
+        std::optional<TValue> result;
+        readOptimistically([&]() {
+            std::optional<node_ptr> position = peekBound(key, true);
+            if (!position.has_value()) {
+                return false;
+            }
+            result.reset();
+            if (*position != NULL_PTR) {
+                const Node* node = peek(*position);
+                if (loadRelaxed(node->data.first) == key) {
+                    result = loadRelaxed(node->data.second);
+                }
+            }
+            return true;
+        });
+        return result;
+    }
+
+    bool isExist(const TKey& key) const {
+        return find(key).has_value();
+    }
+
+    std::optional<std::pair<TKey, TValue>> lowerBound(const TKey& key) const {
+        return findBound(key, true);
+    }
+
+    std::optional<std::pair<TKey, TValue>> upperBound(const TKey& key) const {
+        return findBound(key, false);
+    }
+
+    // Calls `callback(key, value)` for the elements not less than `from` in increasing order.
+    // The elements are copied out in batches, each of which is a consistent view of the tree.
+    template <typename TCallback>
+    void forEach(const TKey& from, TCallback callback) const {
+        forEachFrom(std::optional<TKey>(from), true, callback);
+    }
+
+    template <typename TCallback>
+    void forEach(TCallback callback) const {
+        forEachFrom(std::nullopt, true, callback);
+    }
+
+    size_t size() const {
+        return published_size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0U;
+    }
+
+    bool insert(const TKey& key, const TValue& value) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        reclaim();
+        if (!this->isFictitious(this->findPosition(key))) {
+            return false;
+        }
+        beginWrite();
+        Base::insert(key, value);
+        endWrite();
+        return true;
+    }
+
+    // Inserts the element or overwrites the value of an existing one.
+    void assign(const TKey& key, const TValue& value) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        reclaim();
+        node_ptr ptr = this->findPosition(key);
+        beginWrite();
+        if (this->isFictitious(ptr)) {
+            Base::insert(key, value);
+        }
+        else {
+            storeRelaxed(this->tree[ptr].data.second, value);
+        }
+        endWrite();
+    }
+
+    bool erase(const TKey& key) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        reclaim();
+        if (this->isFictitious(this->findPosition(key))) {
+            return false;
+        }
+        size_t free_before = this->free_poses.size();
+        beginWrite();
+        Base::erase(key);
+        endWrite();
+        retire(free_before);
+        return true;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        beginWrite();
+        Base::clear();
+        endWrite();
+        retired.clear();
+        // Every slot is free again: wait out the readers that may still be walking the old tree.
+        epochs.synchronize();
+    }
+
+protected:
+
+    template <typename TCallback>
+    void forEachFrom(std::optional<TKey> cursor, bool inclusive, TCallback& callback) const {
+        std::array<std::pair<TKey, TValue>, SCAN_BATCH> buffer;
+        size_t filled = 0;
+        bool is_last = false;
+
+        while (true) {
+            readOptimistically([&]() {
+                filled = 0;
+                is_last = false;
+
+                std::optional<node_ptr> position = cursor.has_value() ? peekBound(*cursor, inclusive) : peekLowest();
+                while (position.has_value() && *position != NULL_PTR && filled < SCAN_BATCH) {
+                    buffer[filled++] = loadData(peek(*position));
+                    position = peekNext(*position);
+                }
+                if (!position.has_value()) {
+                    return false;
+                }
+                is_last = (*position == NULL_PTR);
+                return true;
+            });
+
+            for (size_t i = 0; i < filled; ++i) {
+                callback(buffer[i].first, buffer[i].second);
+            }
+            if (is_last) {
+                return;
+            }
+            cursor = buffer[filled - 1].first;
+            inclusive = false;
+        }
+    }
+};
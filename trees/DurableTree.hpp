@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "AVLTree.hpp"
+#include "FrozenTree.hpp"
+
+// Durability layer over a tree: every update is recorded in a write-ahead log,
+// and after a crash the tree is rebuilt from the last checkpoint plus the log
+// written since.
+//
+// Records are grouped: they are written and fsync'ed together once `group_size`
+// of them are pending (group commit), so an update is durable after the next sync(),
+// whether explicit or automatic. A checkpoint writes the whole tree as a snapshot
+// and starts a new log.
+template <typename TKey, typename TValue, typename TTree = AVLTree<TKey, TValue>>
+class DurableTree {
+    static_assert(std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>,
+                  "Log records store keys and values as raw bytes");
+
+public:
+
+    struct Options {
+        // Number of updates written and synced together.
+        size_t group_size = 64;
+
+        // Without fsync the log survives a crash of the process but not of the machine.
+        bool is_fsync_enabled = true;
+
+        // Takes a checkpoint after this many updates; 0 means only on checkpoint().
+        size_t checkpoint_interval = 0;
+    };
+
+protected:
+
+    enum class Operation : uint8_t {
+        INSERT = 1,
+        ERASE = 2,
+        ASSIGN = 3,
+        CLEAR = 4
+    };
+
+    struct Record {
+        Operation operation;
+        TKey key;
+        TValue value;
+    };
+
+    // A record is written packed: the checksum, the operation, the key and the value. The checksum
+    // covers the bytes that are written, so the padding of Record never reaches the file.
+    constexpr static size_t CHECKSUM_OFFSET = 0;
+    constexpr static size_t OPERATION_OFFSET = CHECKSUM_OFFSET + sizeof(uint64_t);
+    constexpr static size_t KEY_OFFSET = OPERATION_OFFSET + sizeof(Operation);
+    constexpr static size_t VALUE_OFFSET = KEY_OFFSET + sizeof(TKey);
+    constexpr static size_t RECORD_SIZE = VALUE_OFFSET + sizeof(TValue);
+
+    TTree tree;
+
+    std::string path;
+    Options options;
+
+    int log_fd = -1;
+
+    // Encoded records waiting for the next sync().
+    std::vector<unsigned char> pending;
+    size_t updates_since_checkpoint = 0;
+
+protected:
+
+    std::string getLogPath() const {
+        return path + ".wal";
+    }
+
+    std::string getCheckpointPath() const {
+        return path + ".checkpoint";
+    }
+
+    // Checksum of an encoded record, over everything after the checksum itself.
+    static uint64_t getChecksum(const unsigned char* bytes) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (size_t i = OPERATION_OFFSET; i < RECORD_SIZE; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    static void encode(const Record& record, unsigned char* bytes) {
+        std::memcpy(bytes + OPERATION_OFFSET, &record.operation, sizeof(Operation));
+        std::memcpy(bytes + KEY_OFFSET, &record.key, sizeof(TKey));
+        std::memcpy(bytes + VALUE_OFFSET, &record.value, sizeof(TValue));
+        uint64_t checksum = getChecksum(bytes);
+        std::memcpy(bytes + CHECKSUM_OFFSET, &checksum, sizeof(checksum));
+    }
+
+    // Returns false if the bytes are not a record written by encode().
+    static bool decode(const unsigned char* bytes, Record& record) {
+        uint64_t checksum;
+        std::memcpy(&checksum, bytes + CHECKSUM_OFFSET, sizeof(checksum));
+        if (checksum != getChecksum(bytes)) {
+            return false;
+        }
+        std::memcpy(&record.operation, bytes + OPERATION_OFFSET, sizeof(Operation));
+        std::memcpy(&record.key, bytes + KEY_OFFSET, sizeof(TKey));
+        std::memcpy(&record.value, bytes + VALUE_OFFSET, sizeof(TValue));
+        return true;
+    }
+
+    static int openFile(const std::string& file_path, bool is_truncated) {
+#ifdef _WIN32
+        int flags = _O_RDWR | _O_CREAT | _O_BINARY | (is_truncated ? _O_TRUNC : 0);
+        int fd = _open(file_path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+        int flags = O_RDWR | O_CREAT | (is_truncated ? O_TRUNC : 0);
+        int fd = open(file_path.c_str(), flags, 0644);
+#endif
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file " + file_path);
+        }
+        return fd;
+    }
+
+    static void closeFile(int fd) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+
+    static void syncFile(int fd) {
+#ifdef _WIN32
+        int result = _commit(fd);
+#else
+        int result = fsync(fd);
+#endif
+        if (result != 0) {
+            throw std::runtime_error("Cannot sync log file");
+        }
+    }
+
+    // Makes a rename inside the directory of `file_path` durable. Windows has no fsync for
+    // directories, and NTFS journals renames itself.
+    static void syncDirectory(const std::string& file_path) {
+#ifndef _WIN32
+        std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+        if (directory.empty()) {
+            directory = ".";
+        }
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open directory " + directory.string());
+        }
+        int result = fsync(fd);
+        close(fd);
+        if (result != 0) {
+            throw std::runtime_error("Cannot sync directory " + directory.string());
+        }
+#endif
+    }
+
+    static void writeAll(int fd, const void* data, size_t length) {
+        const char* bytes = static_cast<const char*>(data);
+        while (length > 0U) {
+#ifdef _WIN32
+            int written = _write(fd, bytes, static_cast<unsigned>(std::min<size_t>(length, 1U << 30)));
+#else
+            ssize_t written = write(fd, bytes, length);
+#endif
+            if (written <= 0) {
+                throw std::runtime_error("Cannot write log file");
+            }
+            bytes += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    void apply(const Record& record) {
+        switch (record.operation) {
+        case Operation::INSERT:
+            tree.insert(record.key, record.value);
+            break;
+        case Operation::ERASE:
+            if (tree.isExist(record.key)) {
+                tree.erase(record.key);
+            }
+            break;
+        case Operation::ASSIGN: {
+            auto it = tree.find(record.key);
+            if (it == tree.end()) {
+                tree.insert(record.key, record.value);
+            }
+            else {
+                it->second = record.value;
+            }
+            break;
+        }
+        case Operation::CLEAR:
+            tree.clear();
+            break;
+        }
+    }
+
+    void log(Operation operation, const TKey& key, const TValue& value) {
+        Record record{ operation, key, value };
+        pending.resize(pending.size() + RECORD_SIZE);
+        encode(record, pending.data() + pending.size() - RECORD_SIZE);
+        apply(record);
+
+        if (pending.size() >= options.group_size * RECORD_SIZE) {
+            sync();
+        }
+        if (options.checkpoint_interval != 0U && ++updates_since_checkpoint >= options.checkpoint_interval) {
+            checkpoint();
+        }
+    }
+
+    // Rebuilds the tree from the checkpoint and the valid prefix of the log, then drops a torn tail.
+    // Replaying records that are already in the checkpoint is harmless: the final state of a key
+    // does not change if its sequence of updates is applied twice.
+    void recover() {
+        if (std::filesystem::exists(getCheckpointPath())) {
+            auto checkpoint_tree = FrozenTree<TKey, TValue>::loadSnapshot(getCheckpointPath());
+            for (auto [key, value] : checkpoint_tree) {
+                tree.insert(key, value);
+            }
+        }
+
+        log_fd = openFile(getLogPath(), false);
+
+        size_t count_of_valid = 0;
+        unsigned char bytes[RECORD_SIZE];
+        Record record;
+        while (true) {
+#ifdef _WIN32
+            int length = _read(log_fd, bytes, RECORD_SIZE);
+#else
+            ssize_t length = read(log_fd, bytes, RECORD_SIZE);
+#endif
+            if (length != static_cast<decltype(length)>(RECORD_SIZE) || !decode(bytes, record)) {
+                break;
+            }
+            apply(record);
+            ++count_of_valid;
+        }
+
+        uint64_t valid_length = count_of_valid * RECORD_SIZE;
+#ifdef _WIN32
+        bool is_truncated = _chsize_s(log_fd, static_cast<long long>(valid_length)) == 0 &&
+                            _lseeki64(log_fd, static_cast<long long>(valid_length), SEEK_SET) >= 0;
+#else
+        bool is_truncated = ftruncate(log_fd, static_cast<off_t>(valid_length)) == 0 &&
+                            lseek(log_fd, static_cast<off_t>(valid_length), SEEK_SET) >= 0;
+#endif
+        if (!is_truncated) {
+            throw std::runtime_error("Cannot truncate log file " + getLogPath());
+        }
+    }
+
+public:
+
+    // Opens the tree stored under `path` (files `path`.wal and `path`.checkpoint), recovering it if needed.
+    explicit DurableTree(const std::string& path, Options options = Options()) :
+        path(path),
+        options(options)
+    {
+        recover();
+    }
+
+    DurableTree(const DurableTree&) = delete;
+    DurableTree& operator=(const DurableTree&) = delete;
+
+    ~DurableTree() {
+        try {
+            sync();
+        }
+        catch (...) {
+        }
+        closeFile(log_fd);
+    }
+
+    void insert(const TKey& key, const TValue& value) {
+        log(Operation::INSERT, key, value);
+    }
+
+    // Inserts the element or overwrites the value of an existing one.
+    void assign(const TKey& key, const TValue& value) {
+        log(Operation::ASSIGN, key, value);
+    }
+
+    void erase(const TKey& key) {
+        if (!tree.isExist(key)) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        log(Operation::ERASE, key, TValue());
+    }
+
+    void clear() {
+        log(Operation::CLEAR, TKey(), TValue());
+    }
+
+    // Read-only access to the tree; updates must go through this wrapper to be logged.
+    const TTree& getTree() const {
+        return tree;
+    }
+
+    auto find(const TKey& key) const {
+        return tree.find(key);
+    }
+
+    bool isExist(const TKey& key) const {
+        return tree.isExist(key);
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        return tree[key];
+    }
+
+    auto begin() const {
+        return tree.begin();
+    }
+
+    auto end() const {
+        return tree.end();
+    }
+
+    size_t size() const {
+        return tree.size();
+    }
+
+    bool empty() const {
+        return tree.empty();
+    }
+
+    // Writes the pending records and, if enabled, waits until they reach the disk.
+    void sync() {
+        if (pending.empty()) {
+            return;
+        }
+        writeAll(log_fd, pending.data(), pending.size());
+        pending.clear();
+        if (options.is_fsync_enabled) {
+            syncFile(log_fd);
+        }
+    }
+
+    // Saves the whole tree and starts an empty log. The snapshot replaces the previous
+    // checkpoint atomically, so a crash at any point leaves a recoverable pair of files.
+    void checkpoint() {
+        sync();
+
+        std::string temporary_path = getCheckpointPath() + ".tmp";
+        tree.saveSnapshot(temporary_path);
+        int fd = openFile(temporary_path, false);
+        syncFile(fd);
+        closeFile(fd);
+        std::filesystem::rename(temporary_path, getCheckpointPath());
+        // The rename only changes the directory entry, which may still be in the page cache. Without
+        // syncing the directory, a power loss after the log is truncated below could bring back the
+        // old checkpoint next to an empty log and lose every update since it.
+        syncDirectory(getCheckpointPath());
+
+        closeFile(log_fd);
+        log_fd = openFile(getLogPath(), true);
+        updates_since_checkpoint = 0;
+    }
+};
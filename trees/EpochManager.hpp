@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
+
+// Epoch-based reclamation for one writer and many readers.
+// A reader pins the current global epoch for the duration of an operation.
+// The writer tags everything it unlinks with advance(); a tagged object may be
+// reused once getOldestActiveEpoch() is greater than its tag.
+class EpochManager {
+public:
+
+    const static size_t MAX_READERS = 256;
+
+protected:
+
+    const static uint64_t INACTIVE = std::numeric_limits<uint64_t>::max();
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch = INACTIVE;
+        std::atomic<bool> is_taken = false;
+    };
+
+    alignas(64) std::atomic<uint64_t> global_epoch = 1;
+
+    std::array<Slot, MAX_READERS> slots;
+
+protected:
+
+    size_t takeSlot() {
+        thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+        for (size_t i = 0;; ++i) {
+            size_t slot = (hint + i) % MAX_READERS;
+            bool is_taken = false;
+            if (!slots[slot].is_taken.load(std::memory_order_relaxed) &&
+                slots[slot].is_taken.compare_exchange_strong(is_taken, true, std::memory_order_acquire)) {
+                hint = slot;
+                return slot;
+            }
+            if (i % MAX_READERS == MAX_READERS - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+public:
+
+    class Guard {
+    protected:
+
+        EpochManager* manager;
+        size_t slot;
+
+        Guard(EpochManager* manager, size_t slot) :
+            manager(manager),
+            slot(slot)
+        {}
+
+    public:
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() {
+            manager->slots[slot].epoch.store(INACTIVE, std::memory_order_release);
+            manager->slots[slot].is_taken.store(false, std::memory_order_release);
+        }
+
+        friend class EpochManager;
+    };
+
+    Guard pin() {
+        size_t slot = takeSlot();
+
+        // Re-check after publishing: a writer that advanced in between might have
+        // missed this slot when it computed the oldest active epoch.
+        uint64_t epoch = global_epoch.load();
+        while (true) {
+            slots[slot].epoch.store(epoch);
+            uint64_t current = global_epoch.load();
+            if (current == epoch) {
+                break;
+            }
+            epoch = current;
+        }
+
+        return Guard(this, slot);
+    }
+
+    // Starts a new epoch and returns the tag for everything unlinked before the call.
+    uint64_t advance() {
+        return global_epoch.fetch_add(1U);
+    }
+
+    uint64_t getOldestActiveEpoch() const {
+        uint64_t oldest = global_epoch.load();
+        for (const Slot& slot : slots) {
+            uint64_t epoch = slot.epoch.load();
+            if (epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+    // Waits until every reader that was pinned before the call has finished.
+    void synchronize() {
+        uint64_t tag = advance();
+        while (getOldestActiveEpoch() <= tag) {
+            std::this_thread::yield();
+        }
+    }
+};
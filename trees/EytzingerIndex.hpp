@@ -0,0 +1,276 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+// Static search index: the sorted keys are stored in Eytzinger (BFS) order,
+// where the children of slot k are 2k and 2k + 1, with values in a parallel array.
+// Lookups descend without branches and prefetch the cache line that holds
+// the descendants four levels below the current slot.
+template <typename TKey, typename TValue>
+class EytzingerIndex {
+protected:
+
+    using index_t = size_t;
+
+    // Number of keys in one cache line: slots 16k .. 16k + 15 are the descendants
+    // of k four levels down, so a single prefetch covers all of them.
+    const static index_t KEYS_PER_LINE = 64U / sizeof(TKey) > 0U ? 64U / sizeof(TKey) : 1U;
+
+public:
+
+    class Iterator {
+    protected:
+
+        index_t pos = 0;
+
+        const EytzingerIndex<TKey, TValue>* container_ptr;
+
+        Iterator(index_t pos, const EytzingerIndex<TKey, TValue>* container_ptr) :
+            pos(pos),
+            container_ptr(container_ptr)
+        {}
+
+        struct Pointer {
+            std::pair<const TKey&, const TValue&> data;
+
+            const std::pair<const TKey&, const TValue&>* operator->() const {
+                return &data;
+            }
+        };
+
+    public:
+
+        const std::pair<const TKey&, const TValue&> operator*() const {
+            if (pos == 0U) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            return { container_ptr->keys[pos], container_ptr->values[pos] };
+        }
+
+        Pointer operator->() const {
+            return { **this };
+        }
+
+        Iterator& operator++() {
+            index_t n = container_ptr->count_of_elements;
+            if (2U * pos + 1U <= n) {
+                pos = 2U * pos + 1U;
+                while (2U * pos <= n) {
+                    pos = 2U * pos;
+                }
+            }
+            else {
+                pos >>= std::countr_one(pos) + 1;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return this->pos == other.pos;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return this->pos != other.pos;
+        }
+
+        friend class EytzingerIndex;
+    };
+
+protected:
+
+    // Both arrays are 1-indexed, slot 0 is unused.
+    std::vector<TKey> keys;
+    std::vector<TValue> values;
+
+    index_t count_of_elements = 0;
+
+protected:
+
+    Iterator makeIterator(index_t position) const {
+        return Iterator(position, this);
+    }
+
+    static void prefetch(const void* address) {
+#if defined(_MSC_VER)
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+        __builtin_prefetch(address);
+#endif
+    }
+
+    // The slot may lie past the end of the array: a prefetch never faults.
+    void prefetchSlot(index_t k) const {
+        prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(keys.data()) + k * sizeof(TKey)));
+    }
+
+    void fill(index_t k, std::vector<std::pair<TKey, TValue>>& sorted_data, index_t& next) {
+        if (k > count_of_elements) {
+            return;
+        }
+        fill(2U * k, sorted_data, next);
+        keys[k] = std::move(sorted_data[next].first);
+        values[k] = std::move(sorted_data[next].second);
+        ++next;
+        fill(2U * k + 1U, sorted_data, next);
+    }
+
+    // Returns the slot of the first key that is not less than `key` (0 if there is none).
+    index_t lowerBoundPosition(const TKey& key) const {
+        const TKey* base = keys.data();
+        index_t k = 1U;
+        while (k <= count_of_elements) {
+            prefetchSlot(KEYS_PER_LINE * k);
+            k = 2U * k + static_cast<index_t>(base[k] < key);
+        }
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    index_t upperBoundPosition(const TKey& key) const {
+        const TKey* base = keys.data();
+        index_t k = 1U;
+        while (k <= count_of_elements) {
+            prefetchSlot(KEYS_PER_LINE * k);
+            k = 2U * k + static_cast<index_t>(!(key < base[k]));
+        }
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    constexpr static bool hasVectorPath() {
+#if defined(__AVX2__)
+        return std::is_integral_v<TKey> && std::is_signed_v<TKey> && sizeof(TKey) == 4U;
+#else
+        return false;
+#endif
+    }
+
+#if defined(__AVX2__)
+    // Descends for eight queries at once: each level is one gather and one compare.
+    void lowerBoundPositions8(const TKey* queries, index_t* result) const {
+        const int* base = reinterpret_cast<const int*>(keys.data());
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i limit = _mm256_set1_epi32(static_cast<int>(count_of_elements) + 1);
+
+        __m256i query = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(queries));
+        __m256i k = one;
+
+        int levels = static_cast<int>(std::bit_width(count_of_elements));
+        for (int level = 0; level < levels; ++level) {
+            __m256i active = _mm256_cmpgt_epi32(limit, k);
+            __m256i node_keys = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, k, active, 4);
+            __m256i less = _mm256_and_si256(_mm256_cmpgt_epi32(query, node_keys), active);
+            __m256i next = _mm256_sub_epi32(_mm256_add_epi32(k, k), less);
+            k = _mm256_blendv_epi8(k, next, active);
+        }
+
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), k);
+        for (int lane = 0; lane < 8; ++lane) {
+            result[lane] = lanes[lane] >> (std::countr_one(lanes[lane]) + 1);
+        }
+    }
+#endif
+
+public:
+
+    EytzingerIndex() :
+        keys(1U),
+        values(1U)
+    {}
+
+    // `sorted_data` must be sorted by key without duplicates.
+    explicit EytzingerIndex(std::vector<std::pair<TKey, TValue>> sorted_data) :
+        keys(sorted_data.size() + 1U),
+        values(sorted_data.size() + 1U),
+        count_of_elements(sorted_data.size())
+    {
+        index_t next = 0U;
+        fill(1U, sorted_data, next);
+    }
+
+    Iterator begin() const {
+        if (empty()) {
+            return end();
+        }
+        index_t k = 1U;
+        while (2U * k <= count_of_elements) {
+            k = 2U * k;
+        }
+        return makeIterator(k);
+    }
+
+    Iterator end() const {
+        return makeIterator(0U);
+    }
+
+    Iterator lowerBound(const TKey& key) const {
+        return makeIterator(lowerBoundPosition(key));
+    }
+
+    Iterator upperBound(const TKey& key) const {
+        return makeIterator(upperBoundPosition(key));
+    }
+
+    Iterator find(const TKey& key) const {
+        index_t k = lowerBoundPosition(key);
+        if (k == 0U || key < keys[k]) {
+            return end();
+        }
+        return makeIterator(k);
+    }
+
+    // Batched lower bounds: writes one iterator per query to `out`.
+    // Signed 32-bit keys are searched eight at a time with AVX2 when it is enabled.
+    template <typename TOutputIt>
+    TOutputIt lowerBound(const TKey* first, const TKey* last, TOutputIt out) const {
+#if defined(__AVX2__)
+        if constexpr (hasVectorPath()) {
+            if (count_of_elements < (index_t(1) << 30)) {
+                index_t positions[8];
+                for (; last - first >= 8; first += 8) {
+                    lowerBoundPositions8(first, positions);
+                    for (index_t position : positions) {
+                        *out++ = makeIterator(position);
+                    }
+                }
+            }
+        }
+#endif
+        for (; first != last; ++first) {
+            *out++ = lowerBound(*first);
+        }
+        return out;
+    }
+
+    bool isExist(const TKey& key) const {
+        return find(key) != end();
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        index_t k = lowerBoundPosition(key);
+        if (k == 0U || key < keys[k]) {
+            throw std::runtime_error("No such key in table");
+        }
+        return values[k];
+    }
+
+    size_t size() const {
+        return count_of_elements;
+    }
+
+    bool empty() const {
+        return count_of_elements == 0U;
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BatchOperation.hpp"
+#include "RedBlackTree.hpp"
+
+// Flat-combining front end for a tree shared by many threads.
+// A thread publishes its operation in a slot and either becomes the combiner or waits.
+// The combiner collects every pending operation, sorts the batch by key and applies it
+// in one pass through TTree::applyBatch, so the tree stays in a single core's cache instead of bouncing between
+// threads on every lock handoff.
+template <typename TKey, typename TValue, typename TTree = RedBlackTree<TKey, TValue>>
+class FlatCombiningTree {
+public:
+
+    const static size_t MAX_THREADS = 256;
+
+protected:
+
+    // Number of times the combiner rescans the slots before handing the lock back.
+    const static size_t COMBINE_PASSES = 2;
+
+    enum class Operation {
+        INSERT,
+        ERASE,
+        FIND
+    };
+
+    enum class State {
+        EMPTY,
+        PENDING,
+        DONE
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<bool> is_taken = false;
+        std::atomic<State> state = State::EMPTY;
+
+        Operation operation;
+        TKey key;
+        TValue value;
+
+        bool is_success;
+        std::optional<TValue> found;
+
+        // Set if the batch of the operation threw; rethrown in the waiting thread.
+        std::exception_ptr error;
+    };
+
+    TTree tree;
+
+    // Taken by const forEach too, so it is mutable.
+    alignas(64) mutable std::atomic<bool> is_combining = false;
+    std::atomic<size_t> count_of_used_slots = 0;
+    std::atomic<size_t> published_size = 0;
+
+    std::array<Slot, MAX_THREADS> slots;
+
+    // Owned by the current combiner.
+    std::vector<size_t> batch;
+    std::vector<BatchOperation<TKey, TValue>> updates;
+
+protected:
+
+    size_t takeSlot() {
+        thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+        for (size_t i = 0;; ++i) {
+            size_t slot = (hint + i) % MAX_THREADS;
+            bool is_taken = false;
+            if (!slots[slot].is_taken.load(std::memory_order_relaxed) &&
+                slots[slot].is_taken.compare_exchange_strong(is_taken, true, std::memory_order_acquire)) {
+                hint = slot;
+
+                size_t used = count_of_used_slots.load(std::memory_order_relaxed);
+                while (used <= slot && !count_of_used_slots.compare_exchange_weak(used, slot + 1U)) {}
+                return slot;
+            }
+            if (i % MAX_THREADS == MAX_THREADS - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Applies the sorted batch in one walk. The keys are looked up in order with finger searches,
+    // each operation is answered from the state its key has reached within the batch, and the net
+    // change of every key goes to the tree in a single applyBatch.
+    void applyBatch() {
+        updates.clear();
+        auto it = tree.end();
+        size_t first = 0;
+        while (first < batch.size()) {
+            const TKey& key = slots[batch[first]].key;
+            it = tree.lowerBound(it, key);
+            bool was_present = it != tree.end() && !(key < it->first);
+
+            // The value the key has at this point of the batch, or nullptr if it is absent.
+            const TValue* current = was_present ? &it->second : nullptr;
+            bool is_changed = false;
+            size_t last = first;
+            for (; last < batch.size() && !(key < slots[batch[last]].key); ++last) {
+                Slot& slot = slots[batch[last]];
+                switch (slot.operation) {
+                case Operation::INSERT:
+                    slot.is_success = current == nullptr;
+                    if (slot.is_success) {
+                        current = &slot.value;
+                        is_changed = true;
+                    }
+                    break;
+                case Operation::ERASE:
+                    slot.is_success = current != nullptr;
+                    if (slot.is_success) {
+                        current = nullptr;
+                        is_changed = true;
+                    }
+                    break;
+                case Operation::FIND:
+                    slot.found.reset();
+                    if (current != nullptr) {
+                        slot.found = *current;
+                    }
+                    break;
+                }
+            }
+
+            if (is_changed && current != nullptr) {
+                updates.push_back({ BatchOperation<TKey, TValue>::Type::UPSERT, key, *current });
+            }
+            else if (is_changed && was_present) {
+                updates.push_back({ BatchOperation<TKey, TValue>::Type::ERASE, key, TValue() });
+            }
+            first = last;
+        }
+        tree.applyBatch(updates);
+    }
+
+    // If applying a batch throws (a failed allocation in the tree, a throwing comparison or copy),
+    // every operation of the batch is finished with the exception, so no waiter spins forever.
+    void combine() {
+        for (size_t pass = 0; pass < COMBINE_PASSES; ++pass) {
+            // `batch` has room for every slot, so collecting allocates nothing and cannot throw.
+            batch.clear();
+            size_t used = count_of_used_slots.load(std::memory_order_acquire);
+            for (size_t i = 0; i < used; ++i) {
+                if (slots[i].state.load(std::memory_order_acquire) == State::PENDING) {
+                    batch.push_back(i);
+                }
+            }
+            if (batch.empty()) {
+                return;
+            }
+
+            std::exception_ptr error;
+            try {
+                std::sort(batch.begin(), batch.end(), [this](size_t lhs, size_t rhs) {
+                    return slots[lhs].key < slots[rhs].key;
+                });
+                applyBatch();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            published_size.store(tree.size(), std::memory_order_relaxed);
+
+            for (size_t i : batch) {
+                slots[i].error = error;
+                slots[i].state.store(State::DONE, std::memory_order_release);
+            }
+            if (error != nullptr) {
+                return;
+            }
+        }
+    }
+
+    bool tryCombine() {
+        if (is_combining.load(std::memory_order_relaxed) ||
+            is_combining.exchange(true, std::memory_order_acquire)) {
+            return false;
+        }
+        CombinerGuard guard(*this, std::adopt_lock);
+        combine();
+        return true;
+    }
+
+    // Publishes the operation, waits until some combiner has applied it and
+    // passes the filled slot to `reader`.
+    template <typename TReader>
+    auto execute(Operation operation, const TKey& key, const TValue* value, TReader reader) {
+        size_t index = takeSlot();
+        Slot& slot = slots[index];
+
+        slot.operation = operation;
+        slot.key = key;
+        if (value != nullptr) {
+            slot.value = *value;
+        }
+        slot.state.store(State::PENDING, std::memory_order_release);
+
+        size_t spins = 0;
+        while (slot.state.load(std::memory_order_acquire) != State::DONE) {
+            if (!tryCombine() && ++spins % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr error = std::exchange(slot.error, nullptr);
+        auto result = reader(slot);
+        slot.state.store(State::EMPTY, std::memory_order_relaxed);
+        slot.is_taken.store(false, std::memory_order_release);
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+        return result;
+    }
+
+    void lockCombiner() const {
+        while (is_combining.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlockCombiner() const {
+        is_combining.store(false, std::memory_order_release);
+    }
+
+    // Holds the combiner role for its lifetime, so a throwing callback cannot leave it taken.
+    class CombinerGuard {
+        const FlatCombiningTree& owner;
+
+    public:
+
+        explicit CombinerGuard(const FlatCombiningTree& owner) :
+            owner(owner)
+        {
+            owner.lockCombiner();
+        }
+
+        // Takes over a role the caller already holds.
+        CombinerGuard(const FlatCombiningTree& owner, std::adopt_lock_t) :
+            owner(owner)
+        {}
+
+        CombinerGuard(const CombinerGuard&) = delete;
+        CombinerGuard& operator=(const CombinerGuard&) = delete;
+
+        ~CombinerGuard() {
+            owner.unlockCombiner();
+        }
+    };
+
+public:
+
+    FlatCombiningTree() {
+        batch.reserve(MAX_THREADS);
+    }
+
+    FlatCombiningTree(const FlatCombiningTree&) = delete;
+    FlatCombiningTree& operator=(const FlatCombiningTree&) = delete;
+
+    bool insert(const TKey& key, const TValue& value) {
+        return execute(Operation::INSERT, key, &value, [](const Slot& slot) { return slot.is_success; });
+    }
+
+    bool erase(const TKey& key) {
+        return execute(Operation::ERASE, key, nullptr, [](const Slot& slot) { return slot.is_success; });
+    }
+
+    std::optional<TValue> find(const TKey& key) {
+        return execute(Operation::FIND, key, nullptr, [](const Slot& slot) { return slot.found; });
+    }
+
+    bool isExist(const TKey& key) {
+        return find(key).has_value();
+    }
+
+    size_t size() const {
+        return published_size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return size() == 0U;
+    }
+
+    // Calls `callback(key, value)` for every element in increasing order while
+    // holding the combiner role, so no batch is applied in the meantime.
+    template <typename TCallback>
+    void forEach(TCallback callback) const {
+        CombinerGuard guard(*this);
+        for (auto [key, value] : tree) {
+            callback(key, value);
+        }
+    }
+};
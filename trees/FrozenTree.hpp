@@ -0,0 +1,401 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+// Immutable search tree whose nodes are stored in van Emde Boas order:
+// every subtree of height h occupies a contiguous block of the node array,
+// so a descent touches O(log_B n) cache lines for any block size B.
+// Nodes refer to each other by index, so the node array can be saved to a file
+// as is and queried straight from a memory mapping (saveSnapshot / loadSnapshot).
+template <typename TKey, typename TValue>
+class FrozenTree {
+protected:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+    // A plain struct rather than std::pair, whose assignment operators keep it from being
+    // trivially copyable.
+    struct Element {
+        TKey first;
+        TValue second;
+    };
+
+    struct Node {
+
+        node_ptr parent;
+        node_ptr left_node, right_node;
+
+        Element data;
+    };
+
+public:
+
+    class Iterator {
+    protected:
+
+        node_ptr ptr = 0;
+
+        const FrozenTree<TKey, TValue>* container_ptr;
+
+        Iterator(node_ptr ptr, const FrozenTree<TKey, TValue>* container_ptr) :
+            ptr(ptr),
+            container_ptr(container_ptr)
+        {}
+
+    public:
+
+        const std::pair<const TKey&, const TValue&> operator*() const {
+            if (ptr == NULL_PTR) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            return { container_ptr->tree[ptr].data.first, container_ptr->tree[ptr].data.second };
+        }
+
+        const Element* operator->() const {
+            return &container_ptr->tree[ptr].data;
+        }
+
+        Iterator& operator++() {
+            node_ptr curr_node_ptr = ptr;
+            node_ptr right_son_ptr = container_ptr->getRightSon(curr_node_ptr);
+
+            if (right_son_ptr != NULL_PTR) {
+                ptr = container_ptr->getLowestPos(right_son_ptr);
+                return *this;
+            }
+
+            node_ptr prev_node_ptr = container_ptr->getParent(curr_node_ptr);
+            for (size_t steps = 0; prev_node_ptr != NULL_PTR && container_ptr->getRightSon(prev_node_ptr) == curr_node_ptr;
+                 ++steps) {
+                container_ptr->checkWalkLength(steps);
+                curr_node_ptr = prev_node_ptr;
+                prev_node_ptr = container_ptr->getParent(curr_node_ptr);
+            }
+            ptr = prev_node_ptr;
+
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return this->ptr == other.ptr;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return this->ptr != other.ptr;
+        }
+
+        friend class FrozenTree;
+    };
+
+protected:
+
+    // Layout of a snapshot file: this header followed by the node array.
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t format_version;
+        uint32_t node_size;
+        uint32_t key_size;
+        uint32_t value_size;
+        int64_t root;
+        uint64_t count_of_nodes;
+        uint64_t checksum;
+        uint8_t reserved[16];
+    };
+
+    constexpr static char SNAPSHOT_MAGIC[8] = { 'F', 'R', 'Z', 'T', 'R', 'E', 'E', '\0' };
+    const static uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+protected:
+
+    // Nodes are either owned or mapped from a snapshot file; in both cases they are
+    // immutable, so copies of the tree share them.
+    std::shared_ptr<const void> storage;
+    const Node* tree = nullptr;
+    size_t count_of_nodes = 0;
+
+    node_ptr root = NULL_PTR;
+
+protected:
+
+    Iterator makeIterator(node_ptr position) const {
+        return Iterator(position, this);
+    }
+
+    // A snapshot loaded without its checksum may hold any links, so every link is checked
+    // before it is followed, and a walk longer than the tree has nodes means a cycle.
+    // The descents pick the son first and check only it, which keeps them free of branches.
+    [[noreturn]] static void throwInvalidLink() {
+        throw std::runtime_error("Invalid link in a snapshot");
+    }
+
+    node_ptr checkLink(node_ptr x) const {
+        // NULL_PTR is -1, so every valid link maps to [0, count_of_nodes] with one comparison.
+        if (static_cast<size_t>(static_cast<uint32_t>(x + 1)) > count_of_nodes) [[unlikely]] {
+            throwInvalidLink();
+        }
+        return x;
+    }
+
+    void checkWalkLength(size_t steps) const {
+        if (steps >= count_of_nodes) [[unlikely]] {
+            throwInvalidLink();
+        }
+    }
+
+    node_ptr getLeftSon(node_ptr x) const {
+        return checkLink(tree[x].left_node);
+    }
+
+    node_ptr getRightSon(node_ptr x) const {
+        return checkLink(tree[x].right_node);
+    }
+
+    node_ptr getParent(node_ptr x) const {
+        return checkLink(tree[x].parent);
+    }
+
+    const TKey& getKey(node_ptr x) const {
+        return tree[x].data.first;
+    }
+
+    node_ptr getLowestPos(node_ptr x) const {
+        node_ptr lowest_pos = x;
+        for (size_t steps = 0; getLeftSon(lowest_pos) != NULL_PTR; ++steps) {
+            checkWalkLength(steps);
+            lowest_pos = getLeftSon(lowest_pos);
+        }
+        return lowest_pos;
+    }
+
+    // Numbers the top `height` levels of the balanced subtree built over [lo, hi)
+    // and collects the ranges of the subtrees hanging below them.
+    void placeVanEmdeBoas(size_t lo, size_t hi, size_t height, std::vector<node_ptr>& position,
+                          node_ptr& next_position, std::vector<std::pair<size_t, size_t>>& hanging) const {
+        if (lo >= hi) {
+            return;
+        }
+        if (height == 1U) {
+            size_t mid = lo + (hi - lo) / 2;
+            position[mid] = next_position++;
+            hanging.push_back({ lo, mid });
+            hanging.push_back({ mid + 1, hi });
+            return;
+        }
+
+        size_t top_height = height / 2;
+
+        std::vector<std::pair<size_t, size_t>> top_hanging;
+        placeVanEmdeBoas(lo, hi, top_height, position, next_position, top_hanging);
+
+        for (auto [sub_lo, sub_hi] : top_hanging) {
+            placeVanEmdeBoas(sub_lo, sub_hi, height - top_height, position, next_position, hanging);
+        }
+    }
+
+    static node_ptr link(Node* nodes, size_t lo, size_t hi, node_ptr parent, const std::vector<node_ptr>& position,
+                         std::vector<std::pair<TKey, TValue>>& sorted_data) {
+        if (lo >= hi) {
+            return NULL_PTR;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        node_ptr x = position[mid];
+
+        nodes[x].parent = parent;
+        nodes[x].data.first = std::move(sorted_data[mid].first);
+        nodes[x].data.second = std::move(sorted_data[mid].second);
+        nodes[x].left_node = link(nodes, lo, mid, x, position, sorted_data);
+        nodes[x].right_node = link(nodes, mid + 1, hi, x, position, sorted_data);
+
+        return x;
+    }
+
+    // Word-at-a-time multiplicative hash; fast enough to verify a snapshot at load time.
+    static uint64_t getChecksum(const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = 0x9E3779B97F4A7C15ULL ^ length;
+        size_t i = 0;
+        for (; i + 8U <= length; i += 8U) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 32;
+        }
+        for (; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    node_ptr findPosition(const TKey& key) const {
+        node_ptr current_ptr = root;
+        for (size_t steps = 0; current_ptr != NULL_PTR && getKey(current_ptr) != key; ++steps) {
+            checkWalkLength(steps);
+            current_ptr = checkLink(getKey(current_ptr) > key ? tree[current_ptr].left_node : tree[current_ptr].right_node);
+        }
+        return current_ptr;
+    }
+
+public:
+
+    FrozenTree() = default;
+
+    // `sorted_data` must be sorted by key without duplicates.
+    explicit FrozenTree(std::vector<std::pair<TKey, TValue>> sorted_data) {
+        size_t n = sorted_data.size();
+        if (n == 0U) {
+            return;
+        }
+
+        std::vector<node_ptr> position(n);
+        std::vector<std::pair<size_t, size_t>> hanging;
+        node_ptr next_position = 0;
+        placeVanEmdeBoas(0U, n, std::bit_width(n), position, next_position, hanging);
+
+        auto nodes = std::make_shared<std::vector<Node>>(n);
+        root = link(nodes->data(), 0U, n, NULL_PTR, position, sorted_data);
+
+        tree = nodes->data();
+        count_of_nodes = n;
+        storage = std::move(nodes);
+    }
+
+    // Writes the node array to `path`. Requires trivially copyable keys and values.
+    void saveSnapshot(const std::string& path) const {
+        static_assert(std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>,
+                      "Snapshots store keys and values as raw bytes");
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.format_version = SNAPSHOT_FORMAT_VERSION;
+        header.node_size = sizeof(Node);
+        header.key_size = sizeof(TKey);
+        header.value_size = sizeof(TValue);
+        header.root = root;
+        header.count_of_nodes = count_of_nodes;
+        header.checksum = getChecksum(tree, count_of_nodes * sizeof(Node));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(tree), static_cast<std::streamsize>(count_of_nodes * sizeof(Node)));
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Cannot write snapshot file " + path);
+        }
+    }
+
+    // Maps a file written by saveSnapshot and queries it in place: the nodes are not copied.
+    // The header and the file size are always checked. With `verify_checksum` the whole file is
+    // read once to check its integrity; without it, a corrupt link makes the query that follows
+    // it throw std::runtime_error.
+    static FrozenTree loadSnapshot(const std::string& path, bool verify_checksum = true) {
+        static_assert(std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>,
+                      "Snapshots store keys and values as raw bytes");
+        static_assert(std::is_trivially_copyable_v<Node>, "Snapshot nodes are mapped from the file as they are");
+
+        auto file = std::make_shared<MappedFile>(path);
+
+        SnapshotHeader header;
+        if (file->size() < sizeof(header)) {
+            throw std::runtime_error("Invalid snapshot file " + path);
+        }
+        std::memcpy(&header, file->getData(), sizeof(header));
+
+        // These checks cost O(1) and run in every mode: the root is one of the nodes, and the file
+        // holds exactly the nodes the header announces, all of which a node_ptr can address.
+        const unsigned char* data = static_cast<const unsigned char*>(file->getData());
+        bool is_valid = std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                        header.format_version == SNAPSHOT_FORMAT_VERSION &&
+                        header.node_size == sizeof(Node) && header.key_size == sizeof(TKey) &&
+                        header.value_size == sizeof(TValue) &&
+                        header.count_of_nodes <= static_cast<uint64_t>(std::numeric_limits<node_ptr>::max()) &&
+                        file->size() - sizeof(header) == header.count_of_nodes * sizeof(Node) &&
+                        (header.count_of_nodes == 0U ? header.root == NULL_PTR
+                                                     : header.root >= 0 &&
+                                                       static_cast<uint64_t>(header.root) < header.count_of_nodes);
+        if (is_valid && verify_checksum) {
+            is_valid = getChecksum(data + sizeof(header), file->size() - sizeof(header)) == header.checksum;
+        }
+        if (!is_valid) {
+            throw std::runtime_error("Invalid snapshot file " + path);
+        }
+
+        FrozenTree result;
+        result.tree = reinterpret_cast<const Node*>(data + sizeof(header));
+        result.count_of_nodes = static_cast<size_t>(header.count_of_nodes);
+        result.root = static_cast<node_ptr>(header.root);
+        result.storage = std::move(file);
+        return result;
+    }
+
+    Iterator begin() const {
+        if (empty()) {
+            return end();
+        }
+        return makeIterator(getLowestPos(root));
+    }
+
+    Iterator end() const {
+        return makeIterator(NULL_PTR);
+    }
+
+    Iterator find(const TKey& key) const {
+        return makeIterator(findPosition(key));
+    }
+
+    bool isExist(const TKey& key) const {
+        return findPosition(key) != NULL_PTR;
+    }
+
+    Iterator lowerBound(const TKey& key) const {
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr x = root;
+        for (size_t steps = 0; x != NULL_PTR; ++steps) {
+            checkWalkLength(steps);
+            bool is_bound = getKey(x) >= key;
+            nearest_pos = is_bound ? x : nearest_pos;
+            x = checkLink(is_bound ? tree[x].left_node : tree[x].right_node);
+        }
+        return makeIterator(nearest_pos);
+    }
+
+    Iterator upperBound(const TKey& key) const {
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr x = root;
+        for (size_t steps = 0; x != NULL_PTR; ++steps) {
+            checkWalkLength(steps);
+            bool is_bound = getKey(x) > key;
+            nearest_pos = is_bound ? x : nearest_pos;
+            x = checkLink(is_bound ? tree[x].left_node : tree[x].right_node);
+        }
+        return makeIterator(nearest_pos);
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        node_ptr ptr = findPosition(key);
+        if (ptr == NULL_PTR) {
+            throw std::runtime_error("No such key in table");
+        }
+        return tree[ptr].data.second;
+    }
+
+    size_t size() const {
+        return count_of_nodes;
+    }
+
+    bool empty() const {
+        return count_of_nodes == 0U;
+    }
+};
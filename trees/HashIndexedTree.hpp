@@ -0,0 +1,274 @@
+#pragma once
+
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BatchOperation.hpp"
+#include "NodeHandle.hpp"
+#include "OpenAddressingIndex.hpp"
+#include "RedBlackTree.hpp"
+
+// Ordered map with a hash index for point lookups: find, isExist and operator[]
+// are answered by a hash table of node positions, while lowerBound, upperBound
+// and iteration still walk the tree.
+// The tree never moves nodes in rotations, but erasing a node with two children
+// moves the successor's data into it, so the successor's entry is updated first.
+// The tree is a non-public base: every mutator of it is wrapped here so the index
+// cannot fall behind, and only read-only operations are re-exported as they are.
+template <typename TKey, typename TValue, typename TTree = RedBlackTree<TKey, TValue>>
+class HashIndexedTree : protected TTree {
+protected:
+
+    using Iterator = decltype(std::declval<TTree&>().begin());
+    using node_ptr = typename TTree::node_ptr;
+
+    OpenAddressingIndex<TKey> index;
+
+protected:
+
+    // Drops the entry of the element at `ptr` before the element is erased from the tree.
+    // Returns the position of the element that follows it afterwards.
+    node_ptr unindexPosition(node_ptr ptr) {
+        node_ptr next = ptr;
+        if (!this->isFictitious(this->getLeftSon(ptr)) && !this->isFictitious(this->getRightSon(ptr))) {
+            // The successor takes over this position.
+            index.assign(this->getKey(this->getLowestPos(this->getRightSon(ptr))), ptr);
+        }
+        else {
+            Iterator it = ++this->makeIterator(ptr);
+            next = it == TTree::end() ? TTree::NULL_PTR : index.find((*it).first);
+        }
+        index.erase(this->getKey(ptr));
+        return next;
+    }
+
+    // Moves the element at `ptr` out of the tree.
+    std::pair<TKey, TValue> popPosition(node_ptr ptr) {
+        unindexPosition(ptr);
+        std::pair<TKey, TValue> result(std::move(this->tree[ptr].data.first), std::move(this->tree[ptr].data.second));
+        --this->count_of_elements;
+        this->erasePosition(ptr);
+        return result;
+    }
+
+    void reindex(node_ptr x) {
+        if (x == TTree::NULL_PTR || this->isFictitious(x)) {
+            return;
+        }
+        index.assign(this->getKey(x), x);
+        reindex(this->getLeftSon(x));
+        reindex(this->getRightSon(x));
+    }
+
+    // Builds the index anew after an operation that moved many elements of the tree.
+    void reindex() {
+        index.clear();
+        reindex(this->root);
+    }
+
+public:
+
+    using TTree::begin;
+    using TTree::end;
+    using TTree::lowerBound;
+    using TTree::upperBound;
+    using TTree::size;
+    using TTree::empty;
+
+    Iterator insert(const TKey& key, const TValue& value) {
+        node_ptr ptr = index.find(key);
+        if (ptr != TTree::NULL_PTR) {
+            return this->makeIterator(ptr);
+        }
+        // Rotations relink nodes, so the key stays at the position it is written to.
+        ptr = this->findPosition(key);
+        ++this->count_of_elements;
+        this->insertPosition(ptr, key, value);
+        index.assign(key, ptr);
+        return this->makeIterator(ptr);
+    }
+
+    // Inserts the element of the handle. If the key is already present, the handle keeps the element.
+    Iterator insert(NodeHandle<TKey, TValue>&& handle) {
+        if (handle.empty()) {
+            return TTree::end();
+        }
+        node_ptr ptr = index.find(handle.getKey());
+        if (ptr != TTree::NULL_PTR) {
+            return this->makeIterator(ptr);
+        }
+        ptr = this->findPosition(handle.getKey());
+        ++this->count_of_elements;
+        auto data = handle.release();
+        index.assign(data.first, ptr);
+        this->insertPosition(ptr, std::move(data.first), std::move(data.second));
+        return this->makeIterator(ptr);
+    }
+
+    Iterator erase(const TKey& key) {
+        node_ptr ptr = index.find(key);
+        if (ptr == TTree::NULL_PTR) {
+            throw std::out_of_range("No such key in the tree");
+        }
+
+        node_ptr next = unindexPosition(ptr);
+        --this->count_of_elements;
+        this->erasePosition(ptr);
+        return this->makeIterator(next);
+    }
+
+    Iterator erase(Iterator it) {
+        if (it == TTree::end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        return erase((*it).first);
+    }
+
+    // Erases the elements of [first, last) and returns the iterator to the element after them.
+    // A large range is left to the tree, which rebuilds itself, and the index is built anew.
+    Iterator eraseRange(Iterator first, Iterator last) {
+        size_t count = 0;
+        for (auto it = first; it != last; ++it) {
+            ++count;
+        }
+        if (count * TTree::REBUILD_ERASE_RATIO >= size()) {
+            Iterator result = TTree::eraseRange(first, last);
+            reindex();
+            return result;
+        }
+        for (; count > 0U; --count) {
+            first = erase(first);
+        }
+        return first;
+    }
+
+    // Erases the elements for which `predicate(key, value)` is true and returns their number.
+    template <typename TPredicate>
+    size_t eraseIf(TPredicate predicate) {
+        size_t count = TTree::eraseIf(predicate);
+        if (count > 0U) {
+            reindex();
+        }
+        return count;
+    }
+
+    // Applies a batch of updates sorted by key, see TTree::applyBatch. A small batch goes
+    // through insert and erase here; a large one rebuilds the tree and then the index.
+    std::vector<bool> applyBatch(std::span<const BatchOperation<TKey, TValue>> batch) {
+        if (batch.size() * TTree::REBUILD_BATCH_RATIO >= size()) {
+            std::vector<bool> result = TTree::applyBatch(batch);
+            reindex();
+            return result;
+        }
+        for (size_t i = 1; i < batch.size(); ++i) {
+            if (batch[i].key < batch[i - 1].key) {
+                throw std::invalid_argument("The batch is not sorted by key");
+            }
+        }
+        std::vector<bool> result(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const BatchOperation<TKey, TValue>& operation = batch[i];
+            node_ptr ptr = index.find(operation.key);
+            result[i] = (operation.type == BatchOperation<TKey, TValue>::Type::UPSERT) == (ptr == TTree::NULL_PTR);
+            if (operation.type == BatchOperation<TKey, TValue>::Type::ERASE) {
+                if (ptr != TTree::NULL_PTR) {
+                    erase(operation.key);
+                }
+            }
+            else if (ptr != TTree::NULL_PTR) {
+                this->tree[ptr].data.second = operation.value;
+            }
+            else {
+                insert(operation.key, operation.value);
+            }
+        }
+        return result;
+    }
+
+    // Replaces the contents with `elements`, see TTree::buildParallel.
+    void buildParallel(std::vector<std::pair<TKey, TValue>> elements, size_t count_of_threads = 0) {
+        TTree::buildParallel(std::move(elements), count_of_threads);
+        reindex();
+    }
+
+    // Removes the element and hands its key and value over without copying them.
+    NodeHandle<TKey, TValue> extract(const TKey& key) {
+        node_ptr ptr = index.find(key);
+        if (ptr == TTree::NULL_PTR) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        auto data = popPosition(ptr);
+        return NodeHandle<TKey, TValue>(std::move(data.first), std::move(data.second));
+    }
+
+    NodeHandle<TKey, TValue> extract(Iterator it) {
+        if (it == TTree::end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        return extract((*it).first);
+    }
+
+    // Moves every element of `other` whose key is not in this tree; the rest stay in `other`.
+    void merge(HashIndexedTree& other) {
+        std::vector<TKey> moved_keys;
+        for (auto it = other.begin(); it != other.end(); ++it) {
+            if (!isExist((*it).first)) {
+                moved_keys.push_back((*it).first);
+            }
+        }
+        for (const TKey& key : moved_keys) {
+            insert(other.extract(key));
+        }
+    }
+
+    // Removes and returns the element with the smallest key.
+    std::pair<TKey, TValue> popMin() {
+        if (empty()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        return popPosition(this->getLowestPos(this->root));
+    }
+
+    // Removes and returns the element with the largest key.
+    std::pair<TKey, TValue> popMax() {
+        if (empty()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        node_ptr ptr = this->root;
+        while (!this->isFictitious(this->getRightSon(ptr))) {
+            ptr = this->getRightSon(ptr);
+        }
+        return popPosition(ptr);
+    }
+
+    Iterator find(const TKey& key) const {
+        return this->makeIterator(index.find(key));
+    }
+
+    bool isExist(const TKey& key) const {
+        return index.find(key) != TTree::NULL_PTR;
+    }
+
+    TValue& operator[](const TKey& key) {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    void clear() {
+        TTree::clear();
+        index.clear();
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <compare>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "RedBlackTree.hpp"
+
+// Closed interval [low, high]; intervals are ordered by `low`, then by `high`.
+template <typename TPoint>
+struct Interval {
+    TPoint low;
+    TPoint high;
+
+    auto operator<=>(const Interval&) const = default;
+};
+
+// What an interval tree node stores next to its interval.
+template <typename TPoint, typename TValue>
+struct IntervalEntry {
+    TValue value;
+
+    // The largest `high` in the subtree of the node.
+    TPoint max_high;
+};
+
+// Keeps `max_high` of a node equal to the largest end of the intervals in its subtree.
+struct MaxHighAugmentation {
+    template <typename TData>
+    static bool update(TData& data, const TData* left, const TData* right) {
+        auto max_high = data.first.high;
+        if (left != nullptr && max_high < left->second.max_high) {
+            max_high = left->second.max_high;
+        }
+        if (right != nullptr && max_high < right->second.max_high) {
+            max_high = right->second.max_high;
+        }
+        bool is_changed = max_high != data.second.max_high;
+        data.second.max_high = max_high;
+        return is_changed;
+    }
+};
+
+// Map from closed intervals to values that finds the intervals overlapping a point or a range.
+// It is a red-black tree ordered by the start of the intervals whose nodes also keep the largest
+// end in their subtree, so a query skips every subtree that ends before it and stops at the first
+// interval that starts after it. A query reporting k intervals takes O(min(n, (k + 1) log n)).
+template <typename TPoint, typename TValue>
+class IntervalTree : protected RedBlackTree<Interval<TPoint>, IntervalEntry<TPoint, TValue>, std::vector,
+                                            MaxHighAugmentation> {
+protected:
+
+    using Base = RedBlackTree<Interval<TPoint>, IntervalEntry<TPoint, TValue>, std::vector, MaxHighAugmentation>;
+
+    using typename Base::node_ptr;
+
+protected:
+
+    template <typename TCallback>
+    void forEachOverlapping(node_ptr x, const TPoint& low, const TPoint& high, TCallback& callback) const {
+        // No interval of the subtree reaches `low`.
+        if (this->isFictitious(x) || this->getValue(x).max_high < low) {
+            return;
+        }
+        forEachOverlapping(this->getLeftSon(x), low, high, callback);
+
+        // This interval and the ones of the right subtree start after `high`.
+        const Interval<TPoint>& interval = this->getKey(x);
+        if (high < interval.low) {
+            return;
+        }
+        if (!(interval.high < low)) {
+            callback(interval, this->getValue(x).value);
+        }
+        forEachOverlapping(this->getRightSon(x), low, high, callback);
+    }
+
+public:
+
+    using Base::size;
+    using Base::empty;
+    using Base::clear;
+
+    // Returns false and keeps the old value if the interval is already present.
+    bool insert(const Interval<TPoint>& interval, const TValue& value) {
+        if (interval.high < interval.low) {
+            throw std::invalid_argument("The interval ends before it starts");
+        }
+        node_ptr ptr = this->findPosition(interval);
+        if (!this->isFictitious(ptr)) {
+            return false;
+        }
+        ++this->count_of_elements;
+        this->insertPosition(ptr, interval, IntervalEntry<TPoint, TValue>{ value, interval.high });
+        return true;
+    }
+
+    void erase(const Interval<TPoint>& interval) {
+        Base::erase(interval);
+    }
+
+    bool isExist(const Interval<TPoint>& interval) const {
+        return Base::isExist(interval);
+    }
+
+    TValue& operator[](const Interval<TPoint>& interval) {
+        return Base::operator[](interval).value;
+    }
+
+    const TValue& operator[](const Interval<TPoint>& interval) const {
+        return Base::operator[](interval).value;
+    }
+
+    // Calls `callback(interval, value)` for every interval that contains the point, in the order
+    // of the intervals. Allocates nothing.
+    template <typename TCallback>
+    void forEachOverlapping(const TPoint& point, TCallback callback) const {
+        forEachOverlapping(this->root, point, point, callback);
+    }
+
+    // Calls `callback(interval, value)` for every interval that shares a point with [low, high].
+    template <typename TCallback>
+    void forEachOverlapping(const TPoint& low, const TPoint& high, TCallback callback) const {
+        forEachOverlapping(this->root, low, high, callback);
+    }
+
+    std::vector<std::pair<Interval<TPoint>, TValue>> overlapping(const TPoint& point) const {
+        return overlapping(point, point);
+    }
+
+    std::vector<std::pair<Interval<TPoint>, TValue>> overlapping(const TPoint& low, const TPoint& high) const {
+        std::vector<std::pair<Interval<TPoint>, TValue>> result;
+        forEachOverlapping(low, high, [&result](const Interval<TPoint>& interval, const TValue& value) {
+            result.emplace_back(interval, value);
+        });
+        return result;
+    }
+};
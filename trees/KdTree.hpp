@@ -0,0 +1,409 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Map from points of a `Dimensions`-dimensional space to values, for orthogonal range
+// and nearest-neighbour queries.
+//
+// Each node splits its subtree by one coordinate, cycling through them with the depth:
+// the left subtree holds the points with a smaller coordinate, the right one those with a larger
+// one, and equal coordinates are told apart by the next coordinates in the same cyclic order.
+// Distinct points are thus never tied, so a rebuild balances even heavily repeated coordinates.
+// A bulk build splits at the median. Inserts keep the tree balanced the scapegoat way:
+// a subtree in which one son holds more than 3/4 of the nodes is rebuilt at the median.
+// Erased points stay in the tree as tombstones until their subtree is rebuilt, and the whole
+// tree is rebuilt once the tombstones outnumber the points.
+template <typename TCoordinate, size_t Dimensions, typename TValue, template <typename...> class TContainer = std::vector>
+class KdTree {
+    static_assert(Dimensions > 0U, "Points need at least one coordinate");
+
+public:
+
+    using Point = std::array<TCoordinate, Dimensions>;
+
+protected:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+    // Subtrees smaller than this are never rebuilt for balance.
+    const static size_t MIN_REBUILT_SIZE = 8;
+
+    struct Node {
+
+        node_ptr left_node, right_node;
+
+        // Number of nodes in the subtree, tombstones included.
+        size_t size;
+
+        std::pair<Point, TValue> data;
+
+        // The coordinate the node splits its subtree by.
+        uint32_t axis;
+
+        bool is_erased;
+    };
+
+    TContainer<Node> tree;
+    size_t count_of_elements = 0;
+    size_t count_of_erased = 0;
+
+    node_ptr root = NULL_PTR;
+
+    TContainer<node_ptr> free_poses;
+
+protected:
+
+    node_ptr createNode(const Point& point, const TValue& value, uint32_t axis) {
+        if (free_poses.empty()) {
+            free_poses.push_back(static_cast<node_ptr>(tree.size()));
+            tree.push_back(Node());
+        }
+        node_ptr ptr = free_poses.back();
+        free_poses.pop_back();
+
+        tree[ptr].left_node = NULL_PTR;
+        tree[ptr].right_node = NULL_PTR;
+        tree[ptr].size = 1U;
+        tree[ptr].data = { point, value };
+        tree[ptr].axis = axis;
+        tree[ptr].is_erased = false;
+
+        return ptr;
+    }
+
+    void deleteNode(node_ptr ptr) {
+        free_poses.push_back(ptr);
+    }
+
+    size_t getSize(node_ptr x) const {
+        return x == NULL_PTR ? 0U : tree[x].size;
+    }
+
+    const Point& getPoint(node_ptr x) const {
+        return tree[x].data.first;
+    }
+
+    static uint32_t getNextAxis(uint32_t axis) {
+        return axis + 1U == Dimensions ? 0U : axis + 1U;
+    }
+
+    // Compares the coordinates from `axis` on, wrapping around to the first ones.
+    static bool isBefore(const Point& lhs, const Point& rhs, uint32_t axis) {
+        for (size_t i = 0; i < Dimensions; ++i, axis = getNextAxis(axis)) {
+            if (lhs[axis] < rhs[axis]) {
+                return true;
+            }
+            if (rhs[axis] < lhs[axis]) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Whether `point` belongs to the right subtree of `x`.
+    bool isRightOf(node_ptr x, const Point& point) const {
+        return !isBefore(point, getPoint(x), tree[x].axis);
+    }
+
+    static bool isUnbalanced(size_t size, size_t max_son_size) {
+        return size >= MIN_REBUILT_SIZE && max_son_size * 4U > size * 3U;
+    }
+
+    void setSon(node_ptr parent, bool is_right, node_ptr son) {
+        if (parent == NULL_PTR) {
+            root = son;
+        }
+        else if (is_right) {
+            tree[parent].right_node = son;
+        }
+        else {
+            tree[parent].left_node = son;
+        }
+    }
+
+    // The node with the point, tombstones included, or NULL_PTR.
+    node_ptr findPosition(const Point& point) const {
+        node_ptr current_ptr = root;
+        while (current_ptr != NULL_PTR && getPoint(current_ptr) != point) {
+            current_ptr = isRightOf(current_ptr, point) ? tree[current_ptr].right_node : tree[current_ptr].left_node;
+        }
+        return current_ptr;
+    }
+
+    // Collects the live nodes of the subtree and frees its tombstones.
+    void collectSubtree(node_ptr x, std::vector<node_ptr>& poses) {
+        if (x == NULL_PTR) {
+            return;
+        }
+        collectSubtree(tree[x].left_node, poses);
+        collectSubtree(tree[x].right_node, poses);
+        if (tree[x].is_erased) {
+            --count_of_erased;
+            deleteNode(x);
+        }
+        else {
+            poses.push_back(x);
+        }
+    }
+
+    // Links the nodes of [begin, end) into a subtree split at the median by `axis`, then by the next
+    // coordinates. The points are distinct, so the halves differ in size by at most one.
+    node_ptr buildSubtree(std::vector<node_ptr>& poses, size_t begin, size_t end, uint32_t axis) {
+        if (begin == end) {
+            return NULL_PTR;
+        }
+        size_t middle = begin + (end - begin) / 2U;
+        std::nth_element(poses.begin() + begin, poses.begin() + middle, poses.begin() + end,
+                         [this, axis](node_ptr lhs, node_ptr rhs) {
+            return isBefore(getPoint(lhs), getPoint(rhs), axis);
+        });
+
+        node_ptr ptr = poses[middle];
+        tree[ptr].axis = axis;
+        tree[ptr].left_node = buildSubtree(poses, begin, middle, getNextAxis(axis));
+        tree[ptr].right_node = buildSubtree(poses, middle + 1U, end, getNextAxis(axis));
+        tree[ptr].size = end - begin;
+        return ptr;
+    }
+
+    node_ptr rebuildSubtree(node_ptr x) {
+        uint32_t axis = tree[x].axis;
+        std::vector<node_ptr> poses;
+        poses.reserve(tree[x].size);
+        collectSubtree(x, poses);
+        return buildSubtree(poses, 0U, poses.size(), axis);
+    }
+
+    void rebuild() {
+        if (root != NULL_PTR) {
+            root = rebuildSubtree(root);
+        }
+    }
+
+    template <typename TCallback>
+    void forEachInRange(node_ptr x, const Point& low, const Point& high, TCallback& callback) const {
+        if (x == NULL_PTR) {
+            return;
+        }
+        const Point& point = getPoint(x);
+        // Points with the coordinate of the split may be on either side.
+        uint32_t axis = tree[x].axis;
+        if (!(point[axis] < low[axis])) {
+            forEachInRange(tree[x].left_node, low, high, callback);
+        }
+        if (!tree[x].is_erased) {
+            bool is_inside = true;
+            for (size_t i = 0; i < Dimensions && is_inside; ++i) {
+                is_inside = !(point[i] < low[i]) && !(high[i] < point[i]);
+            }
+            if (is_inside) {
+                callback(point, tree[x].data.second);
+            }
+        }
+        if (!(high[axis] < point[axis])) {
+            forEachInRange(tree[x].right_node, low, high, callback);
+        }
+    }
+
+    static double getSquaredDistance(const Point& lhs, const Point& rhs) {
+        double result = 0.0;
+        for (size_t i = 0; i < Dimensions; ++i) {
+            double difference = static_cast<double>(lhs[i]) - static_cast<double>(rhs[i]);
+            result += difference * difference;
+        }
+        return result;
+    }
+
+    // `nearest` is a max-heap of the best `k` nodes found so far, by their squared distance.
+    void findNearest(node_ptr x, const Point& point, size_t k, std::priority_queue<std::pair<double, node_ptr>>& nearest) const {
+        if (x == NULL_PTR) {
+            return;
+        }
+        if (!tree[x].is_erased) {
+            double distance = getSquaredDistance(getPoint(x), point);
+            if (nearest.size() < k) {
+                nearest.emplace(distance, x);
+            }
+            else if (distance < nearest.top().first) {
+                nearest.pop();
+                nearest.emplace(distance, x);
+            }
+        }
+
+        // The side of the split plane the point is on goes first; the other side is only searched
+        // if the plane is closer than the k-th best distance.
+        uint32_t axis = tree[x].axis;
+        bool is_right = isRightOf(x, point);
+        findNearest(is_right ? tree[x].right_node : tree[x].left_node, point, k, nearest);
+        double plane_distance = static_cast<double>(point[axis]) - static_cast<double>(getPoint(x)[axis]);
+        if (nearest.size() < k || plane_distance * plane_distance < nearest.top().first) {
+            findNearest(is_right ? tree[x].left_node : tree[x].right_node, point, k, nearest);
+        }
+    }
+
+public:
+
+    KdTree() = default;
+
+    // Builds a balanced tree at once; of equal points the first one is kept.
+    explicit KdTree(const std::vector<std::pair<Point, TValue>>& elements) {
+        std::vector<node_ptr> poses;
+        poses.reserve(elements.size());
+        for (const auto& [point, value] : elements) {
+            poses.push_back(createNode(point, value, 0U));
+        }
+        std::stable_sort(poses.begin(), poses.end(), [this](node_ptr lhs, node_ptr rhs) {
+            return getPoint(lhs) < getPoint(rhs);
+        });
+        auto last = std::unique(poses.begin(), poses.end(), [this](node_ptr lhs, node_ptr rhs) {
+            return getPoint(lhs) == getPoint(rhs);
+        });
+        for (auto it = last; it != poses.end(); ++it) {
+            deleteNode(*it);
+        }
+        poses.erase(last, poses.end());
+
+        count_of_elements = poses.size();
+        root = buildSubtree(poses, 0U, poses.size(), 0U);
+    }
+
+    // Returns false and keeps the old value if the point is already present.
+    bool insert(const Point& point, const TValue& value) {
+        node_ptr ptr = findPosition(point);
+        if (ptr != NULL_PTR) {
+            if (!tree[ptr].is_erased) {
+                return false;
+            }
+            tree[ptr].is_erased = false;
+            tree[ptr].data.second = value;
+            --count_of_erased;
+            ++count_of_elements;
+            return true;
+        }
+
+        // The highest node on the path that gets unbalanced, and where it hangs.
+        node_ptr scapegoat = NULL_PTR;
+        node_ptr scapegoat_parent = NULL_PTR;
+        bool is_scapegoat_right = false;
+
+        node_ptr parent = NULL_PTR;
+        bool is_right_son = false;
+        uint32_t axis = 0U;
+        for (node_ptr current_ptr = root; current_ptr != NULL_PTR;) {
+            size_t size = ++tree[current_ptr].size;
+            bool is_right = isRightOf(current_ptr, point);
+            size_t path_son_size = getSize(is_right ? tree[current_ptr].right_node : tree[current_ptr].left_node) + 1U;
+            size_t other_son_size = getSize(is_right ? tree[current_ptr].left_node : tree[current_ptr].right_node);
+            if (scapegoat == NULL_PTR && isUnbalanced(size, std::max(path_son_size, other_son_size))) {
+                scapegoat = current_ptr;
+                scapegoat_parent = parent;
+                is_scapegoat_right = is_right_son;
+            }
+
+            axis = getNextAxis(tree[current_ptr].axis);
+            parent = current_ptr;
+            is_right_son = is_right;
+            current_ptr = is_right ? tree[current_ptr].right_node : tree[current_ptr].left_node;
+        }
+
+        ++count_of_elements;
+        setSon(parent, is_right_son, createNode(point, value, axis));
+        if (scapegoat != NULL_PTR) {
+            size_t old_size = tree[scapegoat].size;
+            node_ptr rebuilt = rebuildSubtree(scapegoat);
+            setSon(scapegoat_parent, is_scapegoat_right, rebuilt);
+
+            // The tombstones freed by the rebuild no longer count in the sizes above it.
+            size_t count_of_freed = old_size - tree[rebuilt].size;
+            for (node_ptr x = root; x != rebuilt; x = isRightOf(x, point) ? tree[x].right_node : tree[x].left_node) {
+                tree[x].size -= count_of_freed;
+            }
+        }
+        return true;
+    }
+
+    void erase(const Point& point) {
+        node_ptr ptr = findPosition(point);
+        if (ptr == NULL_PTR || tree[ptr].is_erased) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        tree[ptr].is_erased = true;
+        --count_of_elements;
+        ++count_of_erased;
+        if (count_of_erased > count_of_elements) {
+            rebuild();
+        }
+    }
+
+    bool isExist(const Point& point) const {
+        node_ptr ptr = findPosition(point);
+        return ptr != NULL_PTR && !tree[ptr].is_erased;
+    }
+
+    TValue& operator[](const Point& point) {
+        node_ptr ptr = findPosition(point);
+        if (ptr == NULL_PTR || tree[ptr].is_erased) {
+            throw std::runtime_error("No such key in table");
+        }
+        return tree[ptr].data.second;
+    }
+
+    const TValue& operator[](const Point& point) const {
+        node_ptr ptr = findPosition(point);
+        if (ptr == NULL_PTR || tree[ptr].is_erased) {
+            throw std::runtime_error("No such key in table");
+        }
+        return tree[ptr].data.second;
+    }
+
+    // Calls `callback(point, value)` for every point with low[i] <= point[i] <= high[i] in each coordinate.
+    template <typename TCallback>
+    void forEachInRange(const Point& low, const Point& high, TCallback callback) const {
+        forEachInRange(root, low, high, callback);
+    }
+
+    std::vector<std::pair<Point, TValue>> inRange(const Point& low, const Point& high) const {
+        std::vector<std::pair<Point, TValue>> result;
+        forEachInRange(low, high, [&result](const Point& point, const TValue& value) {
+            result.emplace_back(point, value);
+        });
+        return result;
+    }
+
+    // The `k` points closest to `point` by Euclidean distance, the closest first.
+    std::vector<std::pair<Point, TValue>> nearest(const Point& point, size_t k) const {
+        std::priority_queue<std::pair<double, node_ptr>> nearest;
+        if (k > 0U) {
+            findNearest(root, point, k, nearest);
+        }
+        std::vector<std::pair<Point, TValue>> result(nearest.size());
+        for (size_t i = result.size(); i > 0U; --i) {
+            result[i - 1U] = tree[nearest.top().second].data;
+            nearest.pop();
+        }
+        return result;
+    }
+
+    size_t size() const {
+        return count_of_elements;
+    }
+
+    bool empty() const {
+        return count_of_elements == 0U;
+    }
+
+    void clear() {
+        tree.clear();
+        free_poses.clear();
+        count_of_elements = 0U;
+        count_of_erased = 0U;
+        root = NULL_PTR;
+    }
+};
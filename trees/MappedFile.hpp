@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+protected:
+
+    const void* data = nullptr;
+    size_t length = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+protected:
+
+    void unmap() {
+#ifdef _WIN32
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (data != nullptr) {
+            munmap(const_cast<void*>(data), length);
+        }
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+public:
+
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER file_size;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size)) {
+            unmap();
+            throw std::runtime_error("Cannot open file " + path);
+        }
+        length = static_cast<size_t>(file_size.QuadPart);
+        if (length == 0U) {
+            return;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+        if (data == nullptr) {
+            unmap();
+            throw std::runtime_error("Cannot map file " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat file_stat;
+        if (fd < 0 || fstat(fd, &file_stat) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::runtime_error("Cannot open file " + path);
+        }
+        length = static_cast<size_t>(file_stat.st_size);
+        if (length == 0U) {
+            close(fd);
+            return;
+        }
+        void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            length = 0;
+            throw std::runtime_error("Cannot map file " + path);
+        }
+        data = address;
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    const void* getData() const {
+        return data;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Redo journal that makes a flush of several files atomic. The byte ranges to be written are
+// collected, written to the journal with a checksum and synced; only then are they written to
+// their files. After a crash, recover() writes a complete journal to the files again and drops
+// a torn one, so the files hold either every range of a flush or none of them.
+// Files are named relative to the directory of the journal.
+class MappedJournal {
+public:
+
+#ifdef _WIN32
+    using NativeFile = HANDLE;
+#else
+    using NativeFile = int;
+#endif
+
+protected:
+
+    constexpr static char MAGIC[8] = { 'M', 'V', 'J', 'O', 'U', 'R', 'N', '\0' };
+
+    // Ends a committed journal.
+    struct Trailer {
+        char magic[8];
+        uint64_t records_length;
+        uint64_t checksum;
+    };
+
+    std::string path;
+
+    // Each record is the length of the file name, the name, the offset, the length and the bytes.
+    std::vector<unsigned char> records;
+
+protected:
+
+    static uint64_t getChecksum(const unsigned char* bytes, size_t length) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    void appendBytes(const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        records.insert(records.end(), bytes, bytes + length);
+    }
+
+    void appendWord(uint64_t word) {
+        appendBytes(&word, sizeof(word));
+    }
+
+    static uint64_t readWord(const std::vector<unsigned char>& bytes, size_t& position) {
+        if (bytes.size() - position < sizeof(uint64_t)) {
+            throw std::runtime_error("Invalid journal record");
+        }
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + position, sizeof(word));
+        position += sizeof(word);
+        return word;
+    }
+
+    static std::filesystem::path getDirectory(const std::string& file_path) {
+        std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+        return directory.empty() ? std::filesystem::path(".") : directory;
+    }
+
+public:
+
+    static NativeFile openNative(const std::string& file_path, bool is_truncated) {
+#ifdef _WIN32
+        NativeFile file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                      nullptr, is_truncated ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file " + file_path);
+        }
+#else
+        NativeFile file = open(file_path.c_str(), O_RDWR | O_CREAT | (is_truncated ? O_TRUNC : 0), 0644);
+        if (file < 0) {
+            throw std::runtime_error("Cannot open file " + file_path);
+        }
+#endif
+        return file;
+    }
+
+    static void closeNative(NativeFile file) {
+#ifdef _WIN32
+        CloseHandle(file);
+#else
+        close(file);
+#endif
+    }
+
+    static void writeNative(NativeFile file, uint64_t offset, const void* data, size_t length) {
+        const char* bytes = static_cast<const char*>(data);
+        while (length > 0U) {
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFU);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD written = 0;
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(length, 1U << 30));
+            if (!WriteFile(file, bytes, chunk, &written, &overlapped) || written == 0) {
+                throw std::runtime_error("Cannot write file");
+            }
+#else
+            ssize_t written = pwrite(file, bytes, length, static_cast<off_t>(offset));
+            if (written <= 0) {
+                throw std::runtime_error("Cannot write file");
+            }
+#endif
+            bytes += written;
+            offset += static_cast<uint64_t>(written);
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    static void syncNative(NativeFile file) {
+#ifdef _WIN32
+        bool is_synced = FlushFileBuffers(file);
+#else
+        bool is_synced = fsync(file) == 0;
+#endif
+        if (!is_synced) {
+            throw std::runtime_error("Cannot sync file");
+        }
+    }
+
+    // Makes the creation of the files in the directory of `file_path` durable. Windows has
+    // no fsync for directories, and NTFS journals the creation of files itself.
+    static void syncDirectory(const std::string& file_path) {
+#ifndef _WIN32
+        std::filesystem::path directory = getDirectory(file_path);
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open directory " + directory.string());
+        }
+        int result = fsync(fd);
+        close(fd);
+        if (result != 0) {
+            throw std::runtime_error("Cannot sync directory " + directory.string());
+        }
+#endif
+    }
+
+    explicit MappedJournal(std::string path) :
+        path(std::move(path))
+    {}
+
+    // Adds the `length` bytes to be written at `offset` of the file `name`.
+    void append(const std::string& name, uint64_t offset, const void* data, size_t length) {
+        appendWord(name.size());
+        appendBytes(name.data(), name.size());
+        appendWord(offset);
+        appendWord(length);
+        appendBytes(data, length);
+    }
+
+    bool empty() const {
+        return records.empty();
+    }
+
+    // Writes the journal and waits until it is on the disk. From here on the flush survives a crash.
+    void commit() {
+        Trailer trailer;
+        std::memcpy(trailer.magic, MAGIC, sizeof(MAGIC));
+        trailer.records_length = records.size();
+        trailer.checksum = getChecksum(records.data(), records.size());
+
+        bool is_new = !std::filesystem::exists(path);
+        NativeFile file = openNative(path, true);
+        try {
+            writeNative(file, 0U, records.data(), records.size());
+            writeNative(file, records.size(), &trailer, sizeof(trailer));
+            syncNative(file);
+        }
+        catch (...) {
+            closeNative(file);
+            throw;
+        }
+        closeNative(file);
+        if (is_new) {
+            syncDirectory(path);
+        }
+    }
+
+    // Empties the journal once its records are in their files.
+    void clear() {
+        records.clear();
+        NativeFile file = openNative(path, true);
+        try {
+            syncNative(file);
+        }
+        catch (...) {
+            closeNative(file);
+            throw;
+        }
+        closeNative(file);
+    }
+
+    // Writes a committed journal at `journal_path` to its files and empties it. A torn journal
+    // belongs to a flush that never committed and changed none of the files, so it is dropped.
+    static void recover(const std::string& journal_path) {
+        std::vector<unsigned char> bytes;
+        {
+            std::ifstream input(journal_path, std::ios::binary);
+            if (!input) {
+                return;
+            }
+            bytes.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        }
+        if (bytes.empty()) {
+            return;
+        }
+
+        Trailer trailer;
+        bool is_committed = bytes.size() >= sizeof(Trailer);
+        if (is_committed) {
+            std::memcpy(&trailer, bytes.data() + bytes.size() - sizeof(Trailer), sizeof(Trailer));
+            bytes.resize(bytes.size() - sizeof(Trailer));
+            is_committed = std::memcmp(trailer.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                           trailer.records_length == bytes.size() &&
+                           trailer.checksum == getChecksum(bytes.data(), bytes.size());
+        }
+
+        if (is_committed) {
+            std::map<std::string, NativeFile> files;
+            try {
+                size_t position = 0;
+                while (position < bytes.size()) {
+                    uint64_t name_length = readWord(bytes, position);
+                    if (bytes.size() - position < name_length) {
+                        throw std::runtime_error("Invalid journal record");
+                    }
+                    std::string name(bytes.begin() + position, bytes.begin() + position + name_length);
+                    position += name_length;
+                    uint64_t offset = readWord(bytes, position);
+                    uint64_t length = readWord(bytes, position);
+                    if (bytes.size() - position < length) {
+                        throw std::runtime_error("Invalid journal record");
+                    }
+
+                    auto it = files.find(name);
+                    if (it == files.end()) {
+                        it = files.emplace(name, openNative((getDirectory(journal_path) / name).string(), false)).first;
+                    }
+                    writeNative(it->second, offset, bytes.data() + position, length);
+                    position += length;
+                }
+                for (auto [name, file] : files) {
+                    syncNative(file);
+                }
+            }
+            catch (...) {
+                for (auto [name, file] : files) {
+                    closeNative(file);
+                }
+                throw;
+            }
+            for (auto [name, file] : files) {
+                closeNative(file);
+            }
+        }
+        MappedJournal(journal_path).clear();
+    }
+};
@@ -0,0 +1,468 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedJournal.hpp"
+
+// Growable array stored in a memory-mapped file, so it may be larger than RAM:
+// the OS pages cold parts out and back in. Can be used as the TContainer of
+// AVLTree and RedBlackTree, which then keep their node pool in the file.
+// The default constructor uses an anonymous temporary file; the path constructor
+// reopens the elements stored in that file. Elements are stored as raw bytes.
+// A file opened by path is mapped copy-on-write, so changes reach it only through
+// flush(), which is a durability point: the pages changed since the previous flush go
+// to a journal (`path`.journal) first and to the file after it is synced, so after a
+// crash the file reopens as of the last completed flush. Until then the changed pages
+// are held in memory, so a vector much larger than RAM should be flushed now and then.
+template <typename T>
+class MappedVector {
+    static_assert(std::is_trivially_destructible_v<T>, "Elements are stored in the file as raw bytes");
+
+public:
+
+    // Words of the file header reserved for the owner of the vector.
+    const static size_t COUNT_OF_USER_WORDS = 4;
+
+protected:
+
+    struct Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t count_of_elements;
+        uint64_t user_data[COUNT_OF_USER_WORDS];
+        uint64_t reserved;
+    };
+
+    constexpr static char MAGIC[8] = { 'M', 'V', 'E', 'C', 'T', 'O', 'R', '\0' };
+
+    const static size_t DATA_OFFSET = 64;
+    const static size_t MIN_CAPACITY_BYTES = 1U << 16;
+
+    static_assert(sizeof(Header) <= DATA_OFFSET && alignof(T) <= DATA_OFFSET);
+
+    unsigned char* base = nullptr;
+    size_t mapped_length = 0;
+    size_t capacity = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    std::string path;
+
+    // A temporary file is mapped shared and needs no durability; a file opened by path is mapped
+    // copy-on-write, and the pages written since the last flush are marked in `dirty_pages`.
+    bool is_journaled = false;
+    size_t page_size = 0;
+    std::vector<uint64_t> dirty_pages;
+
+    template <typename>
+    friend class MappedVector;
+
+protected:
+
+    Header& getHeader() const {
+        return *reinterpret_cast<Header*>(base);
+    }
+
+    T* getElements() const {
+        return reinterpret_cast<T*>(base + DATA_OFFSET);
+    }
+
+    static size_t getPageSize() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    // Marks the pages of the bytes [offset, offset + length) as written since the last flush.
+    void markDirty(size_t offset, size_t length) {
+        if (!is_journaled) {
+            return;
+        }
+        for (size_t page = offset / page_size; page <= (offset + length - 1U) / page_size; ++page) {
+            dirty_pages[page / 64U] |= uint64_t(1) << (page % 64U);
+        }
+    }
+
+    void markElementDirty(size_t index) {
+        markDirty(DATA_OFFSET + index * sizeof(T), sizeof(T));
+    }
+
+    void markHeaderDirty() {
+        markDirty(0U, sizeof(Header));
+    }
+
+    // Calls `callback(offset, length)` for each run of consecutive dirty pages of the mapping.
+    template <typename TCallback>
+    void forEachDirtyRun(TCallback callback) const {
+        size_t count_of_pages = (mapped_length + page_size - 1U) / page_size;
+        size_t page = 0;
+        while (page < count_of_pages) {
+            if ((dirty_pages[page / 64U] >> (page % 64U) & 1U) == 0U) {
+                ++page;
+                continue;
+            }
+            size_t first = page;
+            while (page < count_of_pages && (dirty_pages[page / 64U] >> (page % 64U) & 1U) != 0U) {
+                ++page;
+            }
+            size_t offset = first * page_size;
+            callback(offset, std::min(page * page_size, mapped_length) - offset);
+        }
+    }
+
+    void resizeDirtyPages() {
+        if (is_journaled) {
+            dirty_pages.resize(((mapped_length + page_size - 1U) / page_size + 63U) / 64U, 0U);
+        }
+    }
+
+    // Adds the dirty pages to `journal`, under the name of the file in its directory.
+    void addToJournal(MappedJournal& journal) const {
+        std::string name = std::filesystem::path(path).filename().string();
+        forEachDirtyRun([&](size_t offset, size_t length) {
+            journal.append(name, offset, base + offset, length);
+        });
+    }
+
+    // Writes the dirty pages to the file and syncs it. The private copies of the pages are then
+    // dropped, so the pages are read from the file again and stop taking memory.
+    void writeDirtyPages() {
+#ifdef _WIN32
+        MappedJournal::NativeFile native_file = file;
+#else
+        MappedJournal::NativeFile native_file = fd;
+#endif
+        forEachDirtyRun([&](size_t offset, size_t length) {
+            MappedJournal::writeNative(native_file, offset, base + offset, length);
+        });
+        MappedJournal::syncNative(native_file);
+#ifndef _WIN32
+        forEachDirtyRun([&](size_t offset, size_t length) {
+            madvise(base + offset, length, MADV_DONTNEED);
+        });
+#endif
+        std::fill(dirty_pages.begin(), dirty_pages.end(), 0U);
+    }
+
+    void openFile(const std::string& path, bool is_temporary) {
+#ifdef _WIN32
+        std::string file_path = path;
+        DWORD flags = FILE_ATTRIBUTE_NORMAL;
+        if (is_temporary) {
+            char directory[MAX_PATH + 1];
+            char name[MAX_PATH + 1];
+            if (GetTempPathA(sizeof(directory), directory) == 0 || GetTempFileNameA(directory, "mvec", 0, name) == 0) {
+                throw std::runtime_error("Cannot create a temporary file");
+            }
+            file_path = name;
+            flags = FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE;
+        }
+        else {
+            MappedJournal::recover(path + ".journal");
+        }
+        file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                           nullptr, OPEN_ALWAYS, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file " + file_path);
+        }
+#else
+        if (is_temporary) {
+            std::string pattern = (std::filesystem::temp_directory_path() / "mapped_vector_XXXXXX").string();
+            fd = mkstemp(pattern.data());
+            if (fd >= 0) {
+                unlink(pattern.c_str());
+            }
+        }
+        else {
+            MappedJournal::recover(path + ".journal");
+            fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        }
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file " + path);
+        }
+#endif
+    }
+
+    size_t getFileSize() const {
+#ifdef _WIN32
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            throw std::runtime_error("Cannot read the size of a mapped file");
+        }
+        return static_cast<size_t>(file_size.QuadPart);
+#else
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            throw std::runtime_error("Cannot read the size of a mapped file");
+        }
+        return static_cast<size_t>(file_stat.st_size);
+#endif
+    }
+
+    // Maps the first `length` bytes of the file, extending it if needed.
+    void map(size_t length) {
+#ifdef _WIN32
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(length) >> 32),
+                                     static_cast<DWORD>(length & 0xFFFFFFFFU), nullptr);
+        DWORD access = is_journaled ? FILE_MAP_COPY : FILE_MAP_ALL_ACCESS;
+        void* address = mapping == nullptr ? nullptr : MapViewOfFile(mapping, access, 0, 0, length);
+        if (address == nullptr) {
+            throw std::runtime_error("Cannot map file");
+        }
+#else
+        if (getFileSize() < length && ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            throw std::runtime_error("Cannot extend mapped file");
+        }
+        void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, is_journaled ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("Cannot map file");
+        }
+#endif
+        base = static_cast<unsigned char*>(address);
+        mapped_length = length;
+        capacity = (length - DATA_OFFSET) / sizeof(T);
+        resizeDirtyPages();
+    }
+
+    void unmap() {
+#ifdef _WIN32
+        if (base != nullptr) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        mapping = nullptr;
+#else
+        if (base != nullptr) {
+            munmap(base, mapped_length);
+        }
+#endif
+        base = nullptr;
+        mapped_length = 0;
+        capacity = 0;
+    }
+
+    void closeFile() {
+        unmap();
+#ifdef _WIN32
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd = -1;
+#endif
+    }
+
+    void initialize(const std::string& file_path, bool is_temporary) {
+        path = file_path;
+        is_journaled = !is_temporary;
+        page_size = getPageSize();
+        openFile(path, is_temporary);
+        try {
+            size_t file_size = getFileSize();
+            if (file_size < DATA_OFFSET) {
+                // The header goes straight to the file, so a new file is a valid empty vector
+                // even if it is never flushed.
+                Header header = {};
+                std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+                header.element_size = sizeof(T);
+#ifdef _WIN32
+                MappedJournal::writeNative(file, 0U, &header, sizeof(header));
+#else
+                MappedJournal::writeNative(fd, 0U, &header, sizeof(header));
+#endif
+                if (is_journaled) {
+#ifdef _WIN32
+                    MappedJournal::syncNative(file);
+#else
+                    MappedJournal::syncNative(fd);
+#endif
+                    MappedJournal::syncDirectory(path);
+                }
+                map(DATA_OFFSET + MIN_CAPACITY_BYTES);
+                return;
+            }
+
+            map(file_size);
+            const Header& header = getHeader();
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.element_size != sizeof(T) ||
+                header.count_of_elements > capacity) {
+                throw std::runtime_error("Invalid mapped vector file " + path);
+            }
+        }
+        catch (...) {
+            closeFile();
+            throw;
+        }
+    }
+
+    void grow() {
+        size_t new_capacity = std::max(capacity * 2U, MIN_CAPACITY_BYTES / sizeof(T));
+        if (!is_journaled) {
+            unmap();
+            map(DATA_OFFSET + new_capacity * sizeof(T));
+            return;
+        }
+
+        // The changes since the last flush live only in the private view, so the dirty pages
+        // are carried over to the new one.
+        unsigned char* old_base = base;
+        size_t old_length = mapped_length;
+#ifdef _WIN32
+        HANDLE old_mapping = mapping;
+#endif
+        map(DATA_OFFSET + new_capacity * sizeof(T));
+        size_t new_length = mapped_length;
+        mapped_length = old_length;
+        forEachDirtyRun([&](size_t offset, size_t length) {
+            std::memcpy(base + offset, old_base + offset, length);
+        });
+        mapped_length = new_length;
+#ifdef _WIN32
+        UnmapViewOfFile(old_base);
+        CloseHandle(old_mapping);
+#else
+        munmap(old_base, old_length);
+#endif
+    }
+
+public:
+
+    MappedVector() {
+        initialize("", true);
+    }
+
+    explicit MappedVector(const std::string& path) {
+        initialize(path, false);
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    ~MappedVector() {
+        closeFile();
+    }
+
+    T& operator[](size_t index) {
+        markElementDirty(index);
+        return getElements()[index];
+    }
+
+    const T& operator[](size_t index) const {
+        return getElements()[index];
+    }
+
+    void push_back(const T& value) {
+        // `value` may live in this vector, which grow() remaps.
+        T copy = value;
+        if (size() == capacity) {
+            grow();
+        }
+        markElementDirty(size());
+        new (getElements() + size()) T(copy);
+        markHeaderDirty();
+        ++getHeader().count_of_elements;
+    }
+
+    void pop_back() {
+        markHeaderDirty();
+        --getHeader().count_of_elements;
+    }
+
+    T& back() {
+        markElementDirty(size() - 1U);
+        return getElements()[size() - 1U];
+    }
+
+    const T& back() const {
+        return getElements()[size() - 1U];
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(getHeader().count_of_elements);
+    }
+
+    bool empty() const {
+        return size() == 0U;
+    }
+
+    void clear() {
+        markHeaderDirty();
+        getHeader().count_of_elements = 0U;
+    }
+
+    // Header words the owner may use to store its own state (for example a root index).
+    uint64_t* getUserData() {
+        markHeaderDirty();
+        return getHeader().user_data;
+    }
+
+    // Writes the changes made since the last flush to the disk, together with those of `others`,
+    // as one atomic step: after a crash every file reopens as of the previous flush or of this one.
+    // The other vectors have to be opened by path in the same directory. Blocks until the disk
+    // has the data. A temporary vector is only written back.
+    template <typename... TOthers>
+    void flush(MappedVector<TOthers>&... others) {
+        if (!is_journaled) {
+#ifdef _WIN32
+            if (!FlushViewOfFile(base, mapped_length) || !FlushFileBuffers(file)) {
+                throw std::runtime_error("Cannot flush mapped file");
+            }
+#else
+            if (msync(base, mapped_length, MS_SYNC) != 0) {
+                throw std::runtime_error("Cannot flush mapped file");
+            }
+#endif
+            return;
+        }
+        auto directory = std::filesystem::path(path).parent_path();
+        if (((!others.is_journaled || std::filesystem::path(others.path).parent_path() != directory) || ...)) {
+            throw std::invalid_argument("Vectors flushed together must be files in the same directory");
+        }
+
+        MappedJournal journal(path + ".journal");
+        addToJournal(journal);
+        (others.addToJournal(journal), ...);
+        if (journal.empty()) {
+            return;
+        }
+        journal.commit();
+        writeDirtyPages();
+        (others.writeDirtyPages(), ...);
+        journal.clear();
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+#include "RedBlackTree.hpp"
+
+// Multimap mode of a tree: a key may be stored several times. Equal keys are kept
+// in insertion order, because a new element is placed after the equal ones and
+// neither rotations nor erase change the in-order sequence of the others.
+// find and operator[] refer to the first element with the key.
+template <typename TKey, typename TValue, typename TTree = RedBlackTree<TKey, TValue>>
+class MultiTree : public TTree {
+protected:
+
+    using Iterator = decltype(std::declval<TTree&>().begin());
+    using node_ptr = typename TTree::node_ptr;
+
+protected:
+
+    // The fictitious node after the last element with a key not greater than `key`.
+    node_ptr findInsertPosition(const TKey& key) const {
+        node_ptr current_ptr = this->root;
+        while (!this->isFictitious(current_ptr)) {
+            if (key < this->getKey(current_ptr)) {
+                current_ptr = this->getLeftSon(current_ptr);
+            }
+            else {
+                current_ptr = this->getRightSon(current_ptr);
+            }
+        }
+        return current_ptr;
+    }
+
+    node_ptr findFirstPosition(const TKey& key) const {
+        node_ptr current_ptr = this->root;
+        node_ptr result = TTree::NULL_PTR;
+        while (!this->isFictitious(current_ptr)) {
+            if (this->getKey(current_ptr) < key) {
+                current_ptr = this->getRightSon(current_ptr);
+            }
+            else {
+                if (this->getKey(current_ptr) == key) {
+                    result = current_ptr;
+                }
+                current_ptr = this->getLeftSon(current_ptr);
+            }
+        }
+        return result;
+    }
+
+public:
+
+    using TTree::erase;
+
+    // Always inserts; the element goes after the ones with an equal key.
+    Iterator insert(const TKey& key, const TValue& value) {
+        node_ptr ptr = findInsertPosition(key);
+        ++this->count_of_elements;
+        this->insertPosition(ptr, key, value);
+        return this->makeIterator(ptr);
+    }
+
+    // Erases every element with the key and returns their number.
+    size_t erase(const TKey& key) {
+        size_t count = 0;
+        for (auto it = find(key); it != TTree::end() && (*it).first == key; ++count) {
+            it = TTree::erase(it);
+        }
+        if (count == 0U) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        return count;
+    }
+
+    Iterator find(const TKey& key) const {
+        return this->makeIterator(findFirstPosition(key));
+    }
+
+    size_t count(const TKey& key) const {
+        size_t count = 0;
+        for (auto it = find(key); it != TTree::end() && (*it).first == key; ++it) {
+            ++count;
+        }
+        return count;
+    }
+
+    // The elements with the key, in insertion order.
+    std::pair<Iterator, Iterator> equalRange(const TKey& key) {
+        return { TTree::lowerBound(key), TTree::upperBound(key) };
+    }
+
+    TValue& operator[](const TKey& key) {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        auto it = find(key);
+        if (it == TTree::end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+};
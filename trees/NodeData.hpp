@@ -0,0 +1,21 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+#define TREES_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define TREES_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// Key and value of a node whose value type is empty; unlike std::pair the value takes no space.
+template <typename TKey, typename TValue>
+struct KeyOnlyData {
+    TKey first;
+    TREES_NO_UNIQUE_ADDRESS TValue second;
+};
+
+// What a tree node stores: std::pair, or just the key when the value type is empty (as in sets).
+template <typename TKey, typename TValue>
+using NodeData = std::conditional_t<std::is_empty_v<TValue>, KeyOnlyData<TKey, TValue>, std::pair<TKey, TValue>>;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Owns the key and value of an element extracted from a tree, until it is inserted
+// into a tree again. Only moves its contents; an empty handle holds nothing.
+template <typename TKey, typename TValue>
+class NodeHandle {
+protected:
+
+    std::optional<std::pair<TKey, TValue>> data;
+
+public:
+
+    NodeHandle() = default;
+
+    NodeHandle(TKey key, TValue value) :
+        data(std::in_place, std::move(key), std::move(value))
+    {}
+
+    // Like the node handles of std::map, a moved-from handle is empty.
+    NodeHandle(NodeHandle&& other) noexcept(std::is_nothrow_move_constructible_v<std::pair<TKey, TValue>>) :
+        data(std::move(other.data))
+    {
+        other.data.reset();
+    }
+
+    NodeHandle& operator=(NodeHandle&& other) noexcept(std::is_nothrow_move_assignable_v<std::pair<TKey, TValue>> &&
+                                                       std::is_nothrow_move_constructible_v<std::pair<TKey, TValue>>) {
+        if (this != &other) {
+            data = std::move(other.data);
+            other.data.reset();
+        }
+        return *this;
+    }
+
+    bool empty() const {
+        return !data.has_value();
+    }
+
+    explicit operator bool() const {
+        return data.has_value();
+    }
+
+    const TKey& getKey() const {
+        if (empty()) {
+            throw std::out_of_range("The node handle is empty");
+        }
+        return data->first;
+    }
+
+    TValue& getValue() {
+        if (empty()) {
+            throw std::out_of_range("The node handle is empty");
+        }
+        return data->second;
+    }
+
+    // Moves the element out, leaving the handle empty.
+    std::pair<TKey, TValue> release() {
+        std::pair<TKey, TValue> result = std::move(data.value());
+        data.reset();
+        return result;
+    }
+};
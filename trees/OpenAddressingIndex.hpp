@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Open-addressing hash table from keys to node positions with linear probing.
+// Erase shifts the following entries back instead of leaving tombstones,
+// so probe sequences stay short under a mix of inserts and erases.
+template <typename TKey, typename THash = std::hash<TKey>>
+class OpenAddressingIndex {
+public:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+protected:
+
+    const static size_t MIN_CAPACITY = 16;
+
+    struct Slot {
+        TKey key;
+        node_ptr ptr = NULL_PTR;
+    };
+
+    std::vector<Slot> slots;
+    size_t count_of_entries = 0;
+    size_t mask = 0;
+
+protected:
+
+    // std::hash of integers is often the identity, so the bits are mixed again.
+    static uint64_t getHash(const TKey& key) {
+        uint64_t hash = static_cast<uint64_t>(THash()(key));
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    size_t getHome(const TKey& key) const {
+        return static_cast<size_t>(getHash(key)) & mask;
+    }
+
+    // Index of the slot holding the key, or of the empty slot that ends its probe sequence.
+    size_t getSlot(const TKey& key) const {
+        size_t index = getHome(key);
+        while (slots[index].ptr != NULL_PTR && !(slots[index].key == key)) {
+            index = (index + 1U) & mask;
+        }
+        return index;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old_slots(capacity);
+        old_slots.swap(slots);
+        mask = capacity - 1U;
+        for (const Slot& slot : old_slots) {
+            if (slot.ptr != NULL_PTR) {
+                slots[getSlot(slot.key)] = slot;
+            }
+        }
+    }
+
+public:
+
+    OpenAddressingIndex() {
+        rehash(MIN_CAPACITY);
+    }
+
+    // Position of the key, or NULL_PTR if it is absent.
+    node_ptr find(const TKey& key) const {
+        return slots[getSlot(key)].ptr;
+    }
+
+    // Inserts the key or updates its position.
+    void assign(const TKey& key, node_ptr ptr) {
+        size_t index = getSlot(key);
+        if (slots[index].ptr == NULL_PTR) {
+            // The load factor is kept at most 1/2.
+            if ((count_of_entries + 1U) * 2U > slots.size()) {
+                rehash(slots.size() * 2U);
+                index = getSlot(key);
+            }
+            ++count_of_entries;
+            slots[index].key = key;
+        }
+        slots[index].ptr = ptr;
+    }
+
+    void erase(const TKey& key) {
+        size_t hole = getSlot(key);
+        if (slots[hole].ptr == NULL_PTR) {
+            return;
+        }
+        --count_of_entries;
+
+        // Moves back every following entry whose home is not between the hole and the entry.
+        size_t index = hole;
+        while (true) {
+            index = (index + 1U) & mask;
+            if (slots[index].ptr == NULL_PTR) {
+                break;
+            }
+            size_t home = getHome(slots[index].key);
+            if (((index - home) & mask) >= ((index - hole) & mask)) {
+                slots[hole] = slots[index];
+                hole = index;
+            }
+        }
+        slots[hole].ptr = NULL_PTR;
+    }
+
+    size_t size() const {
+        return count_of_entries;
+    }
+
+    void clear() {
+        slots.assign(MIN_CAPACITY, Slot());
+        mask = MIN_CAPACITY - 1U;
+        count_of_entries = 0;
+    }
+};
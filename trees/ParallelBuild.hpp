@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Helpers for building trees on several threads.
+
+// The requested number of threads, or one per core for 0.
+inline size_t getCountOfThreads(size_t count_of_threads) {
+    if (count_of_threads == 0U) {
+        count_of_threads = std::thread::hardware_concurrency();
+    }
+    return std::max<size_t>(count_of_threads, 1U);
+}
+
+// Calls `function(i)` for i in [0, count) on `count` threads, one of them the calling one.
+template <typename TFunction>
+void runInThreads(size_t count, TFunction function) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t i = 1; i < count; ++i) {
+        threads.emplace_back(function, i);
+    }
+    function(0U);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Sorts the elements by key and keeps the first of each group of equal keys, on `count_of_threads` threads.
+// Each thread sorts its part, the parts are merged pairwise (also in parallel) and then each thread
+// removes the duplicates of its part before the parts are moved together.
+template <typename TKey, typename TValue>
+void sortAndDeduplicate(std::vector<std::pair<TKey, TValue>>& elements, size_t count_of_threads) {
+    auto isLess = [](const std::pair<TKey, TValue>& lhs, const std::pair<TKey, TValue>& rhs) {
+        return lhs.first < rhs.first;
+    };
+    size_t count_of_parts = std::min(count_of_threads, std::max<size_t>(elements.size(), 1U));
+    auto getBound = [&](size_t part) {
+        return elements.begin() + elements.size() * part / count_of_parts;
+    };
+
+    runInThreads(count_of_parts, [&](size_t part) {
+        std::stable_sort(getBound(part), getBound(part + 1U), isLess);
+    });
+    for (size_t width = 1; width < count_of_parts; width *= 2U) {
+        size_t count_of_merges = (count_of_parts + 2U * width - 1U) / (2U * width);
+        runInThreads(count_of_merges, [&](size_t merge) {
+            size_t first = merge * 2U * width;
+            size_t middle = std::min(first + width, count_of_parts);
+            size_t last = std::min(first + 2U * width, count_of_parts);
+            std::inplace_merge(getBound(first), getBound(middle), getBound(last), isLess);
+        });
+    }
+
+    // Whether the first element of a part repeats the last one of the previous part; found before
+    // the parts change.
+    std::vector<bool> is_repeated(count_of_parts, false);
+    for (size_t part = 1; part < count_of_parts; ++part) {
+        auto bound = getBound(part);
+        is_repeated[part] = bound != elements.end() && bound != elements.begin() && !isLess(*(bound - 1), *bound);
+    }
+    std::vector<size_t> part_sizes(count_of_parts);
+    runInThreads(count_of_parts, [&](size_t part) {
+        auto first = getBound(part);
+        auto last = getBound(part + 1U);
+        auto kept_last = std::unique(first, last, [&](const auto& lhs, const auto& rhs) {
+            return !isLess(lhs, rhs);
+        });
+        // A key that continues the previous part is already kept there.
+        if (is_repeated[part] && first != kept_last) {
+            kept_last = std::move(first + 1, kept_last, first);
+        }
+        part_sizes[part] = kept_last - first;
+    });
+
+    size_t count = 0;
+    for (size_t part = 0; part < count_of_parts; ++part) {
+        auto first = getBound(part);
+        if (elements.begin() + count != first) {
+            std::move(first, first + part_sizes[part], elements.begin() + count);
+        }
+        count += part_sizes[part];
+    }
+    elements.erase(elements.begin() + count, elements.end());
+}
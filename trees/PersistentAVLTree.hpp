@@ -0,0 +1,447 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ChunkedVector.hpp"
+
+// AVL tree with persistent versions: an update copies only the nodes on the
+// root-to-leaf path and shares the rest with the previous version.
+// Copying a tree (or calling snapshot()) is O(1) and every copy can be read and
+// updated independently. Nodes are reference counted and go back to the shared
+// free list once no version reaches them.
+// A single version must not be used by several threads at once, but different
+// versions of the same tree may be read and updated concurrently.
+template <typename TKey, typename TValue>
+class PersistentAVLTree {
+protected:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+    struct Node {
+
+        node_ptr left_node, right_node;
+
+        std::pair<TKey, TValue> data;
+
+        size_t height;
+
+        // Number of parents and versions referring to the node.
+        uint32_t ref_count;
+    };
+
+    // Shared by all versions of a tree. Nodes never move, so a reader never needs the mutex.
+    struct Pool {
+        ChunkedVector<Node> tree;
+        std::vector<node_ptr> free_poses;
+        std::mutex mutex;
+    };
+
+public:
+
+    class Iterator {
+    protected:
+
+        // Nodes whose left subtree the iterator is in; the current one is on top.
+        std::vector<node_ptr> path;
+
+        const PersistentAVLTree<TKey, TValue>* container_ptr;
+
+        explicit Iterator(const PersistentAVLTree<TKey, TValue>* container_ptr) :
+            container_ptr(container_ptr)
+        {}
+
+    public:
+
+        const std::pair<const TKey&, const TValue&> operator*() const {
+            if (path.empty()) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            const Node& node = container_ptr->getNode(path.back());
+            return { node.data.first, node.data.second };
+        }
+
+        const std::pair<TKey, TValue>* operator->() const {
+            return &container_ptr->getNode(path.back()).data;
+        }
+
+        Iterator& operator++() {
+            node_ptr x = container_ptr->getRightSon(path.back());
+            path.pop_back();
+            container_ptr->pushLeftPath(path, x);
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            if (path.empty() || other.path.empty()) {
+                return path.empty() == other.path.empty();
+            }
+            return path.back() == other.path.back();
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        friend class PersistentAVLTree;
+    };
+
+protected:
+
+    std::shared_ptr<Pool> pool;
+
+    node_ptr root = NULL_PTR;
+    size_t count_of_elements = 0;
+
+protected:
+
+    Node& getNode(node_ptr x) const {
+        return pool->tree[x];
+    }
+
+    node_ptr getLeftSon(node_ptr x) const {
+        return getNode(x).left_node;
+    }
+
+    node_ptr getRightSon(node_ptr x) const {
+        return getNode(x).right_node;
+    }
+
+    const TKey& getKey(node_ptr x) const {
+        return getNode(x).data.first;
+    }
+
+    size_t getHeight(node_ptr x) const {
+        return x == NULL_PTR ? 0U : getNode(x).height;
+    }
+
+    void retain(node_ptr x) const {
+        if (x != NULL_PTR) {
+            std::atomic_ref<uint32_t>(getNode(x).ref_count).fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+
+    // Drops one reference and frees every node that is no longer reachable.
+    void release(node_ptr x) const {
+        std::vector<node_ptr> garbage;
+        if (x != NULL_PTR &&
+            std::atomic_ref<uint32_t>(getNode(x).ref_count).fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+            garbage.push_back(x);
+        }
+        if (garbage.empty()) {
+            return;
+        }
+
+        // Children of freed nodes lose a reference too.
+        for (size_t i = 0; i < garbage.size(); ++i) {
+            for (node_ptr son : { getLeftSon(garbage[i]), getRightSon(garbage[i]) }) {
+                if (son != NULL_PTR &&
+                    std::atomic_ref<uint32_t>(getNode(son).ref_count).fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+                    garbage.push_back(son);
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->free_poses.insert(pool->free_poses.end(), garbage.begin(), garbage.end());
+    }
+
+    // Creates a node referring to `left` and `right`; the caller owns the returned reference.
+    node_ptr makeNode(const std::pair<TKey, TValue>& data, node_ptr left, node_ptr right) {
+        node_ptr ptr;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            if (pool->free_poses.empty()) {
+                pool->free_poses.push_back(static_cast<node_ptr>(pool->tree.size()));
+                pool->tree.push_back(Node());
+            }
+            ptr = pool->free_poses.back();
+            pool->free_poses.pop_back();
+        }
+
+        Node& node = getNode(ptr);
+        node.left_node = left;
+        node.right_node = right;
+        node.data = data;
+        node.height = std::max(getHeight(left), getHeight(right)) + 1U;
+        node.ref_count = 1U;
+
+        retain(left);
+        retain(right);
+
+        return ptr;
+    }
+
+    // Builds a balanced node from `data` and the subtrees `left` and `right`,
+    // whose heights differ by at most two. The subtrees stay owned by the caller.
+    node_ptr balance(const std::pair<TKey, TValue>& data, node_ptr left, node_ptr right) {
+        if (getHeight(left) > getHeight(right) + 1U) {
+            node_ptr left_left = getLeftSon(left);
+            node_ptr left_right = getRightSon(left);
+            if (getHeight(left_left) >= getHeight(left_right)) {
+                node_ptr new_right = makeNode(data, left_right, right);
+                node_ptr result = makeNode(getNode(left).data, left_left, new_right);
+                release(new_right);
+                return result;
+            }
+            node_ptr new_left = makeNode(getNode(left).data, left_left, getLeftSon(left_right));
+            node_ptr new_right = makeNode(data, getRightSon(left_right), right);
+            node_ptr result = makeNode(getNode(left_right).data, new_left, new_right);
+            release(new_left);
+            release(new_right);
+            return result;
+        }
+        if (getHeight(right) > getHeight(left) + 1U) {
+            node_ptr right_left = getLeftSon(right);
+            node_ptr right_right = getRightSon(right);
+            if (getHeight(right_right) >= getHeight(right_left)) {
+                node_ptr new_left = makeNode(data, left, right_left);
+                node_ptr result = makeNode(getNode(right).data, new_left, right_right);
+                release(new_left);
+                return result;
+            }
+            node_ptr new_left = makeNode(data, left, getLeftSon(right_left));
+            node_ptr new_right = makeNode(getNode(right).data, getRightSon(right_left), right_right);
+            node_ptr result = makeNode(getNode(right_left).data, new_left, new_right);
+            release(new_left);
+            release(new_right);
+            return result;
+        }
+        return makeNode(data, left, right);
+    }
+
+    // The recursive updates return an owned reference to the new subtree root.
+    // `key` is known to be absent (insert) or present (erase, assign).
+    node_ptr insert(node_ptr x, const TKey& key, const TValue& value) {
+        if (x == NULL_PTR) {
+            return makeNode({ key, value }, NULL_PTR, NULL_PTR);
+        }
+
+        node_ptr result;
+        if (key < getKey(x)) {
+            node_ptr new_left = insert(getLeftSon(x), key, value);
+            result = balance(getNode(x).data, new_left, getRightSon(x));
+            release(new_left);
+        }
+        else {
+            node_ptr new_right = insert(getRightSon(x), key, value);
+            result = balance(getNode(x).data, getLeftSon(x), new_right);
+            release(new_right);
+        }
+        return result;
+    }
+
+    node_ptr eraseLowest(node_ptr x, std::pair<TKey, TValue>& lowest) {
+        if (getLeftSon(x) == NULL_PTR) {
+            lowest = getNode(x).data;
+            retain(getRightSon(x));
+            return getRightSon(x);
+        }
+        node_ptr new_left = eraseLowest(getLeftSon(x), lowest);
+        node_ptr result = balance(getNode(x).data, new_left, getRightSon(x));
+        release(new_left);
+        return result;
+    }
+
+    node_ptr erase(node_ptr x, const TKey& key) {
+        node_ptr result;
+        if (key < getKey(x)) {
+            node_ptr new_left = erase(getLeftSon(x), key);
+            result = balance(getNode(x).data, new_left, getRightSon(x));
+            release(new_left);
+        }
+        else if (getKey(x) < key) {
+            node_ptr new_right = erase(getRightSon(x), key);
+            result = balance(getNode(x).data, getLeftSon(x), new_right);
+            release(new_right);
+        }
+        else if (getLeftSon(x) == NULL_PTR || getRightSon(x) == NULL_PTR) {
+            result = getLeftSon(x) == NULL_PTR ? getRightSon(x) : getLeftSon(x);
+            retain(result);
+        }
+        else {
+            std::pair<TKey, TValue> lowest;
+            node_ptr new_right = eraseLowest(getRightSon(x), lowest);
+            result = balance(lowest, getLeftSon(x), new_right);
+            release(new_right);
+        }
+        return result;
+    }
+
+    node_ptr assign(node_ptr x, const TKey& key, const TValue& value) {
+        if (key < getKey(x)) {
+            node_ptr new_left = assign(getLeftSon(x), key, value);
+            node_ptr result = makeNode(getNode(x).data, new_left, getRightSon(x));
+            release(new_left);
+            return result;
+        }
+        if (getKey(x) < key) {
+            node_ptr new_right = assign(getRightSon(x), key, value);
+            node_ptr result = makeNode(getNode(x).data, getLeftSon(x), new_right);
+            release(new_right);
+            return result;
+        }
+        return makeNode({ key, value }, getLeftSon(x), getRightSon(x));
+    }
+
+    void replaceRoot(node_ptr new_root) {
+        release(root);
+        root = new_root;
+    }
+
+protected:
+
+    node_ptr findPosition(const TKey& key) const {
+        node_ptr x = root;
+        while (x != NULL_PTR && getKey(x) != key) {
+            x = key < getKey(x) ? getLeftSon(x) : getRightSon(x);
+        }
+        return x;
+    }
+
+    void pushLeftPath(std::vector<node_ptr>& path, node_ptr x) const {
+        while (x != NULL_PTR) {
+            path.push_back(x);
+            x = getLeftSon(x);
+        }
+    }
+
+    Iterator findBound(const TKey& key, bool inclusive) const {
+        Iterator it(this);
+        node_ptr x = root;
+        while (x != NULL_PTR) {
+            if (key < getKey(x) || (inclusive && getKey(x) == key)) {
+                it.path.push_back(x);
+                x = getLeftSon(x);
+            }
+            else {
+                x = getRightSon(x);
+            }
+        }
+        return it;
+    }
+
+public:
+
+    PersistentAVLTree() :
+        pool(std::make_shared<Pool>())
+    {}
+
+    PersistentAVLTree(const PersistentAVLTree& other) :
+        pool(other.pool),
+        root(other.root),
+        count_of_elements(other.count_of_elements)
+    {
+        retain(root);
+    }
+
+    PersistentAVLTree(PersistentAVLTree&& other) noexcept :
+        pool(other.pool),
+        root(other.root),
+        count_of_elements(other.count_of_elements)
+    {
+        other.root = NULL_PTR;
+        other.count_of_elements = 0U;
+    }
+
+    PersistentAVLTree& operator=(PersistentAVLTree other) noexcept {
+        std::swap(pool, other.pool);
+        std::swap(root, other.root);
+        std::swap(count_of_elements, other.count_of_elements);
+        return *this;
+    }
+
+    ~PersistentAVLTree() {
+        if (pool != nullptr) {
+            release(root);
+        }
+    }
+
+    // An independent version sharing all nodes with this one.
+    PersistentAVLTree snapshot() const {
+        return *this;
+    }
+
+    Iterator begin() const {
+        Iterator it(this);
+        pushLeftPath(it.path, root);
+        return it;
+    }
+
+    Iterator end() const {
+        return Iterator(this);
+    }
+
+    Iterator lowerBound(const TKey& key) const {
+        return findBound(key, true);
+    }
+
+    Iterator upperBound(const TKey& key) const {
+        return findBound(key, false);
+    }
+
+    Iterator insert(const TKey& key, const TValue& value) {
+        if (findPosition(key) == NULL_PTR) {
+            ++count_of_elements;
+            replaceRoot(insert(root, key, value));
+        }
+        return lowerBound(key);
+    }
+
+    // Inserts the element or replaces the value of an existing one.
+    void assign(const TKey& key, const TValue& value) {
+        if (findPosition(key) == NULL_PTR) {
+            insert(key, value);
+            return;
+        }
+        replaceRoot(assign(root, key, value));
+    }
+
+    Iterator erase(const TKey& key) {
+        if (findPosition(key) == NULL_PTR) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        --count_of_elements;
+        replaceRoot(erase(root, key));
+        return upperBound(key);
+    }
+
+    Iterator find(const TKey& key) const {
+        Iterator it = lowerBound(key);
+        if (it == end() || it->first != key) {
+            return end();
+        }
+        return it;
+    }
+
+    bool isExist(const TKey& key) const {
+        return findPosition(key) != NULL_PTR;
+    }
+
+    const TValue& operator[](const TKey& key) const {
+        node_ptr ptr = findPosition(key);
+        if (ptr == NULL_PTR) {
+            throw std::runtime_error("No such key in table");
+        }
+        return getNode(ptr).data.second;
+    }
+
+    size_t size() const {
+        return count_of_elements;
+    }
+
+    bool empty() const {
+        return count_of_elements == 0U;
+    }
+
+    void clear() {
+        replaceRoot(NULL_PTR);
+        count_of_elements = 0U;
+    }
+};
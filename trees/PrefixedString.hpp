@@ -0,0 +1,80 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// String key that keeps its first 8 bytes packed big-endian into an integer next to the string.
+// Most comparisons in a descent are decided by the prefixes, without touching the heap buffer
+// of a long string; only keys with equal prefixes compare their remaining bytes.
+class PrefixedString {
+protected:
+
+    const static size_t PREFIX_SIZE = sizeof(uint64_t);
+
+    // Shorter strings are padded with zero bytes, so integer order matches byte order.
+    uint64_t prefix = 0;
+    std::string value;
+
+protected:
+
+    static uint64_t makePrefix(const std::string& value) {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < PREFIX_SIZE; ++i) {
+            prefix <<= 8U;
+            if (i < value.size()) {
+                prefix |= static_cast<unsigned char>(value[i]);
+            }
+        }
+        return prefix;
+    }
+
+public:
+
+    PrefixedString() = default;
+
+    PrefixedString(std::string value) :
+        prefix(makePrefix(value)),
+        value(std::move(value))
+    {}
+
+    PrefixedString(const char* value) :
+        PrefixedString(std::string(value))
+    {}
+
+    const std::string& getString() const {
+        return value;
+    }
+
+    uint64_t getPrefix() const {
+        return prefix;
+    }
+
+    friend bool operator==(const PrefixedString& lhs, const PrefixedString& rhs) {
+        return lhs.prefix == rhs.prefix && lhs.value == rhs.value;
+    }
+
+    friend std::strong_ordering operator<=>(const PrefixedString& lhs, const PrefixedString& rhs) {
+        if (lhs.prefix != rhs.prefix) {
+            return lhs.prefix <=> rhs.prefix;
+        }
+        std::string_view lhs_rest = lhs.value;
+        std::string_view rhs_rest = rhs.value;
+        // Equal prefixes of two long strings mean equal first bytes, which need no second look.
+        if (lhs_rest.size() >= PREFIX_SIZE && rhs_rest.size() >= PREFIX_SIZE) {
+            lhs_rest.remove_prefix(PREFIX_SIZE);
+            rhs_rest.remove_prefix(PREFIX_SIZE);
+        }
+        return lhs_rest.compare(rhs_rest) <=> 0;
+    }
+};
+
+template <>
+struct std::hash<PrefixedString> {
+    size_t operator()(const PrefixedString& key) const {
+        return std::hash<std::string>()(key.getString());
+    }
+};
@@ -1,14 +1,49 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <utility>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
-template <typename TKey, typename TValue>
+#include "BatchOperation.hpp"
+#include "EytzingerIndex.hpp"
+#include "FrozenTree.hpp"
+#include "NodeData.hpp"
+#include "NodeHandle.hpp"
+#include "ParallelBuild.hpp"
+#include "RelaxedAtomic.hpp"
+
+// Augmentation policy of a tree that keeps nothing besides the elements.
+// A policy recomputes the summary stored in a node's data from the node itself and its sons,
+// `update(data, left, right)`, where a missing (fictitious) son is passed as nullptr,
+// and returns whether the summary changed.
+struct NoAugmentation {
+    template <typename TData>
+    static bool update(TData&, const TData*, const TData*) {
+        return false;
+    }
+};
+
+template <typename TKey, typename TValue, template <typename...> class TContainer = std::vector,
+          typename TAugmentation = NoAugmentation>
 class RedBlackTree {
 protected:
 
     using node_ptr = int;
-    const static node_ptr NULL_PTR = -1;
+    constexpr static node_ptr NULL_PTR = -1;
+
+    // applyBatch rebuilds the tree when the batch has at least 1/REBUILD_BATCH_RATIO of its size.
+    constexpr static size_t REBUILD_BATCH_RATIO = 32;
+
+    // eraseIf and eraseRange rebuild the tree when at least 1/REBUILD_ERASE_RATIO of it is erased.
+    constexpr static size_t REBUILD_ERASE_RATIO = 16;
+
+    constexpr static bool IS_AUGMENTED = !std::is_same_v<TAugmentation, NoAugmentation>;
 
     enum Color {
         Red,
@@ -22,11 +57,16 @@ protected:
 
         Color color;
 
-        std::pair<TKey, TValue> data;
+        NodeData<TKey, TValue> data;
 
         bool is_fictitious;
     };
 
+    // A container such as ChunkedVector lets readers walk the tree while it is written, see
+    // ConcurrentRedBlackTree. The links, flags, keys and values those readers load are then
+    // stored with relaxed atomics.
+    constexpr static bool IS_READ_CONCURRENTLY = requires { requires TContainer<Node>::IS_READ_CONCURRENTLY; };
+
 public:
 
     class Iterator {
@@ -34,9 +74,9 @@ public:
 
         node_ptr ptr = 0;
 
-        RedBlackTree<TKey, TValue>* container_ptr;
+        RedBlackTree<TKey, TValue, TContainer, TAugmentation>* container_ptr;
 
-        Iterator(node_ptr ptr, RedBlackTree<TKey, TValue>* container_ptr) :
+        Iterator(node_ptr ptr, RedBlackTree<TKey, TValue, TContainer, TAugmentation>* container_ptr) :
             ptr(ptr),
             container_ptr(container_ptr)
         {}
@@ -57,7 +97,7 @@ public:
             return { container_ptr->tree[ptr].data.first, container_ptr->tree[ptr].data.second };
         }
 
-        std::pair<TKey, TValue>* operator->() const {
+        NodeData<TKey, TValue>* operator->() const {
             return &container_ptr->tree[ptr].data;
         }
 
@@ -93,32 +133,53 @@ public:
 
 protected:
 
-    std::vector<Node> tree;
+    TContainer<Node> tree;
     size_t count_of_elements = 0;
 
     node_ptr root;
 
-    std::vector<node_ptr> free_poses;
+    // Nodes with the smallest and the largest key, NULL_PTR in an empty tree.
+    // Rotations relink nodes without moving their data, so only insert and erase update them.
+    node_ptr leftmost = NULL_PTR;
+    node_ptr rightmost = NULL_PTR;
+
+    TContainer<node_ptr> free_poses;
 
 protected:
     Iterator makeIterator(node_ptr position) const {
-        return Iterator(position, const_cast<RedBlackTree<TKey, TValue>*>(this));
+        return Iterator(position, const_cast<RedBlackTree<TKey, TValue, TContainer, TAugmentation>*>(this));
+    }
+
+    template <typename T, typename U>
+    static void storeField(T& field, U&& value) {
+        if constexpr (IS_READ_CONCURRENTLY && !std::is_empty_v<T>) {
+            storeRelaxed(field, static_cast<const T&>(value));
+        }
+        else {
+            field = std::forward<U>(value);
+        }
     }
 
     node_ptr createNode(node_ptr parent) {
         if (free_poses.empty()) {
             free_poses.push_back(static_cast<node_ptr>(tree.size()));
-            tree.push_back(Node());
+            if constexpr (IS_READ_CONCURRENTLY) {
+                // A reader may still be looking at an earlier node in this slot.
+                tree.extend();
+            }
+            else {
+                tree.push_back(Node());
+            }
         }
         node_ptr ptr = free_poses.back();
         free_poses.pop_back();
 
-        tree[ptr].parent = parent;
-        tree[ptr].left_node = NULL_PTR;
-        tree[ptr].right_node = NULL_PTR;
+        storeField(tree[ptr].parent, parent);
+        storeField(tree[ptr].left_node, NULL_PTR);
+        storeField(tree[ptr].right_node, NULL_PTR);
 
         tree[ptr].color = Color::Black;
-        tree[ptr].is_fictitious = true;
+        storeField(tree[ptr].is_fictitious, true);
 
         return ptr;
     }
@@ -133,17 +194,20 @@ protected:
 
         node_ptr subtree_root = getParent(x);
 
-        tree[x].right_node = tree[y].left_node;
+        storeField(tree[x].right_node, tree[y].left_node);
         if (getRightSon(x) != NULL_PTR) {
-            tree[getRightSon(x)].parent = x;
+            storeField(tree[getRightSon(x)].parent, x);
         }
 
-        tree[x].parent = y;
+        storeField(tree[x].parent, y);
 
-        tree[y].parent = subtree_root;
-        tree[y].left_node = x;
+        storeField(tree[y].parent, subtree_root);
+        storeField(tree[y].left_node, x);
 
         changeParent(subtree_root, x, y);
+
+        updateAugmentation(x);
+        updateAugmentation(y);
     }
 
     void smallRightRotation(node_ptr x) {
@@ -151,17 +215,20 @@ protected:
 
         node_ptr subtree_root = getParent(x);
 
-        tree[x].left_node = tree[y].right_node;
+        storeField(tree[x].left_node, tree[y].right_node);
         if (getLeftSon(x) != NULL_PTR) {
-            tree[getLeftSon(x)].parent = x;
+            storeField(tree[getLeftSon(x)].parent, x);
         }
 
-        tree[x].parent = y;
+        storeField(tree[x].parent, y);
 
-        tree[y].parent = subtree_root;
-        tree[y].right_node = x;
+        storeField(tree[y].parent, subtree_root);
+        storeField(tree[y].right_node, x);
 
         changeParent(subtree_root, x, y);
+
+        updateAugmentation(x);
+        updateAugmentation(y);
     }
 
 protected:
@@ -212,17 +279,51 @@ protected:
 
     void changeParent(node_ptr parent, node_ptr old_son, node_ptr new_son) {
         if (parent == NULL_PTR) {
-            root = new_son;
+            storeField(root, new_son);
         }
         else {
             if (getLeftSon(parent) == old_son) {
-                tree[parent].left_node = new_son;
+                storeField(tree[parent].left_node, new_son);
             }
             else {
-                tree[parent].right_node = new_son;
+                storeField(tree[parent].right_node, new_son);
+            }
+        }
+        storeField(tree[new_son].parent, parent);
+    }
+
+protected:
+    bool updateAugmentation(node_ptr x) {
+        if constexpr (IS_AUGMENTED) {
+            if (isFictitious(x)) {
+                return false;
             }
+            node_ptr left_son = getLeftSon(x);
+            node_ptr right_son = getRightSon(x);
+            return TAugmentation::update(tree[x].data,
+                                         isFictitious(left_son) ? nullptr : &tree[left_son].data,
+                                         isFictitious(right_son) ? nullptr : &tree[right_son].data);
+        }
+        return false;
+    }
+
+    // Recomputes the augmentation from `x` up to the root. Insert and erase call it before their
+    // fixups, which then keep it correct rotation by rotation.
+    void updateAugmentationPath(node_ptr x) {
+        if constexpr (IS_AUGMENTED) {
+            for (; x != NULL_PTR; x = getParent(x)) {
+                updateAugmentation(x);
+            }
+        }
+    }
+
+    // A new leaf changes nothing but its ancestors, so the walk stops at the first one whose
+    // augmentation stays the same.
+    void updateAugmentationAfterInsert(node_ptr x) {
+        if constexpr (IS_AUGMENTED) {
+            updateAugmentation(x);
+            for (x = getParent(x); x != NULL_PTR && updateAugmentation(x); x = getParent(x)) {}
         }
-        tree[new_son].parent = parent;
     }
 
 protected:
@@ -244,6 +345,14 @@ protected:
         return lowest_pos;
     }
 
+    node_ptr getHighestPos(node_ptr x) const {
+        node_ptr highest_pos = x;
+        while (!isFictitious(getRightSon(highest_pos))) {
+            highest_pos = getRightSon(highest_pos);
+        }
+        return highest_pos;
+    }
+
     node_ptr findPosition(const TKey& key) const {
         node_ptr current_ptr = root;
         while (!isFictitious(current_ptr) && getKey(current_ptr) != key) {
@@ -257,16 +366,58 @@ protected:
         return current_ptr;
     }
 
+    // Takes the key and value by value, so that a moved-in element is not copied.
+    void insertPosition(node_ptr ptr, TKey key, TValue value) {
+        storeField(tree[ptr].data.first, std::move(key));
+        storeField(tree[ptr].data.second, std::move(value));
+
+        tree[ptr].color = Color::Red;
+        storeField(tree[ptr].is_fictitious, false);
+
+        storeField(tree[ptr].left_node, createNode(ptr));
+        storeField(tree[ptr].right_node, createNode(ptr));
+
+        if (leftmost == NULL_PTR || getKey(ptr) < getKey(leftmost)) {
+            leftmost = ptr;
+        }
+        if (rightmost == NULL_PTR || !(getKey(ptr) < getKey(rightmost))) {
+            rightmost = ptr;
+        }
+
+        updateAugmentationAfterInsert(ptr);
+        fixTreeAfterInsert(ptr);
+    }
+
     void erasePosition(node_ptr x) {
+        // The extreme nodes have at most one child, so they are unlinked without moving data,
+        // and their neighbour is that child or the parent.
+        if (x == leftmost) {
+            leftmost = isFictitious(getRightSon(x)) ? getParent(x) : getLowestPos(getRightSon(x));
+        }
+        if (x == rightmost) {
+            rightmost = isFictitious(getLeftSon(x)) ? getParent(x) : getHighestPos(getLeftSon(x));
+        }
+
         if (!isFictitious(getLeftSon(x)) && !isFictitious(getRightSon(x))) {
             node_ptr min_right = getLowestPos(getRightSon(x));
-            std::swap(tree[x].data, tree[min_right].data);
+            if constexpr (IS_READ_CONCURRENTLY) {
+                auto data = tree[x].data;
+                storeField(tree[x].data.first, tree[min_right].data.first);
+                storeField(tree[x].data.second, tree[min_right].data.second);
+                storeField(tree[min_right].data.first, data.first);
+                storeField(tree[min_right].data.second, data.second);
+            }
+            else {
+                std::swap(tree[x].data, tree[min_right].data);
+            }
             erasePosition(min_right);
         }
         else if (isFictitious(getLeftSon(x)) && !isFictitious(getRightSon(x))) {
             changeParent(getParent(x), x, getRightSon(x));
             setColor(getRightSon(x), Color::Black);
 
+            updateAugmentationPath(getParent(x));
+
             deleteNode(getLeftSon(x));
             deleteNode(x);
         }
@@ -274,6 +425,8 @@ protected:
             changeParent(getParent(x), x, getLeftSon(x));
             setColor(getLeftSon(x), Color::Black);
 
+            updateAugmentationPath(getParent(x));
+
             deleteNode(getRightSon(x));
             deleteNode(x);
         }
@@ -281,6 +434,8 @@ protected:
             if (getColor(x) == Color::Red) {
                 changeParent(getParent(x), x, getLeftSon(x));
 
+                updateAugmentationPath(getParent(x));
+
                 deleteNode(getRightSon(x));
                 deleteNode(x);
             }
@@ -294,6 +449,7 @@ protected:
                 deleteNode(getRightSon(x));
                 deleteNode(x);
 
+                updateAugmentationPath(subtree_root);
                 fixTreeAfterErase(bad_subtree);
             }
         }
@@ -504,6 +660,16 @@ protected:
         }
     }
 
+    std::pair<TKey, TValue> popPosition(node_ptr x) {
+        if (x == NULL_PTR) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        std::pair<TKey, TValue> result(std::move(tree[x].data.first), std::move(tree[x].data.second));
+        --count_of_elements;
+        erasePosition(x);
+        return result;
+    }
+
     void lowerBound(const TKey& key, node_ptr x, node_ptr& nearest_pos) const {
         if (isFictitious(x)) {
             return;
@@ -517,6 +683,26 @@ protected:
         }
     }
 
+    // Climbs from the finger to the lowest ancestor whose subtree holds the lower bound of the key.
+    // An ancestor that bounds that subtree from above and is not less than the key goes to `nearest_pos`.
+    node_ptr climbFromFinger(node_ptr finger, const TKey& key, node_ptr& nearest_pos) const {
+        bool is_key_after_finger = getKey(finger) < key;
+        node_ptr current_ptr = finger;
+        while (getParent(current_ptr) != NULL_PTR) {
+            node_ptr parent = getParent(current_ptr);
+            bool is_left_son = getLeftSon(parent) == current_ptr;
+            if (is_key_after_finger && is_left_son && !(getKey(parent) < key)) {
+                nearest_pos = parent;
+                return current_ptr;
+            }
+            if (!is_key_after_finger && !is_left_son && getKey(parent) < key) {
+                return current_ptr;
+            }
+            current_ptr = parent;
+        }
+        return current_ptr;
+    }
+
     void upperBound(const TKey& key, node_ptr x, node_ptr&nearest_pos) const {
         if (isFictitious(x)) {
             return;
@@ -530,18 +716,214 @@ protected:
         }
     }
 
+    std::vector<bool> applyBatchBySearch(std::span<const BatchOperation<TKey, TValue>> batch) {
+        std::vector<bool> results(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const BatchOperation<TKey, TValue>& operation = batch[i];
+            // One descent per update; sorted keys share the top of their paths in cache.
+            node_ptr ptr = findPosition(operation.key);
+            bool is_found = !isFictitious(ptr);
+
+            if (operation.type == BatchOperation<TKey, TValue>::Type::ERASE) {
+                results[i] = is_found;
+                if (is_found) {
+                    --count_of_elements;
+                    erasePosition(ptr);
+                }
+            }
+            else if (is_found) {
+                tree[ptr].data.second = operation.value;
+            }
+            else {
+                ++count_of_elements;
+                insertPosition(ptr, operation.key, operation.value);
+                results[i] = true;
+            }
+        }
+        return results;
+    }
+
+    std::vector<bool> applyBatchByMerge(std::span<const BatchOperation<TKey, TValue>> batch) {
+        std::vector<bool> results(batch.size());
+        std::vector<std::pair<TKey, TValue>> merged;
+        merged.reserve(size() + batch.size());
+
+        Iterator it = begin();
+        auto takeElement = [&]() {
+            merged.emplace_back(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+            ++it;
+        };
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const BatchOperation<TKey, TValue>& operation = batch[i];
+            while (it != end() && !(operation.key < getKey(it.ptr))) {
+                takeElement();
+            }
+            bool is_found = !merged.empty() && merged.back().first == operation.key;
+
+            if (operation.type == BatchOperation<TKey, TValue>::Type::ERASE) {
+                results[i] = is_found;
+                if (is_found) {
+                    merged.pop_back();
+                }
+            }
+            else if (is_found) {
+                merged.back().second = operation.value;
+            }
+            else {
+                merged.emplace_back(operation.key, operation.value);
+                results[i] = true;
+            }
+        }
+        while (it != end()) {
+            takeElement();
+        }
+
+        buildFromSorted(std::move(merged));
+        return results;
+    }
+
+    // Sorts the free list so that new nodes take the lowest free slots, and gives the free slots
+    // at the end of the pool back to the container.
+    void compactFreePoses() {
+        std::vector<node_ptr> poses;
+        poses.reserve(free_poses.size());
+        for (size_t i = 0; i < free_poses.size(); ++i) {
+            poses.push_back(free_poses[i]);
+        }
+        std::sort(poses.begin(), poses.end());
+        while (!poses.empty() && static_cast<size_t>(poses.back()) + 1U == tree.size()) {
+            poses.pop_back();
+            tree.pop_back();
+        }
+        free_poses.clear();
+        for (auto it = poses.rbegin(); it != poses.rend(); ++it) {
+            free_poses.push_back(*it);
+        }
+    }
+
+    // Replaces the contents with the sorted elements of `sorted_data`, as a tree of minimal height.
+    void buildFromSorted(std::vector<std::pair<TKey, TValue>>&& sorted_data) {
+        if (sorted_data.empty()) {
+            clear();
+            return;
+        }
+        tree.clear();
+        free_poses.clear();
+        count_of_elements = sorted_data.size();
+
+        // Missing leaves are on the last two levels; coloring the nodes of the last level red
+        // gives every path the same number of black nodes.
+        size_t red_depth = std::bit_width(sorted_data.size() + 1U) - 1U;
+        root = buildSubtree(sorted_data, 0U, sorted_data.size(), NULL_PTR, 0U, red_depth);
+        leftmost = getLowestPos(root);
+        rightmost = getHighestPos(root);
+    }
+
+    // Each node takes the middle of its range, so the subtree sizes differ by at most one.
+    node_ptr buildSubtree(std::vector<std::pair<TKey, TValue>>& sorted_data, size_t begin, size_t end,
+                          node_ptr parent, size_t depth, size_t red_depth) {
+        node_ptr ptr = createNode(parent);
+        if (begin == end) {
+            return ptr;
+        }
+        size_t middle = begin + (end - begin) / 2U;
+        tree[ptr].data.first = std::move(sorted_data[middle].first);
+        tree[ptr].data.second = std::move(sorted_data[middle].second);
+        tree[ptr].is_fictitious = false;
+        tree[ptr].color = depth == red_depth ? Color::Red : Color::Black;
+
+        node_ptr left_son = buildSubtree(sorted_data, begin, middle, ptr, depth + 1U, red_depth);
+        node_ptr right_son = buildSubtree(sorted_data, middle + 1U, end, ptr, depth + 1U, red_depth);
+        tree[ptr].left_node = left_son;
+        tree[ptr].right_node = right_son;
+
+        updateAugmentation(ptr);
+        return ptr;
+    }
+
+    // A subtree of the parallel build left to a worker thread.
+    struct BuildTask {
+        size_t begin;
+        size_t end;
+        node_ptr parent;
+        node_ptr position;
+        size_t depth;
+    };
+
+    // Builds the subtree of [begin, end) like buildSubtree, but into the slots from `position` on:
+    // in preorder a subtree of k elements takes 2k + 1 slots with its fictitious leaves, so each
+    // subtree knows its place in advance. With `tasks`, the subtrees `split_depth` levels down
+    // are left to the workers, and the augmentation above them to updateTopAugmentation.
+    void placeSubtree(std::vector<std::pair<TKey, TValue>>& sorted_data, size_t begin, size_t end, node_ptr parent,
+                      node_ptr position, size_t depth, size_t red_depth, std::vector<BuildTask>* tasks,
+                      size_t split_depth) {
+        if (tasks != nullptr && depth == split_depth) {
+            tasks->push_back({ begin, end, parent, position, depth });
+            return;
+        }
+        tree[position].parent = parent;
+        tree[position].left_node = NULL_PTR;
+        tree[position].right_node = NULL_PTR;
+        tree[position].color = Color::Black;
+        tree[position].is_fictitious = true;
+        if (begin == end) {
+            return;
+        }
+        size_t middle = begin + (end - begin) / 2U;
+        tree[position].data.first = std::move(sorted_data[middle].first);
+        tree[position].data.second = std::move(sorted_data[middle].second);
+        tree[position].is_fictitious = false;
+        tree[position].color = depth == red_depth ? Color::Red : Color::Black;
+
+        node_ptr left_son = position + 1;
+        node_ptr right_son = position + 2 * static_cast<node_ptr>(middle - begin) + 2;
+        tree[position].left_node = left_son;
+        tree[position].right_node = right_son;
+        placeSubtree(sorted_data, begin, middle, position, left_son, depth + 1U, red_depth, tasks, split_depth);
+        placeSubtree(sorted_data, middle + 1U, end, position, right_son, depth + 1U, red_depth, tasks, split_depth);
+
+        if (tasks == nullptr) {
+            updateAugmentation(position);
+        }
+    }
+
+    void updateTopAugmentation(node_ptr x, size_t levels) {
+        if (levels == 0U || isFictitious(x)) {
+            return;
+        }
+        updateTopAugmentation(getLeftSon(x), levels - 1U);
+        updateTopAugmentation(getRightSon(x), levels - 1U);
+        updateAugmentation(x);
+    }
+
 public:
 
     RedBlackTree() {
         root = createNode(NULL_PTR);
     }
 
-    Iterator begin() const {
-        if (empty()) {
-            return end();
+    // Opens the tree stored at `path` or creates an empty one there. Needs a file-backed
+    // TContainer such as MappedVector; the free list is kept next to it in `path`.free. Changes
+    // reach the files only through flush().
+    explicit RedBlackTree(const std::string& path) :
+        tree(path),
+        free_poses(path + ".free")
+    {
+        if (tree.empty()) {
+            root = createNode(NULL_PTR);
+            return;
+        }
+        root = static_cast<node_ptr>(tree.getUserData()[0]);
+        count_of_elements = static_cast<size_t>(tree.getUserData()[1]);
+        if (!empty()) {
+            leftmost = getLowestPos(root);
+            rightmost = getHighestPos(root);
         }
-        node_ptr lowest_pos = getLowestPos(root);
-        return makeIterator(lowest_pos);
+    }
+
+    Iterator begin() const {
+        return makeIterator(leftmost);
     }
 
     Iterator end() const {
@@ -554,6 +936,21 @@ public:
         return makeIterator(nearest_pos);
     }
 
+    // Finger search: starts from `from` instead of the root, so a key near the finger is found
+    // after climbing only a few levels.
+    Iterator lowerBound(Iterator from, const TKey& key) {
+        if (from == end()) {
+            return lowerBound(key);
+        }
+        if (getKey(from.ptr) == key) {
+            return from;
+        }
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr subtree_root = climbFromFinger(from.ptr, key, nearest_pos);
+        lowerBound(key, subtree_root, nearest_pos);
+        return makeIterator(nearest_pos);
+    }
+
     Iterator upperBound(const TKey& key) {
         node_ptr nearest_pos = NULL_PTR;
         upperBound(key, root, nearest_pos);
@@ -564,17 +961,7 @@ public:
         node_ptr ptr = findPosition(key);
         if (isFictitious(ptr)) {
             ++count_of_elements;
-
-            tree[ptr].data.first = key;
-            tree[ptr].data.second = value;
-
-            tree[ptr].color = Color::Red;
-            tree[ptr].is_fictitious = false;
-
-            tree[ptr].left_node = createNode(ptr);
-            tree[ptr].right_node = createNode(ptr);
-
-            fixTreeAfterInsert(ptr);
+            insertPosition(ptr, key, value);
         }
         return makeIterator(ptr);
     }
@@ -588,12 +975,231 @@ public:
             throw std::out_of_range("No such key in the tree");
         }
         --count_of_elements;
+        // Erasing a node with two sons moves the next element into it.
         auto result = it;
-        ++result;
+        if (isFictitious(getLeftSon(it.ptr)) || isFictitious(getRightSon(it.ptr))) {
+            ++result;
+        }
         erasePosition(it.ptr);
         return result;
     }
 
+    // Applies a batch of updates sorted by key (equal keys in the order they should take effect).
+    // Returns for each update whether it inserted a new key (UPSERT) or erased a present one (ERASE).
+    // A batch that is small next to the tree is applied with one descent per update;
+    // a large one is merged with the elements of the tree and the tree is rebuilt.
+    std::vector<bool> applyBatch(std::span<const BatchOperation<TKey, TValue>> batch) {
+        for (size_t i = 1; i < batch.size(); ++i) {
+            if (batch[i].key < batch[i - 1].key) {
+                throw std::invalid_argument("The batch is not sorted by key");
+            }
+        }
+        if (batch.size() * REBUILD_BATCH_RATIO >= size()) {
+            return applyBatchByMerge(batch);
+        }
+        return applyBatchBySearch(batch);
+    }
+
+    // Replaces the contents with `elements`, which must be sorted by key without repeats, in O(n).
+    void assignSorted(std::vector<std::pair<TKey, TValue>> elements) {
+        for (size_t i = 1; i < elements.size(); ++i) {
+            if (!(elements[i - 1].first < elements[i].first)) {
+                throw std::invalid_argument("The elements are not sorted by key");
+            }
+        }
+        buildFromSorted(std::move(elements));
+    }
+
+    // Replaces the contents with `elements`, which may be unsorted; of equal keys the first one is kept.
+    // Sorting and building run on `count_of_threads` threads (0 means one per core): the top levels
+    // of the tree are built first, then the threads fill in the subtrees below them.
+    void buildParallel(std::vector<std::pair<TKey, TValue>> elements, size_t count_of_threads = 0) {
+        count_of_threads = getCountOfThreads(count_of_threads);
+        sortAndDeduplicate(elements, count_of_threads);
+        if (elements.empty()) {
+            clear();
+            return;
+        }
+        tree.clear();
+        free_poses.clear();
+        for (size_t i = 0; i < 2U * elements.size() + 1U; ++i) {
+            tree.push_back(Node());
+        }
+        count_of_elements = elements.size();
+
+        // About four subtrees per thread even out the work of the threads.
+        size_t split_depth = std::bit_width(4U * count_of_threads - 1U);
+        size_t red_depth = std::bit_width(elements.size() + 1U) - 1U;
+        std::vector<BuildTask> tasks;
+        root = 0;
+        placeSubtree(elements, 0U, elements.size(), NULL_PTR, root, 0U, red_depth, &tasks, split_depth);
+
+        size_t count_of_workers = std::min(count_of_threads, std::max<size_t>(tasks.size(), 1U));
+        runInThreads(count_of_workers, [&](size_t worker) {
+            for (size_t i = worker; i < tasks.size(); i += count_of_workers) {
+                const BuildTask& task = tasks[i];
+                placeSubtree(elements, task.begin, task.end, task.parent, task.position, task.depth, red_depth,
+                             nullptr, 0U);
+            }
+        });
+        updateTopAugmentation(root, split_depth);
+        leftmost = getLowestPos(root);
+        rightmost = getHighestPos(root);
+    }
+
+    // Erases the elements for which `predicate(key, value)` is true and returns their number.
+    // When a large part of the tree goes, the rest is rebuilt instead of being erased node by node.
+    template <typename TPredicate>
+    size_t eraseIf(TPredicate predicate) {
+        std::vector<node_ptr> erased_poses;
+        std::vector<node_ptr> kept_poses;
+        kept_poses.reserve(size());
+        for (auto it = begin(); it != end(); ++it) {
+            if (predicate(getKey(it.ptr), getValue(it.ptr))) {
+                erased_poses.push_back(it.ptr);
+            }
+            else {
+                kept_poses.push_back(it.ptr);
+            }
+        }
+
+        if (erased_poses.size() * REBUILD_ERASE_RATIO >= size()) {
+            std::vector<std::pair<TKey, TValue>> kept;
+            kept.reserve(kept_poses.size());
+            for (node_ptr x : kept_poses) {
+                kept.emplace_back(std::move(tree[x].data.first), std::move(tree[x].data.second));
+            }
+            buildFromSorted(std::move(kept));
+            return erased_poses.size();
+        }
+
+        // Erasing a node with two sons moves the next element into it and rotations do not move
+        // elements, so going from the highest key down keeps the remaining positions valid.
+        count_of_elements -= erased_poses.size();
+        for (auto it = erased_poses.rbegin(); it != erased_poses.rend(); ++it) {
+            erasePosition(*it);
+        }
+        compactFreePoses();
+        return erased_poses.size();
+    }
+
+    // Erases the elements of [first, last) and returns the iterator to the element after them.
+    Iterator eraseRange(Iterator first, Iterator last) {
+        size_t count = 0;
+        for (auto it = first; it != last; ++it) {
+            ++count;
+        }
+
+        if (count * REBUILD_ERASE_RATIO >= size()) {
+            std::optional<TKey> next_key;
+            if (last != end()) {
+                next_key = getKey(last.ptr);
+            }
+            std::vector<std::pair<TKey, TValue>> kept;
+            kept.reserve(size() - count);
+            bool is_inside = false;
+            for (auto it = begin(); it != end(); ++it) {
+                if (it == first) {
+                    is_inside = true;
+                }
+                if (it == last) {
+                    is_inside = false;
+                }
+                if (!is_inside) {
+                    kept.emplace_back(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+                }
+            }
+            buildFromSorted(std::move(kept));
+            return next_key.has_value() ? find(*next_key) : end();
+        }
+
+        // `last` may lose its node when its element moves into an erased one, so the elements are counted.
+        for (; count > 0U; --count) {
+            first = erase(first);
+        }
+        compactFreePoses();
+        return first;
+    }
+
+    // Removes the element and hands its key and value over without copying them.
+    NodeHandle<TKey, TValue> extract(const TKey& key) {
+        return extract(find(key));
+    }
+
+    NodeHandle<TKey, TValue> extract(Iterator it) {
+        if (it == end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        NodeHandle<TKey, TValue> handle(std::move(tree[it.ptr].data.first), std::move(tree[it.ptr].data.second));
+        --count_of_elements;
+        erasePosition(it.ptr);
+        return handle;
+    }
+
+    // Inserts the element of the handle. If the key is already present, the handle keeps the element.
+    Iterator insert(NodeHandle<TKey, TValue>&& handle) {
+        if (handle.empty()) {
+            return end();
+        }
+        node_ptr ptr = findPosition(handle.getKey());
+        if (isFictitious(ptr)) {
+            ++count_of_elements;
+            auto data = handle.release();
+            insertPosition(ptr, std::move(data.first), std::move(data.second));
+        }
+        return makeIterator(ptr);
+    }
+
+    // Moves every element of `other` whose key is not in this tree; the rest stay in `other`.
+    void merge(RedBlackTree<TKey, TValue, TContainer, TAugmentation>& other) {
+        auto it = other.begin();
+        while (it != other.end()) {
+            node_ptr source = it.ptr;
+            node_ptr ptr = findPosition(other.getKey(source));
+            if (!isFictitious(ptr)) {
+                ++it;
+                continue;
+            }
+            // Erasing a node with two sons moves the next element into it.
+            if (other.isFictitious(other.getLeftSon(source)) || other.isFictitious(other.getRightSon(source))) {
+                ++it;
+            }
+            ++count_of_elements;
+            insertPosition(ptr, std::move(other.tree[source].data.first), std::move(other.tree[source].data.second));
+            --other.count_of_elements;
+            other.erasePosition(source);
+        }
+    }
+
+    // The element with the smallest key.
+    std::pair<const TKey&, TValue&> front() {
+        return *makeIterator(leftmost);
+    }
+
+    const std::pair<const TKey&, const TValue&> front() const {
+        return *makeIterator(leftmost);
+    }
+
+    // The element with the largest key.
+    std::pair<const TKey&, TValue&> back() {
+        return *makeIterator(rightmost);
+    }
+
+    const std::pair<const TKey&, const TValue&> back() const {
+        return *makeIterator(rightmost);
+    }
+
+    // Removes and returns the element with the smallest key. Unlike erase(begin()),
+    // this does not walk to a successor: the new minimum is the right son of the old one or its parent.
+    std::pair<TKey, TValue> popMin() {
+        return popPosition(leftmost);
+    }
+
+    // Removes and returns the element with the largest key.
+    std::pair<TKey, TValue> popMax() {
+        return popPosition(rightmost);
+    }
+
     Iterator find(const TKey& key) const {
         node_ptr ptr = findPosition(key);
         if (isFictitious(ptr)) {
@@ -602,6 +1208,19 @@ public:
         return makeIterator(ptr);
     }
 
+    Iterator find(Iterator from, const TKey& key) const {
+        if (from == end()) {
+            return find(key);
+        }
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr subtree_root = climbFromFinger(from.ptr, key, nearest_pos);
+        lowerBound(key, subtree_root, nearest_pos);
+        if (nearest_pos == NULL_PTR || getKey(nearest_pos) != key) {
+            return end();
+        }
+        return makeIterator(nearest_pos);
+    }
+
     bool isExist(const TKey& key) const {
         return find(key) != end();
     }
@@ -631,9 +1250,42 @@ public:
     void clear() {
         tree.clear();
         this->count_of_elements = 0U;
+        leftmost = NULL_PTR;
+        rightmost = NULL_PTR;
 
         free_poses.clear();
 
-        root = createNode(root);
+        storeField(root, createNode(NULL_PTR));
+    }
+
+    FrozenTree<TKey, TValue> freeze() const {
+        std::vector<std::pair<TKey, TValue>> sorted_data;
+        sorted_data.reserve(size());
+        for (auto [key, value] : *this) {
+            sorted_data.emplace_back(key, value);
+        }
+        return FrozenTree<TKey, TValue>(std::move(sorted_data));
+    }
+
+    EytzingerIndex<TKey, TValue> toEytzinger() const {
+        std::vector<std::pair<TKey, TValue>> sorted_data;
+        sorted_data.reserve(size());
+        for (auto [key, value] : *this) {
+            sorted_data.emplace_back(key, value);
+        }
+        return EytzingerIndex<TKey, TValue>(std::move(sorted_data));
+    }
+
+    // Makes the current state of a file-backed tree durable: the nodes, the free list and the
+    // root are written as one atomic step, so after a crash the tree reopens as of the last flush.
+    void flush() {
+        tree.getUserData()[0] = static_cast<uint64_t>(root);
+        tree.getUserData()[1] = count_of_elements;
+        tree.flush(free_poses);
+    }
+
+    // Writes a frozen copy of the tree to `path`; FrozenTree::loadSnapshot maps it back.
+    void saveSnapshot(const std::string& path) const {
+        freeze().saveSnapshot(path);
     }
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+// Loads and stores of objects that one thread writes while others read them speculatively,
+// as in a seqlock: the reader validates what it copied afterwards, but the copy itself must
+// not be a data race. Both sides therefore go through relaxed atomics. A type that fits a
+// lock-free atomic is copied in one access, anything else byte by byte.
+
+template <typename T>
+constexpr bool IS_RELAXED_ATOMIC_WHOLE = std::atomic_ref<T>::is_always_lock_free &&
+                                         alignof(T) >= std::atomic_ref<T>::required_alignment;
+
+template <typename T>
+T loadRelaxed(const T& source) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable objects can be copied atomically");
+    if constexpr (IS_RELAXED_ATOMIC_WHOLE<T>) {
+        return std::atomic_ref<T>(const_cast<T&>(source)).load(std::memory_order_relaxed);
+    }
+    else {
+        std::array<unsigned char, sizeof(T)> bytes;
+        unsigned char* source_bytes = reinterpret_cast<unsigned char*>(const_cast<T*>(&source));
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = std::atomic_ref<unsigned char>(source_bytes[i]).load(std::memory_order_relaxed);
+        }
+        return std::bit_cast<T>(bytes);
+    }
+}
+
+template <typename T>
+void storeRelaxed(T& target, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable objects can be copied atomically");
+    if constexpr (IS_RELAXED_ATOMIC_WHOLE<T>) {
+        std::atomic_ref<T>(target).store(value, std::memory_order_relaxed);
+    }
+    else {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        unsigned char* target_bytes = reinterpret_cast<unsigned char*>(&target);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            std::atomic_ref<unsigned char>(target_bytes[i]).store(bytes[i], std::memory_order_relaxed);
+        }
+    }
+}
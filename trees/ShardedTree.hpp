@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AVLTree.hpp"
+
+// Ordered map for many concurrent writers.
+// The key space is split into ranges, each stored in its own tree behind its own lock,
+// so writers to different ranges do not contend. A background thread splits shards
+// that grew too large and merges neighbours that became too small. It builds the new
+// shards in O(n) while holding only the read locks of the shards involved, and takes
+// the layout lock exclusively just to swap them in.
+// Lookups on `TTree` must not modify it (SplayTree does not fit here).
+template <typename TKey, typename TValue, typename TTree = AVLTree<TKey, TValue>>
+class ShardedTree {
+protected:
+
+    struct Shard {
+        TTree tree;
+        mutable std::shared_mutex mutex;
+
+        // Bumped by every write, so a rebalance can tell that the shard changed after it was copied.
+        size_t version = 0;
+    };
+
+    // Shards [first, first + versions.size()) copied at the given versions and the shards built
+    // from them, which are separated by `inner_boundaries`.
+    struct LayoutChange {
+        size_t first;
+        size_t layout_version;
+        std::vector<size_t> versions;
+        std::vector<std::unique_ptr<Shard>> replacement;
+        std::vector<TKey> inner_boundaries;
+    };
+
+    // A rebalance that loses this many races with writers builds the next change under the layout lock.
+    const static size_t MAX_OPTIMISTIC_ATTEMPTS = 3;
+
+    // shards[i] holds the keys in [boundaries[i - 1], boundaries[i]).
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<TKey> boundaries;
+
+    // Shared by every operation, exclusive while the shard layout changes.
+    mutable std::shared_mutex layout_mutex;
+
+    // Bumped by every change of the layout, under the exclusive layout lock.
+    size_t layout_version = 0;
+
+    // Changed under the shared layout lock and the lock of the changed shard, so clear(), which takes
+    // the layout lock exclusively, never falls between an update and its count, and the updates of
+    // one key are counted in the order of its shard lock.
+    std::atomic<size_t> count_of_elements = 0;
+
+    size_t max_shard_size;
+
+    std::mutex maintenance_mutex;
+    std::condition_variable maintenance_cv;
+    bool needs_rebalance = false;
+    bool is_stopping = false;
+    std::thread maintenance_thread;
+
+protected:
+
+    size_t getShardIndex(const TKey& key) const {
+        return std::upper_bound(boundaries.begin(), boundaries.end(), key) - boundaries.begin();
+    }
+
+    Shard& getShard(const TKey& key) const {
+        return *shards[getShardIndex(key)];
+    }
+
+    size_t getMinShardSize() const {
+        return max_shard_size / 4U;
+    }
+
+    void requestRebalance() {
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex);
+            needs_rebalance = true;
+        }
+        maintenance_cv.notify_one();
+    }
+
+    void runMaintenance() {
+        std::unique_lock<std::mutex> lock(maintenance_mutex);
+        while (true) {
+            maintenance_cv.wait(lock, [this]() { return needs_rebalance || is_stopping; });
+            if (is_stopping) {
+                return;
+            }
+            needs_rebalance = false;
+
+            lock.unlock();
+            rebalance();
+            lock.lock();
+        }
+    }
+
+    size_t getShardSize(size_t index) const {
+        std::shared_lock<std::shared_mutex> lock(shards[index]->mutex);
+        return shards[index]->tree.size();
+    }
+
+    // The first shard to split, or else the first pair of neighbours to merge, as the index of
+    // the first shard and the number of shards; the number is 0 if the layout is fine.
+    // Needs the layout lock.
+    std::pair<size_t, size_t> findUnbalancedShards() const {
+        for (size_t index = 0; index < shards.size(); ++index) {
+            if (getShardSize(index) > max_shard_size) {
+                return { index, 1U };
+            }
+        }
+        for (size_t index = 0; index + 1U < shards.size(); ++index) {
+            size_t left_size = getShardSize(index);
+            size_t right_size = getShardSize(index + 1U);
+            if ((left_size < getMinShardSize() || right_size < getMinShardSize()) &&
+                left_size + right_size <= max_shard_size / 2U) {
+                return { index, 2U };
+            }
+        }
+        return { 0U, 0U };
+    }
+
+    // Copies the shards to split or merge under their read locks and builds their replacement
+    // from the sorted elements: one shard splits into halves, two neighbours merge into one.
+    // Needs the layout lock.
+    std::optional<LayoutChange> planLayoutChange() const {
+        auto [first, count] = findUnbalancedShards();
+        if (count == 0U) {
+            return std::nullopt;
+        }
+
+        LayoutChange change;
+        change.first = first;
+        change.layout_version = layout_version;
+        std::vector<std::pair<TKey, TValue>> elements;
+        for (size_t index = first; index < first + count; ++index) {
+            std::shared_lock<std::shared_mutex> lock(shards[index]->mutex);
+            change.versions.push_back(shards[index]->version);
+            const TTree& tree = shards[index]->tree;
+            for (auto it = tree.begin(); it != tree.end(); ++it) {
+                elements.emplace_back(it->first, it->second);
+            }
+        }
+
+        // A shard that shrank since it was measured is only rebuilt.
+        if (count == 1U && elements.size() > 1U) {
+            size_t middle = elements.size() / 2U;
+            change.inner_boundaries.push_back(elements[middle].first);
+            std::vector<std::pair<TKey, TValue>> upper(std::make_move_iterator(elements.begin() + middle),
+                                                       std::make_move_iterator(elements.end()));
+            elements.erase(elements.begin() + middle, elements.end());
+            change.replacement.push_back(std::make_unique<Shard>());
+            change.replacement.back()->tree.assignSorted(std::move(elements));
+            change.replacement.push_back(std::make_unique<Shard>());
+            change.replacement.back()->tree.assignSorted(std::move(upper));
+        }
+        else {
+            change.replacement.push_back(std::make_unique<Shard>());
+            change.replacement.back()->tree.assignSorted(std::move(elements));
+        }
+        return change;
+    }
+
+    // Swaps in the shards of `change` unless the layout or a copied shard changed since the copy.
+    // The replaced shards are left in `change`, so they are freed after the layout lock is released.
+    // Needs the exclusive layout lock.
+    bool applyLayoutChange(LayoutChange& change) {
+        if (change.layout_version != layout_version) {
+            return false;
+        }
+        size_t count = change.versions.size();
+        for (size_t i = 0; i < count; ++i) {
+            if (shards[change.first + i]->version != change.versions[i]) {
+                return false;
+            }
+        }
+
+        auto first_shard = shards.begin() + change.first;
+        std::vector<std::unique_ptr<Shard>> replaced(std::make_move_iterator(first_shard),
+                                                     std::make_move_iterator(first_shard + count));
+        first_shard = shards.erase(first_shard, first_shard + count);
+        shards.insert(first_shard, std::make_move_iterator(change.replacement.begin()),
+                      std::make_move_iterator(change.replacement.end()));
+        change.replacement = std::move(replaced);
+
+        auto first_boundary = boundaries.begin() + change.first;
+        first_boundary = boundaries.erase(first_boundary, first_boundary + (count - 1U));
+        boundaries.insert(first_boundary, change.inner_boundaries.begin(), change.inner_boundaries.end());
+
+        ++layout_version;
+        return true;
+    }
+
+public:
+
+    explicit ShardedTree(size_t max_shard_size = 1U << 16) :
+        max_shard_size(std::max<size_t>(max_shard_size, 4U))
+    {
+        shards.push_back(std::make_unique<Shard>());
+        maintenance_thread = std::thread([this]() { runMaintenance(); });
+    }
+
+    ShardedTree(const ShardedTree&) = delete;
+    ShardedTree& operator=(const ShardedTree&) = delete;
+
+    ~ShardedTree() {
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex);
+            is_stopping = true;
+        }
+        maintenance_cv.notify_one();
+        maintenance_thread.join();
+    }
+
+    bool insert(const TKey& key, const TValue& value) {
+        bool is_inserted = false;
+        bool is_too_large = false;
+        {
+            std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+            Shard& shard = getShard(key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            size_t size_before = shard.tree.size();
+            shard.tree.insert(key, value);
+            is_inserted = shard.tree.size() != size_before;
+            is_too_large = shard.tree.size() > max_shard_size;
+            if (is_inserted) {
+                ++shard.version;
+                ++count_of_elements;
+            }
+        }
+        if (is_too_large) {
+            requestRebalance();
+        }
+        return is_inserted;
+    }
+
+    // Inserts the element or overwrites the value of an existing one.
+    void assign(const TKey& key, const TValue& value) {
+        bool is_too_large = false;
+        {
+            std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+            Shard& shard = getShard(key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            ++shard.version;
+            auto it = shard.tree.find(key);
+            if (it != shard.tree.end()) {
+                it->second = value;
+                return;
+            }
+            shard.tree.insert(key, value);
+            is_too_large = shard.tree.size() > max_shard_size;
+            ++count_of_elements;
+        }
+        if (is_too_large) {
+            requestRebalance();
+        }
+    }
+
+    bool erase(const TKey& key) {
+        bool is_too_small = false;
+        {
+            std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+            Shard& shard = getShard(key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            auto it = shard.tree.find(key);
+            if (it == shard.tree.end()) {
+                return false;
+            }
+            shard.tree.erase(it);
+            ++shard.version;
+            is_too_small = shards.size() > 1U && shard.tree.size() < getMinShardSize();
+            --count_of_elements;
+        }
+        if (is_too_small) {
+            requestRebalance();
+        }
+        return true;
+    }
+
+    std::optional<TValue> find(const TKey& key) const {
+        std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+        const Shard& shard = getShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        auto it = shard.tree.find(key);
+        if (it == shard.tree.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    bool isExist(const TKey& key) const {
+        return find(key).has_value();
+    }
+
+    // The first element not less than `key`, looking into the following shards if needed.
+    std::optional<std::pair<TKey, TValue>> lowerBound(const TKey& key) const {
+        return findBound(key, true);
+    }
+
+    std::optional<std::pair<TKey, TValue>> upperBound(const TKey& key) const {
+        return findBound(key, false);
+    }
+
+    // Calls `callback(key, value)` for the elements not less than `from` in increasing order.
+    // Each shard is visited under its own lock, so the view is consistent per shard.
+    template <typename TCallback>
+    void forEach(const TKey& from, TCallback callback) const {
+        std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+        for (size_t index = getShardIndex(from); index < shards.size(); ++index) {
+            std::shared_lock<std::shared_mutex> lock(shards[index]->mutex);
+            TTree& tree = shards[index]->tree;
+            for (auto it = tree.lowerBound(from); it != tree.end(); ++it) {
+                callback(it->first, it->second);
+            }
+        }
+    }
+
+    template <typename TCallback>
+    void forEach(TCallback callback) const {
+        std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard->mutex);
+            for (auto [key, value] : shard->tree) {
+                callback(key, value);
+            }
+        }
+    }
+
+    size_t size() const {
+        return count_of_elements.load();
+    }
+
+    bool empty() const {
+        return size() == 0U;
+    }
+
+    size_t getCountOfShards() const {
+        std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+        return shards.size();
+    }
+
+    void clear() {
+        std::unique_lock<std::shared_mutex> layout_lock(layout_mutex);
+        shards.clear();
+        boundaries.clear();
+        shards.push_back(std::make_unique<Shard>());
+        count_of_elements = 0U;
+        ++layout_version;
+    }
+
+    // Splits oversized shards and merges undersized neighbours.
+    // Runs in the background after writes; may also be called directly.
+    // Each change is built under the shared layout lock and swapped in under the exclusive one;
+    // if a writer changed the shards in between, the change is built again.
+    void rebalance() {
+        size_t count_of_failures = 0;
+        while (true) {
+            std::optional<LayoutChange> change;
+            if (count_of_failures < MAX_OPTIMISTIC_ATTEMPTS) {
+                std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+                change = planLayoutChange();
+                if (!change.has_value()) {
+                    return;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> layout_lock(layout_mutex);
+            if (!change.has_value()) {
+                change = planLayoutChange();
+                if (!change.has_value()) {
+                    return;
+                }
+            }
+            count_of_failures = applyLayoutChange(*change) ? 0U : count_of_failures + 1U;
+        }
+    }
+
+protected:
+
+    std::optional<std::pair<TKey, TValue>> findBound(const TKey& key, bool inclusive) const {
+        std::shared_lock<std::shared_mutex> layout_lock(layout_mutex);
+        for (size_t index = getShardIndex(key); index < shards.size(); ++index) {
+            std::shared_lock<std::shared_mutex> lock(shards[index]->mutex);
+            TTree& tree = shards[index]->tree;
+            auto it = inclusive ? tree.lowerBound(key) : tree.upperBound(key);
+            if (it != tree.end()) {
+                return std::pair<TKey, TValue>(it->first, it->second);
+            }
+        }
+        return std::nullopt;
+    }
+};
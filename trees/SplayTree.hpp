@@ -0,0 +1,437 @@
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Self-adjusting search tree: every access moves the touched node towards the root,
+// so recently and frequently used keys are found in a few steps.
+// With `SemiSplaying` the zig-zig step rotates only the parent and continues from it,
+// which halves the restructuring work per access.
+template <typename TKey, typename TValue, bool SemiSplaying = false>
+class SplayTree {
+protected:
+
+    using node_ptr = int;
+    const static node_ptr NULL_PTR = -1;
+
+    struct Node {
+
+        node_ptr parent;
+        node_ptr left_node, right_node;
+
+        std::pair<TKey, TValue> data;
+
+        bool is_fictitious;
+    };
+
+public:
+
+    class Iterator {
+    protected:
+
+        node_ptr ptr = 0;
+
+        SplayTree<TKey, TValue, SemiSplaying>* container_ptr;
+
+        Iterator(node_ptr ptr, SplayTree<TKey, TValue, SemiSplaying>* container_ptr) :
+            ptr(ptr),
+            container_ptr(container_ptr)
+        {}
+
+    public:
+
+        std::pair<const TKey&, TValue&> operator*() {
+            if (ptr == NULL_PTR) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            return { container_ptr->tree[ptr].data.first, container_ptr->tree[ptr].data.second };
+        }
+
+        const std::pair<const TKey&, const TValue&> operator*() const {
+            if (ptr == NULL_PTR) {
+                throw std::out_of_range("It is forbidden to dereference .end() iterator.");
+            }
+            return { container_ptr->tree[ptr].data.first, container_ptr->tree[ptr].data.second };
+        }
+
+        std::pair<TKey, TValue>* operator->() const {
+            return &container_ptr->tree[ptr].data;
+        }
+
+        Iterator& operator++() {
+            node_ptr curr_node_ptr = ptr;
+            node_ptr right_son_ptr = container_ptr->tree[curr_node_ptr].right_node;
+
+            if (!container_ptr->tree[right_son_ptr].is_fictitious) {
+                ptr = container_ptr->getLowestPos(right_son_ptr);
+                return *this;
+            }
+
+            node_ptr prev_node_ptr = container_ptr->tree[curr_node_ptr].parent;
+            while (prev_node_ptr != NULL_PTR && container_ptr->tree[prev_node_ptr].right_node == curr_node_ptr) {
+                curr_node_ptr = prev_node_ptr;
+                prev_node_ptr = container_ptr->tree[curr_node_ptr].parent;
+            }
+            ptr = prev_node_ptr;
+
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return this->ptr == other.ptr;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return this->ptr != other.ptr;
+        }
+
+        friend class SplayTree;
+    };
+
+protected:
+
+    std::vector<Node> tree;
+    size_t count_of_elements = 0;
+
+    node_ptr root;
+
+    std::vector<node_ptr> free_poses;
+
+protected:
+
+    Iterator makeIterator(node_ptr position) const {
+        return Iterator(position, const_cast<SplayTree<TKey, TValue, SemiSplaying>*>(this));
+    }
+
+    node_ptr createNode(node_ptr parent) {
+        if (free_poses.empty()) {
+            free_poses.push_back(static_cast<node_ptr>(tree.size()));
+            tree.push_back(Node());
+        }
+        node_ptr ptr = free_poses.back();
+        free_poses.pop_back();
+
+        tree[ptr].parent = parent;
+        tree[ptr].left_node = NULL_PTR;
+        tree[ptr].right_node = NULL_PTR;
+
+        tree[ptr].is_fictitious = true;
+
+        return ptr;
+    }
+
+    void deleteNode(node_ptr ptr) {
+        free_poses.push_back(ptr);
+    }
+
+protected:
+    void smallLeftRotation(node_ptr x) {
+        node_ptr y = getRightSon(x);
+
+        node_ptr subtree_root = getParent(x);
+
+        tree[x].right_node = tree[y].left_node;
+        if (getRightSon(x) != NULL_PTR) {
+            tree[getRightSon(x)].parent = x;
+        }
+
+        tree[x].parent = y;
+
+        tree[y].parent = subtree_root;
+        tree[y].left_node = x;
+
+        changeParent(subtree_root, x, y);
+    }
+
+    void smallRightRotation(node_ptr x) {
+        node_ptr y = getLeftSon(x);
+
+        node_ptr subtree_root = getParent(x);
+
+        tree[x].left_node = tree[y].right_node;
+        if (getLeftSon(x) != NULL_PTR) {
+            tree[getLeftSon(x)].parent = x;
+        }
+
+        tree[x].parent = y;
+
+        tree[y].parent = subtree_root;
+        tree[y].right_node = x;
+
+        changeParent(subtree_root, x, y);
+    }
+
+    // Rotates `x` above its parent.
+    void rotateUp(node_ptr x) {
+        node_ptr p = getParent(x);
+        if (getLeftSon(p) == x) {
+            smallRightRotation(p);
+        }
+        else {
+            smallLeftRotation(p);
+        }
+    }
+
+    void splay(node_ptr x) {
+        while (getParent(x) != NULL_PTR) {
+            node_ptr p = getParent(x);
+            node_ptr g = getParent(p);
+
+            if (g == NULL_PTR) {
+                rotateUp(x);
+                return;
+            }
+
+            bool is_zig_zig = (getLeftSon(g) == p) == (getLeftSon(p) == x);
+            if (is_zig_zig) {
+                rotateUp(p);
+                if constexpr (SemiSplaying) {
+                    x = p;
+                }
+                else {
+                    rotateUp(x);
+                }
+            }
+            else {
+                rotateUp(x);
+                rotateUp(x);
+            }
+        }
+    }
+
+protected:
+    node_ptr getLeftSon(node_ptr x) const {
+        return tree[x].left_node;
+    }
+
+    node_ptr getRightSon(node_ptr x) const {
+        return tree[x].right_node;
+    }
+
+    node_ptr getParent(node_ptr x) const {
+        return tree[x].parent;
+    }
+
+    const TKey& getKey(node_ptr x) const {
+        return tree[x].data.first;
+    }
+
+    const TValue& getValue(node_ptr x) const {
+        return tree[x].data.second;
+    }
+
+    bool isFictitious(node_ptr x) const {
+        return tree[x].is_fictitious;
+    }
+
+    void changeParent(node_ptr parent, node_ptr old_son, node_ptr new_son) {
+        if (parent == NULL_PTR) {
+            root = new_son;
+        }
+        else {
+            if (getLeftSon(parent) == old_son) {
+                tree[parent].left_node = new_son;
+            }
+            else {
+                tree[parent].right_node = new_son;
+            }
+        }
+        tree[new_son].parent = parent;
+    }
+
+protected:
+
+    node_ptr getLowestPos(node_ptr x) const {
+        node_ptr lowest_pos = x;
+        while (!isFictitious(getLeftSon(lowest_pos))) {
+            lowest_pos = getLeftSon(lowest_pos);
+        }
+        return lowest_pos;
+    }
+
+    node_ptr findPosition(const TKey& key) const {
+        node_ptr current_ptr = root;
+        while (!isFictitious(current_ptr) && getKey(current_ptr) != key) {
+            if (getKey(current_ptr) > key) {
+                current_ptr = tree[current_ptr].left_node;
+            }
+            else {
+                current_ptr = tree[current_ptr].right_node;
+            }
+        }
+        return current_ptr;
+    }
+
+    // Splays the last real node on the search path, which keeps the amortized bound
+    // for unsuccessful searches too.
+    void splaySearchPath(node_ptr ptr) {
+        if (isFictitious(ptr)) {
+            ptr = getParent(ptr);
+        }
+        if (ptr != NULL_PTR) {
+            splay(ptr);
+        }
+    }
+
+    // Unlinks `x` and returns the parent of the removed node.
+    node_ptr erasePosition(node_ptr x) {
+        if (!isFictitious(getLeftSon(x)) && !isFictitious(getRightSon(x))) {
+            node_ptr min_right = getLowestPos(getRightSon(x));
+            std::swap(tree[x].data, tree[min_right].data);
+            return erasePosition(min_right);
+        }
+
+        node_ptr parent = getParent(x);
+        if (isFictitious(getLeftSon(x))) {
+            changeParent(parent, x, getRightSon(x));
+            deleteNode(getLeftSon(x));
+        }
+        else {
+            changeParent(parent, x, getLeftSon(x));
+            deleteNode(getRightSon(x));
+        }
+        deleteNode(x);
+
+        return parent;
+    }
+
+    void lowerBound(const TKey& key, node_ptr x, node_ptr& nearest_pos, node_ptr& last_pos) const {
+        while (!isFictitious(x)) {
+            last_pos = x;
+            if (getKey(x) >= key) {
+                nearest_pos = x;
+                x = getLeftSon(x);
+            }
+            else {
+                x = getRightSon(x);
+            }
+        }
+    }
+
+    void upperBound(const TKey& key, node_ptr x, node_ptr& nearest_pos, node_ptr& last_pos) const {
+        while (!isFictitious(x)) {
+            last_pos = x;
+            if (getKey(x) > key) {
+                nearest_pos = x;
+                x = getLeftSon(x);
+            }
+            else {
+                x = getRightSon(x);
+            }
+        }
+    }
+
+public:
+
+    SplayTree() {
+        root = createNode(NULL_PTR);
+    }
+
+    Iterator begin() const {
+        if (empty()) {
+            return end();
+        }
+        node_ptr lowest_pos = getLowestPos(root);
+        return makeIterator(lowest_pos);
+    }
+
+    Iterator end() const {
+        return makeIterator(NULL_PTR);
+    }
+
+    Iterator lowerBound(const TKey& key) {
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr last_pos = NULL_PTR;
+        lowerBound(key, root, nearest_pos, last_pos);
+        splaySearchPath(last_pos == NULL_PTR ? root : last_pos);
+        return makeIterator(nearest_pos);
+    }
+
+    Iterator upperBound(const TKey& key) {
+        node_ptr nearest_pos = NULL_PTR;
+        node_ptr last_pos = NULL_PTR;
+        upperBound(key, root, nearest_pos, last_pos);
+        splaySearchPath(last_pos == NULL_PTR ? root : last_pos);
+        return makeIterator(nearest_pos);
+    }
+
+    Iterator insert(const TKey& key, const TValue& value) {
+        node_ptr ptr = findPosition(key);
+        if (isFictitious(ptr)) {
+            ++count_of_elements;
+
+            tree[ptr].data.first = key;
+            tree[ptr].data.second = value;
+
+            tree[ptr].is_fictitious = false;
+
+            tree[ptr].left_node = createNode(ptr);
+            tree[ptr].right_node = createNode(ptr);
+        }
+        splay(ptr);
+        return makeIterator(ptr);
+    }
+
+    Iterator erase(const TKey& key) {
+        return erase(find(key));
+    }
+
+    Iterator erase(Iterator it) {
+        if (it == end()) {
+            throw std::out_of_range("No such key in the tree");
+        }
+        --count_of_elements;
+
+        // With two children the successor's payload moves into this node.
+        bool has_two_sons = !isFictitious(getLeftSon(it.ptr)) && !isFictitious(getRightSon(it.ptr));
+
+        auto result = it;
+        if (!has_two_sons) {
+            ++result;
+        }
+
+        node_ptr parent = erasePosition(it.ptr);
+        if (parent != NULL_PTR) {
+            splay(parent);
+        }
+        return result;
+    }
+
+    Iterator find(const TKey& key) {
+        node_ptr ptr = findPosition(key);
+        splaySearchPath(ptr);
+        if (isFictitious(ptr)) {
+            return end();
+        }
+        return makeIterator(ptr);
+    }
+
+    bool isExist(const TKey& key) {
+        return find(key) != end();
+    }
+
+    TValue& operator[](const TKey& key) {
+        auto it = find(key);
+        if (it == end()) {
+            throw std::runtime_error("No such key in table");
+        }
+        return (*it).second;
+    }
+
+    size_t size() const {
+        return count_of_elements;
+    }
+
+    bool empty() const {
+        return count_of_elements == 0U;
+    }
+
+    void clear() {
+        tree.clear();
+        this->count_of_elements = 0U;
+
+        free_poses.clear();
+        root = createNode(NULL_PTR);
+    }
+};
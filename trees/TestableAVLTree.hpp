@@ -2,12 +2,12 @@
 
 #include "AVLTree.hpp"
 
-template <typename TKey, typename TValue>
-class TestableAVLTree : public AVLTree<TKey, TValue> {
+template <typename TKey, typename TValue, template <typename...> class TContainer = std::vector>
+class TestableAVLTree : public AVLTree<TKey, TValue, TContainer> {
 
-    using typename AVLTree<TKey, TValue>::node_ptr;
+    using typename AVLTree<TKey, TValue, TContainer>::node_ptr;
 
-    using AVLTree<TKey, TValue>::NULL_PTR;
+    using AVLTree<TKey, TValue, TContainer>::NULL_PTR;
 
 protected:
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BPlusTree.hpp"
+
+template <typename TKey, typename TValue, size_t Fanout = 32>
+class TestableBPlusTree : public BPlusTree<TKey, TValue, Fanout> {
+
+    using typename BPlusTree<TKey, TValue, Fanout>::node_ptr;
+
+    using BPlusTree<TKey, TValue, Fanout>::NULL_PTR;
+    using BPlusTree<TKey, TValue, Fanout>::MIN_LEAF_KEYS;
+    using BPlusTree<TKey, TValue, Fanout>::MIN_INNER_KEYS;
+
+protected:
+
+    // Checks the subtree of `x` at `level` levels above the leaves: every key lies in [lo, hi)
+    // (a missing bound is unlimited), nodes are sorted and filled enough, and the leaves are
+    // met in the same order as in the leaf list.
+    bool isCorrectSubtree(node_ptr x, size_t level, const TKey* lo, const TKey* hi,
+                          node_ptr& expected_leaf, size_t& count) const {
+        bool is_root = (x == this->root);
+
+        if (level == 0U) {
+            const auto& leaf = this->leaves[x];
+            if (x != expected_leaf) {
+                return false;
+            }
+            if (!is_root && leaf.count < MIN_LEAF_KEYS) {
+                return false;
+            }
+            for (size_t i = 0; i < leaf.count; ++i) {
+                if (i > 0 && leaf.keys[i - 1] >= leaf.keys[i]) {
+                    return false;
+                }
+                if ((lo != nullptr && leaf.keys[i] < *lo) || (hi != nullptr && leaf.keys[i] >= *hi)) {
+                    return false;
+                }
+            }
+            if (leaf.next_leaf != NULL_PTR && this->leaves[leaf.next_leaf].prev_leaf != x) {
+                return false;
+            }
+            count += leaf.count;
+            expected_leaf = leaf.next_leaf;
+            return true;
+        }
+
+        const auto& inner = this->inners[x];
+        if (inner.count == 0U || (!is_root && inner.count < MIN_INNER_KEYS)) {
+            return false;
+        }
+        for (size_t i = 0; i < inner.count; ++i) {
+            if (i > 0 && inner.keys[i - 1] >= inner.keys[i]) {
+                return false;
+            }
+            if ((lo != nullptr && inner.keys[i] < *lo) || (hi != nullptr && inner.keys[i] >= *hi)) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i <= inner.count; ++i) {
+            const TKey* child_lo = (i == 0U ? lo : &inner.keys[i - 1]);
+            const TKey* child_hi = (i == inner.count ? hi : &inner.keys[i]);
+            if (!isCorrectSubtree(inner.children[i], level - 1, child_lo, child_hi, expected_leaf, count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+
+    bool isTreeCorrect() {
+        node_ptr expected_leaf = this->getLowestLeaf();
+        if (this->leaves[expected_leaf].prev_leaf != NULL_PTR) {
+            return false;
+        }
+
+        size_t count = 0;
+        bool is_correct_subtree = isCorrectSubtree(this->root, this->height, nullptr, nullptr, expected_leaf, count);
+        bool is_correct_size = (this->size() == count);
+
+        return is_correct_subtree && expected_leaf == NULL_PTR && is_correct_size;
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "IntervalTree.hpp"
+
+template <typename TPoint, typename TValue>
+class TestableIntervalTree : public IntervalTree<TPoint, TValue> {
+
+    using typename IntervalTree<TPoint, TValue>::node_ptr;
+
+protected:
+    // Checks `max_high` of the subtree and returns the number of its intervals.
+    size_t getCountOfCorrectNode(node_ptr x, bool& is_correct_max) const {
+        if (this->isFictitious(x)) {
+            return 0U;
+        }
+        TPoint expected_max = this->getKey(x).high;
+        for (node_ptr son : { this->getLeftSon(x), this->getRightSon(x) }) {
+            if (!this->isFictitious(son) && expected_max < this->getValue(son).max_high) {
+                expected_max = this->getValue(son).max_high;
+            }
+        }
+        if (this->getValue(x).max_high != expected_max) {
+            is_correct_max = false;
+        }
+        return 1U + getCountOfCorrectNode(this->getLeftSon(x), is_correct_max) +
+               getCountOfCorrectNode(this->getRightSon(x), is_correct_max);
+    }
+
+public:
+
+    bool isTreeCorrect() const {
+        bool is_correct_max = true;
+        bool is_correct_size = getCountOfCorrectNode(this->root, is_correct_max) == this->size();
+        return is_correct_max && is_correct_size;
+    }
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "KdTree.hpp"
+
+template <typename TCoordinate, size_t Dimensions, typename TValue>
+class TestableKdTree : public KdTree<TCoordinate, Dimensions, TValue> {
+
+    using typename KdTree<TCoordinate, Dimensions, TValue>::node_ptr;
+
+    using KdTree<TCoordinate, Dimensions, TValue>::NULL_PTR;
+
+protected:
+    // Checks that the subtree is on the right side of the split of every ancestor and that the stored
+    // sizes match. Returns the number of nodes; live ones are added to `count`.
+    size_t getCountOfCorrectNode(node_ptr x, std::vector<std::pair<node_ptr, bool>>& ancestors, size_t& count,
+                                 bool& is_correct) const {
+        if (x == NULL_PTR) {
+            return 0U;
+        }
+        for (auto [ancestor, is_right] : ancestors) {
+            if (this->isRightOf(ancestor, this->getPoint(x)) != is_right) {
+                is_correct = false;
+            }
+        }
+
+        ancestors.emplace_back(x, false);
+        size_t count_of_nodes = getCountOfCorrectNode(this->tree[x].left_node, ancestors, count, is_correct);
+        ancestors.back().second = true;
+        count_of_nodes += getCountOfCorrectNode(this->tree[x].right_node, ancestors, count, is_correct);
+        ancestors.pop_back();
+
+        ++count_of_nodes;
+        if (this->tree[x].size != count_of_nodes) {
+            is_correct = false;
+        }
+        if (!this->tree[x].is_erased) {
+            ++count;
+        }
+        return count_of_nodes;
+    }
+
+    size_t getHeight(node_ptr x) const {
+        if (x == NULL_PTR) {
+            return 0U;
+        }
+        return std::max(getHeight(this->tree[x].left_node), getHeight(this->tree[x].right_node)) + 1U;
+    }
+
+public:
+
+    using KdTree<TCoordinate, Dimensions, TValue>::KdTree;
+
+    bool isTreeCorrect() const {
+        bool is_correct = true;
+        size_t count = 0;
+        std::vector<std::pair<node_ptr, bool>> ancestors;
+        size_t count_of_nodes = getCountOfCorrectNode(this->root, ancestors, count, is_correct);
+        return is_correct && count == this->size() && count_of_nodes == this->size() + this->count_of_erased;
+    }
+
+    size_t getHeight() const {
+        return getHeight(this->root);
+    }
+};
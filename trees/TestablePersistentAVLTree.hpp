@@ -0,0 +1,80 @@
+#pragma once
+
+#include "PersistentAVLTree.hpp"
+
+template <typename TKey, typename TValue>
+class TestablePersistentAVLTree : public PersistentAVLTree<TKey, TValue> {
+
+    using typename PersistentAVLTree<TKey, TValue>::node_ptr;
+
+    using PersistentAVLTree<TKey, TValue>::NULL_PTR;
+
+protected:
+
+    size_t getHeights(bool& is_correct_heights, node_ptr x) const {
+        if (x == NULL_PTR) {
+            return 0U;
+        }
+
+        size_t left_height = getHeights(is_correct_heights, this->getLeftSon(x));
+        size_t right_height = getHeights(is_correct_heights, this->getRightSon(x));
+
+        if (std::abs((int)left_height - (int)right_height) > 1) {
+            is_correct_heights = false;
+        }
+
+        size_t curr_height = std::max(left_height, right_height) + 1U;
+
+        if (this->getHeight(x) != curr_height) {
+            is_correct_heights = false;
+        }
+
+        return curr_height;
+    }
+
+    size_t getCountOfNodes(node_ptr x) const {
+        if (x == NULL_PTR) {
+            return 0U;
+        }
+        return getCountOfNodes(this->getLeftSon(x)) + getCountOfNodes(this->getRightSon(x)) + 1U;
+    }
+
+    bool isSearchTree(node_ptr x) const {
+        if (x == NULL_PTR) {
+            return true;
+        }
+        node_ptr left = this->getLeftSon(x);
+        node_ptr right = this->getRightSon(x);
+        if (left != NULL_PTR && this->getKey(x) <= this->getKey(left)) {
+            return false;
+        }
+        if (right != NULL_PTR && this->getKey(x) >= this->getKey(right)) {
+            return false;
+        }
+        return isSearchTree(left) && isSearchTree(right);
+    }
+
+public:
+
+    using PersistentAVLTree<TKey, TValue>::PersistentAVLTree;
+
+    TestablePersistentAVLTree(const PersistentAVLTree<TKey, TValue>& other) :
+        PersistentAVLTree<TKey, TValue>(other)
+    {}
+
+    bool isTreeCorrect() const {
+
+        bool is_correct_heights = true;
+        getHeights(is_correct_heights, this->root);
+
+        bool is_search_tree = isSearchTree(this->root);
+        bool is_correct_size = (this->size() == getCountOfNodes(this->root));
+
+        return is_correct_heights && is_search_tree && is_correct_size;
+    }
+
+    // Slots of the shared pool that are not on the free list.
+    size_t getCountOfUsedNodes() const {
+        return this->pool->tree.size() - this->pool->free_poses.size();
+    }
+};
@@ -2,13 +2,13 @@
 
 #include "RedBlackTree.hpp"
 
-template <typename TKey, typename TValue>
-class TestableRedBlackTree : public RedBlackTree<TKey, TValue> {
+template <typename TKey, typename TValue, template <typename...> class TContainer = std::vector>
+class TestableRedBlackTree : public RedBlackTree<TKey, TValue, TContainer> {
 
-    using typename RedBlackTree<TKey, TValue>::node_ptr;
-    using typename RedBlackTree<TKey, TValue>::Color;
+    using typename RedBlackTree<TKey, TValue, TContainer>::node_ptr;
+    using typename RedBlackTree<TKey, TValue, TContainer>::Color;
 
-    using RedBlackTree<TKey, TValue>::NULL_PTR;
+    using RedBlackTree<TKey, TValue, TContainer>::NULL_PTR;
 
 protected:
     size_t getBlackHeight(bool& is_correct_bh, node_ptr x) const {
@@ -106,6 +106,10 @@ public:
         bool is_search_tree = isSearchTree(this->root, this->root);
         bool is_correct_size = (this->size() == getCountOfCorrectNode(this->root));
 
-        return is_correct_bh && is_correct_red_vertices && is_search_tree && is_correct_size;
+        bool is_correct_bounds = this->empty() ?
+            (this->leftmost == NULL_PTR && this->rightmost == NULL_PTR) :
+            (this->leftmost == this->getLowestPos(this->root) && this->rightmost == this->getHighestPos(this->root));
+
+        return is_correct_bh && is_correct_red_vertices && is_search_tree && is_correct_size && is_correct_bounds;
     }
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SplayTree.hpp"
+
+template <typename TKey, typename TValue, bool SemiSplaying = false>
+class TestableSplayTree : public SplayTree<TKey, TValue, SemiSplaying> {
+
+    using typename SplayTree<TKey, TValue, SemiSplaying>::node_ptr;
+
+    using SplayTree<TKey, TValue, SemiSplaying>::NULL_PTR;
+
+protected:
+
+    size_t getCountOfCorrectNode(node_ptr x) const {
+        if (x == NULL_PTR) {
+            return 0U;
+        }
+
+        size_t count = 0;
+
+        count += getCountOfCorrectNode(this->getLeftSon(x));
+        count += getCountOfCorrectNode(this->getRightSon(x));
+
+        if (!this->isFictitious(x)) {
+            ++count;
+        }
+
+        return count;
+    }
+
+    bool isSearchTree(node_ptr x, node_ptr prev_x) const {
+        if (this->isFictitious(x)) {
+            return true;
+        }
+        if (x != this->root && this->getParent(x) != prev_x) {
+            return false;
+        }
+        if (!this->isFictitious(this->getLeftSon(x))) {
+            if (this->getKey(x) <= this->getKey(this->getLeftSon(x))) {
+                return false;
+            }
+            if (!isSearchTree(this->getLeftSon(x), x)) {
+                return false;
+            }
+        }
+        if (!this->isFictitious(this->getRightSon(x))) {
+            if (this->getKey(x) >= this->getKey(this->getRightSon(x))) {
+                return false;
+            }
+            if (!isSearchTree(this->getRightSon(x), x)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+
+    bool isTreeCorrect() {
+        bool is_correct_root = (this->getParent(this->root) == NULL_PTR);
+        bool is_search_tree = isSearchTree(this->root, this->root);
+        bool is_correct_size = (this->size() == getCountOfCorrectNode(this->root));
+
+        return is_correct_root && is_search_tree && is_correct_size;
+    }
+};
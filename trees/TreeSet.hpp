@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include "AVLTree.hpp"
+#include "RedBlackTree.hpp"
+
+// Value type of the set trees; being empty, it is not stored in the nodes.
+struct NoValue {};
+
+// Ordered set on top of a tree with an empty value type. The balancing code is the tree's own;
+// iterators yield the keys only.
+template <typename TKey, typename TTree>
+class TreeSet {
+protected:
+
+    using TreeIterator = decltype(std::declval<TTree&>().begin());
+
+public:
+
+    class Iterator {
+    protected:
+
+        TreeIterator it;
+
+        explicit Iterator(TreeIterator it) :
+            it(it)
+        {}
+
+    public:
+
+        const TKey& operator*() const {
+            return (*it).first;
+        }
+
+        const TKey* operator->() const {
+            return &it->first;
+        }
+
+        Iterator& operator++() {
+            ++it;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return it == other.it;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return it != other.it;
+        }
+
+        friend class TreeSet;
+    };
+
+protected:
+
+    TTree tree;
+
+public:
+
+    Iterator begin() const {
+        return Iterator(tree.begin());
+    }
+
+    Iterator end() const {
+        return Iterator(tree.end());
+    }
+
+    Iterator lowerBound(const TKey& key) {
+        return Iterator(tree.lowerBound(key));
+    }
+
+    Iterator upperBound(const TKey& key) {
+        return Iterator(tree.upperBound(key));
+    }
+
+    Iterator insert(const TKey& key) {
+        return Iterator(tree.insert(key, NoValue()));
+    }
+
+    Iterator erase(const TKey& key) {
+        return Iterator(tree.erase(key));
+    }
+
+    Iterator erase(Iterator it) {
+        return Iterator(tree.erase(it.it));
+    }
+
+    Iterator find(const TKey& key) const {
+        return Iterator(tree.find(key));
+    }
+
+    bool isExist(const TKey& key) const {
+        return tree.isExist(key);
+    }
+
+    size_t size() const {
+        return tree.size();
+    }
+
+    bool empty() const {
+        return tree.empty();
+    }
+
+    void clear() {
+        tree.clear();
+    }
+};
+
+template <typename TKey, template <typename...> class TContainer = std::vector>
+using AVLSet = TreeSet<TKey, AVLTree<TKey, NoValue, TContainer>>;
+
+template <typename TKey, template <typename...> class TContainer = std::vector>
+using RedBlackSet = TreeSet<TKey, RedBlackTree<TKey, NoValue, TContainer>>;